@@ -3,3 +3,85 @@
 
 #include "AbilitySystem/Abilitys/ZBGameplayAbility.h"
 
+#include "AbilitySystem/ZBAbilitySystemComponent.h"
+#include "AbilitySystem/ZBStateTagIndex.h"
+#include "HAL/IConsoleManager.h"
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<bool> CVarZBValidateTagMasks(
+	TEXT("zb.Ability.ValidateTagMasks"),
+	false,
+	TEXT("为 true 时，掩码快速路径的结果与引擎通用的标签需求检查逐次比对"),
+	ECVF_Cheat);
+#endif
+
+bool UZBGameplayAbility::DoesAbilitySatisfyTagRequirements(const UAbilitySystemComponent& AbilitySystemComponent, const FGameplayTagContainer* SourceTags, const FGameplayTagContainer* TargetTags, FGameplayTagContainer* OptionalRelevantTags) const
+{
+	const UZBAbilitySystemComponent* ZBASC = Cast<UZBAbilitySystemComponent>(&AbilitySystemComponent);
+	const FZBTagRequirementMasks& Masks = GetTagRequirementMasks();
+	if (!ZBASC || !Masks.bUseMasks)
+	{
+		return Super::DoesAbilitySatisfyTagRequirements(AbilitySystemComponent, SourceTags, TargetTags, OptionalRelevantTags);
+	}
+
+	const uint64 OwnedMask = ZBASC->GetStateTagMask();
+	const bool bSatisfied = (OwnedMask & Masks.Blocked) == 0
+		&& (OwnedMask & Masks.Required) == Masks.Required
+		&& !AbilitySystemComponent.AreAbilityTagsBlocked(GetAssetTags());
+
+#if !UE_BUILD_SHIPPING
+	if (CVarZBValidateTagMasks.GetValueOnGameThread())
+	{
+		const bool bGenericSatisfied = Super::DoesAbilitySatisfyTagRequirements(AbilitySystemComponent, SourceTags, TargetTags, nullptr);
+		ensureMsgf(bGenericSatisfied == bSatisfied, TEXT("%s 的标签需求掩码结果 (%d) 与通用检查 (%d) 不一致"), *GetName(), bSatisfied, bGenericSatisfied);
+	}
+#endif
+
+	// 失败时调用方可能要失败原因（用于提示 / 调试），交给通用路径填充
+	if (!bSatisfied && OptionalRelevantTags)
+	{
+		return Super::DoesAbilitySatisfyTagRequirements(AbilitySystemComponent, SourceTags, TargetTags, OptionalRelevantTags);
+	}
+	return bSatisfied;
+}
+
+void UZBGameplayAbility::PreActivate(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, FOnGameplayAbilityEnded::FDelegate* OnGameplayAbilityEndedDelegate, const FGameplayEventData* TriggerEventData)
+{
+	const int16 PredictionKey = ActivationInfo.GetActivationPredictionKey().Current;
+	if (PredictionKey != 0)
+	{
+		RandomActivationId = static_cast<uint16>(PredictionKey);
+	}
+	else
+	{
+		UZBAbilitySystemComponent* ZBASC = ActorInfo ? Cast<UZBAbilitySystemComponent>(ActorInfo->AbilitySystemComponent.Get()) : nullptr;
+		RandomActivationId = 0x80000000u | (ZBASC ? ZBASC->AllocateActivationSerial() : 0);
+	}
+
+	Super::PreActivate(Handle, ActorInfo, ActivationInfo, OnGameplayAbilityEndedDelegate, TriggerEventData);
+}
+
+const UZBGameplayAbility::FZBTagRequirementMasks& UZBGameplayAbility::GetTagRequirementMasks() const
+{
+	// 实例统一取类默认对象上的编译结果
+	const UZBGameplayAbility* Source = HasAnyFlags(RF_ClassDefaultObject)
+		? this
+		: GetClass()->GetDefaultObject<UZBGameplayAbility>();
+
+	if (!Source->TagRequirementMasks.bCompiled)
+	{
+		Source->CompileTagRequirementMasks();
+	}
+	return Source->TagRequirementMasks;
+}
+
+void UZBGameplayAbility::CompileTagRequirementMasks() const
+{
+	const FZBStateTagIndex& StateTagIndex = FZBStateTagIndex::Get();
+
+	TagRequirementMasks.bUseMasks = SourceRequiredTags.IsEmpty() && SourceBlockedTags.IsEmpty()
+		&& TargetRequiredTags.IsEmpty() && TargetBlockedTags.IsEmpty()
+		&& StateTagIndex.CompileMask(ActivationRequiredTags, TagRequirementMasks.Required)
+		&& StateTagIndex.CompileMask(ActivationBlockedTags, TagRequirementMasks.Blocked);
+	TagRequirementMasks.bCompiled = true;
+}
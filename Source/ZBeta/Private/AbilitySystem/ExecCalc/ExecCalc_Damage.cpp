@@ -0,0 +1,163 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilitySystem/ExecCalc/ExecCalc_Damage.h"
+
+#include "AbilitySystem/ZBAbilityTypes.h"
+#include "AbilitySystem/ZBAttributeSet.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "AbilitySystem/ZBRandom.h"
+#include "AbilitySystemComponent.h"
+#include "Combat/ZBDotSubsystem.h"
+#include "Engine/World.h"
+#include "ZBetaStats.h"
+
+namespace
+{
+	// 捕获定义只建一次
+	struct FZBDamageStatics
+	{
+		// 目标
+		DECLARE_ATTRIBUTE_CAPTUREDEF(PhysicalResistance);
+		DECLARE_ATTRIBUTE_CAPTUREDEF(MagicResistance);
+
+		// 源
+		DECLARE_ATTRIBUTE_CAPTUREDEF(CriticalChance);
+		DECLARE_ATTRIBUTE_CAPTUREDEF(CriticalDamage);
+		DECLARE_ATTRIBUTE_CAPTUREDEF(HealthSteal);
+		DECLARE_ATTRIBUTE_CAPTUREDEF(ManaSteal);
+		DECLARE_ATTRIBUTE_CAPTUREDEF(StaminaSteal);
+
+		FZBDamageStatics()
+		{
+			DEFINE_ATTRIBUTE_CAPTUREDEF(UZBAttributeSet, PhysicalResistance, Target, false);
+			DEFINE_ATTRIBUTE_CAPTUREDEF(UZBAttributeSet, MagicResistance, Target, false);
+
+			DEFINE_ATTRIBUTE_CAPTUREDEF(UZBAttributeSet, CriticalChance, Source, false);
+			DEFINE_ATTRIBUTE_CAPTUREDEF(UZBAttributeSet, CriticalDamage, Source, false);
+			DEFINE_ATTRIBUTE_CAPTUREDEF(UZBAttributeSet, HealthSteal, Source, false);
+			DEFINE_ATTRIBUTE_CAPTUREDEF(UZBAttributeSet, ManaSteal, Source, false);
+			DEFINE_ATTRIBUTE_CAPTUREDEF(UZBAttributeSet, StaminaSteal, Source, false);
+		}
+	};
+
+	const FZBDamageStatics& DamageStatics()
+	{
+		static const FZBDamageStatics Statics;
+		return Statics;
+	}
+}
+
+UExecCalc_Damage::UExecCalc_Damage()
+{
+	const FZBDamageStatics& Statics = DamageStatics();
+	RelevantAttributesToCapture.Add(Statics.PhysicalResistanceDef);
+	RelevantAttributesToCapture.Add(Statics.MagicResistanceDef);
+	RelevantAttributesToCapture.Add(Statics.CriticalChanceDef);
+	RelevantAttributesToCapture.Add(Statics.CriticalDamageDef);
+	RelevantAttributesToCapture.Add(Statics.HealthStealDef);
+	RelevantAttributesToCapture.Add(Statics.ManaStealDef);
+	RelevantAttributesToCapture.Add(Statics.StaminaStealDef);
+}
+
+/**
+ * @brief 一次遍历完成整条伤害结算
+ *
+ * 详细流程：
+ *   1. 每个捕获属性只求值一次（带上源 / 目标的聚合标签，条件修饰符照常生效）；
+ *   2. 遍历四种伤害类型，读取 SetByCaller 原始值，按对应抗性减免后累加；
+ *   3. 掷暴击并放大总伤害（FZBRandom，同一命中在各端结果一致）；
+ *   4. 读取削韧值，按吸取率算出返还，写入 EffectContext；
+ *   5. GE 带 Debuff.Data.Duration 时按 Effect.Data.Chance（百分比，未设置视为必定触发）交给 UZBDotSubsystem
+ *      （之后的跳伤由它直接写入 IncomingDamage，不再经过本计算的抗性与暴击）；
+ *   6. 总伤害输出到 IncomingDamage（Additive），由目标 AttributeSet 扣血。
+ *
+ * 注意事项：
+ *   - 没有任何伤害与削韧时不输出，避免空结算触发 PostGameplayEffectExecute；
+ *   - EffectContext 不是 FZBGameplayEffectContext 时（全局类未配置）只输出伤害。
+ */
+void UExecCalc_Damage::Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const
+{
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_DamageExecution);
+
+	const FZBDamageStatics& Statics = DamageStatics();
+	const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+	const FGameplayEffectSpec& Spec = ExecutionParams.GetOwningSpec();
+
+	FAggregatorEvaluateParameters EvaluationParameters;
+	EvaluationParameters.SourceTags = Spec.CapturedSourceTags.GetAggregatedTags();
+	EvaluationParameters.TargetTags = Spec.CapturedTargetTags.GetAggregatedTags();
+
+	auto Capture = [&](const FGameplayEffectAttributeCaptureDefinition& Definition)
+	{
+		float Magnitude = 0.f;
+		ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(Definition, EvaluationParameters, Magnitude);
+		return Magnitude;
+	};
+
+	const float PhysicalResistance = FMath::Max(Capture(Statics.PhysicalResistanceDef), 0.f);
+	const float MagicResistance = FMath::Max(Capture(Statics.MagicResistanceDef), 0.f);
+	const float CriticalChance = Capture(Statics.CriticalChanceDef);
+	const float CriticalDamage = Capture(Statics.CriticalDamageDef);
+	const float HealthSteal = Capture(Statics.HealthStealDef);
+	const float ManaSteal = Capture(Statics.ManaStealDef);
+	const float StaminaSteal = Capture(Statics.StaminaStealDef);
+
+	// 1. 分类型减免
+	const TPair<FGameplayTag, float> DamageTypes[] = {
+		{ Tags.Damage_Type_Physical, PhysicalResistance },
+		{ Tags.Damage_Type_Magical, MagicResistance },
+		{ Tags.Damage_Type_Fire, MagicResistance },
+		{ Tags.Damage_Type_Ice, MagicResistance },
+	};
+
+	float Damage = 0.f;
+	for (const TPair<FGameplayTag, float>& DamageType : DamageTypes)
+	{
+		const float RawDamage = Spec.GetSetByCallerMagnitude(DamageType.Key, false, 0.f);
+		if (RawDamage > 0.f)
+		{
+			Damage += RawDamage * ResistanceConstant / (ResistanceConstant + DamageType.Value);
+		}
+	}
+
+	// 2. 暴击：随机数由（对局种子，攻击者，激活，命中）决定
+	UAbilitySystemComponent* TargetASC = ExecutionParams.GetTargetAbilitySystemComponent();
+	const FZBRandomStreamKey RandomKey = FZBRandom::MakeEffectKey(Spec, TargetASC);
+	const bool bCriticalHit = Damage > 0.f && FZBRandom::RollPercent(RandomKey, EZBRandomChannel::CriticalHit, CriticalChance);
+	if (bCriticalHit)
+	{
+		Damage *= 1.f + FMath::Max(CriticalDamage, 0.f) / 100.f;
+	}
+
+	const float ToughnessDamage = FMath::Max(Spec.GetSetByCallerMagnitude(Tags.Damage_Toughness, false, 0.f), 0.f);
+
+	// 3. DOT：只登记到调度系统，不再施加周期 GE（纯 DOT 的 GE 没有直接伤害，也要登记）
+	if (Spec.GetSetByCallerMagnitude(Tags.Debuff_Data_Duration, false, 0.f) > 0.f
+		&& FZBRandom::RollPercent(RandomKey, EZBRandomChannel::StatusProc, Spec.GetSetByCallerMagnitude(Tags.Effect_Data_Chance, false, 100.f)))
+	{
+		const UWorld* World = TargetASC ? TargetASC->GetWorld() : nullptr;
+		if (UZBDotSubsystem* DotSubsystem = World ? World->GetSubsystem<UZBDotSubsystem>() : nullptr)
+		{
+			DotSubsystem->ApplyDotFromSpec(Spec, TargetASC);
+		}
+	}
+
+	if (Damage <= 0.f && ToughnessDamage <= 0.f)
+	{
+		return;
+	}
+
+	// 4. 削韧与吸取返还交给目标 AttributeSet 落地
+	FGameplayEffectContextHandle ContextHandle = Spec.GetContext();
+	if (FZBGameplayEffectContext* Context = FZBGameplayEffectContext::Get(ContextHandle))
+	{
+		Context->bCriticalHit = bCriticalHit;
+		Context->ToughnessDamage = ToughnessDamage;
+		Context->HealthReturn = Damage * FMath::Max(HealthSteal, 0.f) / 100.f;
+		Context->ManaReturn = Damage * FMath::Max(ManaSteal, 0.f) / 100.f;
+		Context->StaminaReturn = Damage * FMath::Max(StaminaSteal, 0.f) / 100.f;
+	}
+
+	OutExecutionOutput.AddOutputModifier(FGameplayModifierEvaluatedData(UZBAttributeSet::GetIncomingDamageAttribute(), EGameplayModOp::Additive, Damage));
+}
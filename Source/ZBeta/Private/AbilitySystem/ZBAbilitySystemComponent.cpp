@@ -2,9 +2,19 @@
 
 
 #include "AbilitySystem/ZBAbilitySystemComponent.h"
+#include "ZBetaStats.h"
 #include "AbilitySystem/ZBAbilitySystemLibrary.h"
 #include "AbilitySystem/ZBGameplayTags.h"
 #include "AbilitySystem/Abilitys/ZBGameplayAbility.h"
+#include "AbilitySystem/ZBStateTagIndex.h"
+#include "Net/UnrealNetwork.h"
+
+
+UZBAbilitySystemComponent::UZBAbilitySystemComponent()
+{
+	// 计数容器对显式标签和它的每一级父标签都会广播，覆盖 GE 授予、Loose Tag 和最小复制（SetTagMapCount）所有路径
+	RegisterGenericGameplayTagEvent().AddUObject(this, &UZBAbilitySystemComponent::OnAnyTagCountChanged);
+}
 
 
 /**
@@ -17,6 +27,7 @@
  */
 void UZBAbilitySystemComponent::AbilityInputForTagPressed(const FGameplayTag& InputTag)
 {
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_AbilityInputPressed);
 	// 检查 InputTag 是否有效，无效则直接返回
 	if (!InputTag.IsValid())return;
 	// 锁定能力列表，防止遍历时被修改（多线程安全）
@@ -48,6 +59,7 @@ void UZBAbilitySystemComponent::AbilityInputForTagPressed(const FGameplayTag& In
 
 void UZBAbilitySystemComponent::AbilityInputForTagHeld(const FGameplayTag& InputTag)
 {
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_AbilityInputHeld);
 	// 检查 InputTag 是否有效，无效则直接返回
 	if (!InputTag.IsValid())return;
 	// 锁定能力列表，防止遍历时被修改（多线程安全）
@@ -75,6 +87,7 @@ void UZBAbilitySystemComponent::AbilityInputForTagHeld(const FGameplayTag& Input
 
 void UZBAbilitySystemComponent::AbilityInputForTagReleased(const FGameplayTag& InputTag)
 {
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_AbilityInputReleased);
 	// 检查 InputTag 是否有效，无效则直接返回
 	if (!InputTag.IsValid())return;
 	// 锁定能力列表，防止遍历时被修改（多线程安全）
@@ -119,3 +132,50 @@ void UZBAbilitySystemComponent::AddCharacterAbilities(const TArray<TSubclassOf<U
 void UZBAbilitySystemComponent::AddCharacterPassiveAbilities(const TArray<TSubclassOf<UGameplayAbility>>& StartUpPassiveAbilities)
 {
 }
+
+FActiveGameplayEffectHandle UZBAbilitySystemComponent::ApplyGameplayEffectSpecToSelf(const FGameplayEffectSpec& GameplayEffect, FPredictionKey PredictionKey)
+{
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_ApplyEffectSpecToSelf);
+	INC_DWORD_STAT(STAT_ZBeta_EffectApplications);
+	return Super::ApplyGameplayEffectSpecToSelf(GameplayEffect, PredictionKey);
+}
+
+void UZBAbilitySystemComponent::NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability)
+{
+	INC_DWORD_STAT(STAT_ZBeta_AbilityActivations);
+	Super::NotifyAbilityActivated(Handle, Ability);
+}
+
+void UZBAbilitySystemComponent::OnTagUpdated(const FGameplayTag& Tag, bool TagExists)
+{
+	if (TagExists)
+	{
+		INC_DWORD_STAT(STAT_ZBeta_TagAdds);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_ZBeta_TagRemoves);
+	}
+	Super::OnTagUpdated(Tag, TagExists);
+}
+
+void UZBAbilitySystemComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// 基类按复制模式决定是否发送标签计数表，这里只在关闭时再压一层
+	if (!bReplicateTagMap)
+	{
+		DOREPLIFETIME_ACTIVE_OVERRIDE_PRIVATE_PROPERTY(UAbilitySystemComponent, MinimalReplicationTags, false);
+		DOREPLIFETIME_ACTIVE_OVERRIDE_PRIVATE_PROPERTY(UAbilitySystemComponent, ReplicatedLooseTags, false);
+	}
+}
+
+void UZBAbilitySystemComponent::OnAnyTagCountChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	const int32 Index = FZBStateTagIndex::Get().IndexOf(Tag);
+	if (Index == INDEX_NONE) return;
+
+	const uint64 Bit = uint64(1) << Index;
+	StateTagMask = NewCount > 0 ? (StateTagMask | Bit) : (StateTagMask & ~Bit);
+}
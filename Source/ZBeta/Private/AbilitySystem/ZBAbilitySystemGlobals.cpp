@@ -0,0 +1,11 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilitySystem/ZBAbilitySystemGlobals.h"
+
+#include "AbilitySystem/ZBAbilityTypes.h"
+
+FGameplayEffectContext* UZBAbilitySystemGlobals::AllocGameplayEffectContext() const
+{
+	return new FZBGameplayEffectContext();
+}
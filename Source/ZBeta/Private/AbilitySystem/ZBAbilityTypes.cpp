@@ -0,0 +1,45 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilitySystem/ZBAbilityTypes.h"
+
+FZBGameplayEffectContext* FZBGameplayEffectContext::Get(FGameplayEffectContextHandle& Handle)
+{
+	return const_cast<FZBGameplayEffectContext*>(Get(static_cast<const FGameplayEffectContextHandle&>(Handle)));
+}
+
+const FZBGameplayEffectContext* FZBGameplayEffectContext::Get(const FGameplayEffectContextHandle& Handle)
+{
+	const FGameplayEffectContext* Context = Handle.Get();
+	if (Context && Context->GetScriptStruct()->IsChildOf(StaticStruct()))
+	{
+		return static_cast<const FZBGameplayEffectContext*>(Context);
+	}
+	return nullptr;
+}
+
+FZBGameplayEffectContext* FZBGameplayEffectContext::Duplicate() const
+{
+	FZBGameplayEffectContext* NewContext = new FZBGameplayEffectContext();
+	*NewContext = *this;
+	if (GetHitResult())
+	{
+		// 命中结果要深拷贝
+		NewContext->AddHitResult(*GetHitResult(), true);
+	}
+	return NewContext;
+}
+
+bool FZBGameplayEffectContext::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	if (!Super::NetSerialize(Ar, Map, bOutSuccess))
+	{
+		return false;
+	}
+
+	uint8 Flags = bCriticalHit ? 1 : 0;
+	Ar.SerializeBits(&Flags, 1);
+	bCriticalHit = (Flags & 1) != 0;
+
+	return bOutSuccess;
+}
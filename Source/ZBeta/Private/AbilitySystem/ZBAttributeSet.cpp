@@ -2,7 +2,12 @@
 
 
 #include "AbilitySystem/ZBAttributeSet.h"
+#include "AbilitySystem/ZBAbilityTypes.h"
+#include "Combat/ZBCombatResolutionSubsystem.h"
+#include "Combat/ZBPoiseSubsystem.h"
+#include "GameplayEffectExtension.h"
 #include "Net/UnrealNetwork.h"
+#include "ZBetaStats.h"
 
 UZBAttributeSet::UZBAttributeSet()
 {
@@ -63,6 +68,87 @@ void UZBAttributeSet::PreAttributeChange(const FGameplayAttribute& Attribute, fl
 void UZBAttributeSet::PostGameplayEffectExecute(const struct FGameplayEffectModCallbackData& Data)
 {
     Super::PostGameplayEffectExecute(Data);
+
+    const FGameplayAttribute& Attribute = Data.EvaluatedData.Attribute;
+    if (Attribute == GetIncomingDamageAttribute())
+    {
+        HandleIncomingDamage(Data);
+    }
+    else if (Attribute == GetHealthAttribute())
+    {
+        SetHealth(FMath::Clamp(GetHealth(), 0.f, GetMaxHealth()));
+    }
+    else if (Attribute == GetManaAttribute())
+    {
+        SetMana(FMath::Clamp(GetMana(), 0.f, GetMaxMana()));
+    }
+    else if (Attribute == GetStaminaAttribute())
+    {
+        SetStamina(FMath::Clamp(GetStamina(), 0.f, GetMaxStamina()));
+    }
+    else if (Attribute == GetToughnessAttribute())
+    {
+        SetToughness(FMath::Clamp(GetToughness(), 0.f, GetMaxToughness()));
+    }
+}
+
+/**
+ * @brief 落地一次伤害结算（UExecCalc_Damage 的输出）
+ *
+ * 详细流程：
+ *   1. 取出并清零 IncomingDamage，扣除生命；
+ *   2. 从 FZBGameplayEffectContext 读取削韧值，交给 UZBPoiseSubsystem（破韧、受击反应、回韧）；
+ *   3. 吸取返还交给 UZBCombatResolutionSubsystem 按攻击者累加，帧末一次施加
+ *      （攻击者自己的 PostGameplayEffectExecute 负责钳制上限）。
+ */
+void UZBAttributeSet::HandleIncomingDamage(const FGameplayEffectModCallbackData& Data)
+{
+    const float Damage = GetIncomingDamage();
+    SetIncomingDamage(0.f);
+
+    if (Damage > 0.f)
+    {
+        SetHealth(FMath::Clamp(GetHealth() - Damage, 0.f, GetMaxHealth()));
+    }
+
+    const FGameplayEffectContextHandle ContextHandle = Data.EffectSpec.GetContext();
+    const FZBGameplayEffectContext* Context = FZBGameplayEffectContext::Get(ContextHandle);
+    if (!Context) return;
+
+    if (Context->ToughnessDamage > 0.f)
+    {
+        if (UZBPoiseSubsystem* Poise = UWorld::GetSubsystem<UZBPoiseSubsystem>(GetWorld()))
+        {
+            Poise->ApplyToughnessDamage(Data.Target, Context->ToughnessDamage, ContextHandle.GetEffectCauser());
+        }
+        else
+        {
+            SetToughness(FMath::Clamp(GetToughness() - Context->ToughnessDamage, 0.f, GetMaxToughness()));
+        }
+    }
+
+    UAbilitySystemComponent* SourceASC = ContextHandle.GetOriginalInstigatorAbilitySystemComponent();
+    if (!SourceASC || SourceASC == &Data.Target) return;
+
+    if (UZBCombatResolutionSubsystem* Resolution = UWorld::GetSubsystem<UZBCombatResolutionSubsystem>(GetWorld()))
+    {
+        Resolution->QueueReturns(SourceASC, Context->HealthReturn, Context->ManaReturn, Context->StaminaReturn);
+        return;
+    }
+
+    // 没有结算队列（非游戏世界）时逐项直接施加
+    const TPair<FGameplayAttribute, float> Returns[] = {
+        { GetHealthAttribute(), Context->HealthReturn },
+        { GetManaAttribute(), Context->ManaReturn },
+        { GetStaminaAttribute(), Context->StaminaReturn },
+    };
+    for (const TPair<FGameplayAttribute, float>& Return : Returns)
+    {
+        if (Return.Value > 0.f)
+        {
+            SourceASC->ApplyModToAttribute(Return.Key, EGameplayModOp::Additive, Return.Value);
+        }
+    }
 }
 
 void UZBAttributeSet::PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue)
@@ -73,144 +159,144 @@ void UZBAttributeSet::PostAttributeChange(const FGameplayAttribute& Attribute, f
 
 // ========================================================================================
 // 网络回调实现 (Replication Notifies)
-// 宏 GAMEPLAYATTRIBUTE_REPNOTIFY 负责处理预测回滚和旧值比对
+// 宏 GAMEPLAYATTRIBUTE_REPNOTIFY 负责处理预测回滚和旧值比对（经 ZB_ATTRIBUTE_REPNOTIFY 包一层统计）
 // ========================================================================================
 
 // --- 主要属性 ---
 void UZBAttributeSet::OnRep_Health(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, Health, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, Health, OldValue);
 }
 
 void UZBAttributeSet::OnRep_Mana(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, Mana, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, Mana, OldValue);
 }
 
 void UZBAttributeSet::OnRep_Stamina(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, Stamina, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, Stamina, OldValue);
 }
 
 void UZBAttributeSet::OnRep_Strength(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, Strength, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, Strength, OldValue);
 }
 
 void UZBAttributeSet::OnRep_Intelligence(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, Intelligence, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, Intelligence, OldValue);
 }
 
 void UZBAttributeSet::OnRep_Dexterity(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, Dexterity, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, Dexterity, OldValue);
 }
 
 // --- 属性上限 ---
 void UZBAttributeSet::OnRep_MaxHealth(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, MaxHealth, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, MaxHealth, OldValue);
 }
 
 void UZBAttributeSet::OnRep_MaxMana(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, MaxMana, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, MaxMana, OldValue);
 }
 
 void UZBAttributeSet::OnRep_MaxStamina(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, MaxStamina, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, MaxStamina, OldValue);
 }
 
 // --- 抗性 ---
 void UZBAttributeSet::OnRep_Toughness(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, Toughness, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, Toughness, OldValue);
 }
 
 void UZBAttributeSet::OnRep_MaxToughness(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, MaxToughness, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, MaxToughness, OldValue);
 }
 
 void UZBAttributeSet::OnRep_PhysicalResistance(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, PhysicalResistance, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, PhysicalResistance, OldValue);
 }
 
 void UZBAttributeSet::OnRep_MagicResistance(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, MagicResistance, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, MagicResistance, OldValue);
 }
 
 // --- 回复 ---
 void UZBAttributeSet::OnRep_HealthRegenRate(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, HealthRegenRate, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, HealthRegenRate, OldValue);
 }
 
 void UZBAttributeSet::OnRep_ManaRegenRate(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, ManaRegenRate, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, ManaRegenRate, OldValue);
 }
 
 void UZBAttributeSet::OnRep_StaminaRegenRate(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, StaminaRegenRate, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, StaminaRegenRate, OldValue);
 }
 
 void UZBAttributeSet::OnRep_ToughnessRegenRate(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, ToughnessRegenRate, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, ToughnessRegenRate, OldValue);
 }
 
 // --- 消耗 ---
 void UZBAttributeSet::OnRep_DodgeStaminaCostMultiplier(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, DodgeStaminaCostMultiplier, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, DodgeStaminaCostMultiplier, OldValue);
 }
 
 void UZBAttributeSet::OnRep_SprintStaminaCostMultiplier(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, SprintStaminaCostMultiplier, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, SprintStaminaCostMultiplier, OldValue);
 }
 
 // --- 吸取 ---
 void UZBAttributeSet::OnRep_HealthSteal(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, HealthSteal, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, HealthSteal, OldValue);
 }
 
 void UZBAttributeSet::OnRep_ManaSteal(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, ManaSteal, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, ManaSteal, OldValue);
 }
 
 void UZBAttributeSet::OnRep_StaminaSteal(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, StaminaSteal, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, StaminaSteal, OldValue);
 }
 
 // --- 状态 ---
 
 void UZBAttributeSet::OnRep_CriticalChance(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, CriticalChance, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, CriticalChance, OldValue);
 }
 
 void UZBAttributeSet::OnRep_CriticalDamage(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, CriticalDamage, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, CriticalDamage, OldValue);
 }
 
 void UZBAttributeSet::OnRep_MoveSpeed(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, MoveSpeed, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, MoveSpeed, OldValue);
 }
 
 void UZBAttributeSet::OnRep_MaxEquipmentLoad(const FGameplayAttributeData& OldValue)
 {
-    GAMEPLAYATTRIBUTE_REPNOTIFY(UZBAttributeSet, MaxEquipmentLoad, OldValue);
+    ZB_ATTRIBUTE_REPNOTIFY(UZBAttributeSet, MaxEquipmentLoad, OldValue);
 }
 
@@ -2,6 +2,8 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include "AbilitySystem/ZBGameplayTags.h"
 #include "GameplayTagsManager.h"
+#include "ZBetaLog.h"
+#include "ZBetaStats.h"
 
 
 // ==================== 单例定义 ====================
@@ -14,12 +16,14 @@
  *   并在程序结束时自动析构。
  */
 FZBGameplayTags FZBGameplayTags::GameplayTags;
+int32 FZBGameplayTags::NumNativeTags = 0;
 
 
 // ==================== 初始化方法实现 ====================
 
 void FZBGameplayTags::InitializeNativeTags()
 {
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_InitializeNativeTags);
 	// 🔧 修改 - 通过静态成员 GameplayTags 访问所有非静态成员变量
 	// 这是访问单例实例的正确方式
 	FZBGameplayTags& Tags = GameplayTags;
@@ -491,6 +495,13 @@ void FZBGameplayTags::InitializeNativeTags()
 		TEXT("冰冻伤害 - 触发冻结减速效果，减速 50%，持续 3 秒")
 	);
 
+	// 🔧 削韧
+	Tags.AddTag(
+		Tags.Damage_Toughness,
+		FName(TEXT("Damage.Toughness")),
+		TEXT("削韧值 - SetByCaller 键，不受抗性减免")
+	);
+
 	// ===== 受击反应 Tags 初始化 =====
 	
 	// 🔧 受击强度等级
@@ -649,12 +660,12 @@ void FZBGameplayTags::InitializeNativeTags()
 		TEXT("法杖 - 魔法类武器，不进行物理近战攻击，触发法术技能")
 	);
 
-	// 📝 初始化完成日志
+	// 📝 初始化完成日志（只打一条汇总，逐个 Tag 的日志在 VeryVerbose 下才有）
 	UE_LOG(
-		LogTemp, 
-		Warning, 
+		LogZBetaAsset, 
+		Log, 
 		TEXT("✓ GameplayTags 初始化完成 - 已注册 %d 个标签，所有 Tag 已准备就绪！"),
-		105  // 🔧 修改 - 根据实际 Tag 总数更新此数字（目前统计为 105 个）
+		NumNativeTags
 	);
 }
 
@@ -692,10 +703,10 @@ void FZBGameplayTags::AddTag(
 	// 📝 调试日志：输出每个 Tag 的注册情况
 	if (OutTag.IsValid())
 	{
-
+		++NumNativeTags;
 		UE_LOG(
-			LogTemp,
-			Verbose,
+			LogZBetaAsset,
+			VeryVerbose,
 			TEXT("✓ GameplayTag 注册成功：%s - %s"),
 			*TagName.ToString(),
 			*TagComment
@@ -705,7 +716,7 @@ void FZBGameplayTags::AddTag(
 	{
 
 		UE_LOG(
-			LogTemp,
+			LogZBetaAsset,
 			Warning,
 			TEXT("✗ GameplayTag 注册失败或无效：%s - %s，请检查 Tag 命名是否规范"),
 			*TagName.ToString(),
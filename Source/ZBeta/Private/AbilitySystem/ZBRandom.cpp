@@ -0,0 +1,92 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilitySystem/ZBRandom.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/Abilitys/ZBGameplayAbility.h"
+#include "AbilitySystem/ZBAbilityTypes.h"
+#include "Engine/World.h"
+#include "Game/ZBGameState.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "GameplayEffect.h"
+
+namespace
+{
+	// SplitMix64 的混合函数：输入相差 1 位，输出约一半位翻转
+	uint64 Mix64(uint64 Value)
+	{
+		Value += 0x9E3779B97F4A7C15ull;
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+}
+
+uint32 FZBRandom::GetUInt32(const FZBRandomStreamKey& Key, EZBRandomChannel Channel, uint32 Counter)
+{
+	uint64 Hash = Mix64(Key.MatchSeed);
+	Hash = Mix64(Hash ^ (uint64(Key.AttackerId) << 32 | Key.ActivationId));
+	Hash = Mix64(Hash ^ (uint64(Key.HitIndex) << 32 | uint64(static_cast<uint8>(Channel)) << 24 | (Counter & 0xFFFFFF)));
+	return static_cast<uint32>(Hash >> 32);
+}
+
+float FZBRandom::GetFraction(const FZBRandomStreamKey& Key, EZBRandomChannel Channel, uint32 Counter)
+{
+	return static_cast<float>(GetUInt32(Key, Channel, Counter) >> 8) * (1.f / 16777216.f);
+}
+
+bool FZBRandom::RollPercent(const FZBRandomStreamKey& Key, EZBRandomChannel Channel, float ChancePercent)
+{
+	if (ChancePercent <= 0.f) return false;
+	if (ChancePercent >= 100.f) return true;
+	return GetFraction(Key, Channel) * 100.f < ChancePercent;
+}
+
+FZBRandomStreamKey FZBRandom::MakeEffectKey(const FGameplayEffectSpec& Spec, const UAbilitySystemComponent* Target)
+{
+	const FGameplayEffectContextHandle& Context = Spec.GetContext();
+
+	FZBRandomStreamKey Key;
+	Key.MatchSeed = GetMatchSeed(Context.GetOriginalInstigatorAbilitySystemComponent());
+	Key.AttackerId = GetStableActorId(Context.GetOriginalInstigator());
+
+	if (const UZBGameplayAbility* Ability = Cast<UZBGameplayAbility>(Context.GetAbilityInstance_NotReplicated()))
+	{
+		Key.ActivationId = Ability->GetRandomActivationId();
+	}
+
+	const FZBGameplayEffectContext* ZBContext = FZBGameplayEffectContext::Get(Context);
+	const uint32 ContextHitIndex = ZBContext ? ZBContext->HitIndex : 0;
+	const AActor* TargetActor = Target ? Target->GetAvatarActor_Direct() : nullptr;
+	Key.HitIndex = HashCombineFast(ContextHitIndex, GetStableActorId(TargetActor));
+	return Key;
+}
+
+uint32 FZBRandom::GetStableActorId(const AActor* Actor)
+{
+	if (!Actor) return 0;
+
+	// 玩家：PlayerId 由服务器分配并复制，两端一致
+	const APlayerState* PlayerState = Cast<APlayerState>(Actor);
+	if (!PlayerState)
+	{
+		const APawn* Pawn = Cast<APawn>(Actor);
+		PlayerState = Pawn ? Pawn->GetPlayerState() : nullptr;
+	}
+	if (PlayerState)
+	{
+		return 0x80000000u | static_cast<uint32>(PlayerState->GetPlayerId());
+	}
+
+	// 关卡中放置的 Actor 两端同名；不能用 FName 的哈希（取决于名字表顺序）
+	return FCrc::StrCrc32(*Actor->GetName()) & 0x7FFFFFFFu;
+}
+
+uint32 FZBRandom::GetMatchSeed(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const AZBGameState* GameState = World ? World->GetGameState<AZBGameState>() : nullptr;
+	return GameState ? GameState->GetMatchSeed() : 0;
+}
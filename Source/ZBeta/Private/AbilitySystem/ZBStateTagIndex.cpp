@@ -0,0 +1,63 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilitySystem/ZBStateTagIndex.h"
+
+#include "GameplayTagsManager.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "ZBetaLog.h"
+
+const FZBStateTagIndex& FZBStateTagIndex::Get()
+{
+	static const FZBStateTagIndex Instance;
+	return Instance;
+}
+
+FZBStateTagIndex::FZBStateTagIndex()
+{
+	const FGameplayTag& StateRoot = FZBGameplayTags::Get().State;
+	if (!StateRoot.IsValid())
+	{
+		UE_LOG(LogZBetaAbility, Warning, TEXT("State 根标签无效，状态标签索引为空（是否在原生 Tag 注册之前调用？）"));
+		return;
+	}
+
+	// 根标签放最前面，其后是全部子孙标签
+	TArray<FGameplayTag> Candidates;
+	UGameplayTagsManager::Get().RequestGameplayTagChildren(StateRoot).GetGameplayTagArray(Candidates);
+	Candidates.Insert(StateRoot, 0);
+
+	for (const FGameplayTag& Tag : Candidates)
+	{
+		if (IndexedTags.Num() >= MaxIndexedTags)
+		{
+			UE_LOG(LogZBetaAbility, Warning, TEXT("State 标签超过 %d 个，%s 及之后的标签不进索引"), MaxIndexedTags, *Tag.ToString());
+			break;
+		}
+		if (!TagToIndex.Contains(Tag))
+		{
+			TagToIndex.Add(Tag, IndexedTags.Add(Tag));
+		}
+	}
+}
+
+int32 FZBStateTagIndex::IndexOf(const FGameplayTag& Tag) const
+{
+	const int32* Index = TagToIndex.Find(Tag);
+	return Index ? *Index : INDEX_NONE;
+}
+
+bool FZBStateTagIndex::CompileMask(const FGameplayTagContainer& Tags, uint64& OutMask) const
+{
+	OutMask = 0;
+	for (const FGameplayTag& Tag : Tags)
+	{
+		const int32 Index = IndexOf(Tag);
+		if (Index == INDEX_NONE)
+		{
+			return false;
+		}
+		OutMask |= uint64(1) << Index;
+	}
+	return true;
+}
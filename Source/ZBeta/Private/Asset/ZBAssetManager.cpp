@@ -3,7 +3,21 @@
 
 #include "Asset/ZBAssetManager.h"
 
+#include "AbilitySystemGlobals.h"
 #include "AbilitySystem/ZBGameplayTags.h"
+#include "Characters/ZBCharacterBase.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "ZBetaLog.h"
+
+const FPrimaryAssetType UZBAssetManager::CharacterLoadoutType(TEXT("CharacterLoadout"));
+const FName UZBAssetManager::AbilitiesBundle(TEXT("Abilities"));
+const FName UZBAssetManager::AttributesBundle(TEXT("Attributes"));
 
 UZBAssetManager& UZBAssetManager::Get()
 {
@@ -11,8 +25,219 @@ UZBAssetManager& UZBAssetManager::Get()
 	return * Cast<UZBAssetManager>(GEngine->AssetManager);
 }
 
+FPrimaryAssetId UZBAssetManager::GetCharacterLoadoutId(const TSoftClassPtr<AZBCharacterBase>& CharacterClass)
+{
+	// 与 AZBCharacterBase::GetPrimaryAssetId 一致：名字是蓝图包的短名
+	return FPrimaryAssetId(CharacterLoadoutType, FPackageName::GetShortFName(CharacterClass.ToSoftObjectPath().GetLongPackageFName()));
+}
+
+TSharedPtr<FStreamableHandle> UZBAssetManager::LoadCharacterLoadout(const TSoftClassPtr<AZBCharacterBase>& CharacterClass, FStreamableDelegate OnLoaded)
+{
+	if (CharacterClass.IsNull())
+	{
+		OnLoaded.ExecuteIfBound();
+		return nullptr;
+	}
+
+	const FPrimaryAssetId LoadoutId = GetCharacterLoadoutId(CharacterClass);
+	if (GetPrimaryAssetPath(LoadoutId).IsValid())
+	{
+		const TArray<FName> Bundles = { AbilitiesBundle, AttributesBundle };
+		return LoadPrimaryAsset(LoadoutId, Bundles, MoveTemp(OnLoaded));
+	}
+
+	UE_LOG(LogZBetaAsset, Warning, TEXT("%s 未注册为 CharacterLoadout 主资源（检查 PrimaryAssetTypesToScan），只流送类本身"), *CharacterClass.ToString());
+	return GetStreamableManager().RequestAsyncLoad(CharacterClass.ToSoftObjectPath(), MoveTemp(OnLoaded));
+}
+
+void UZBAssetManager::UnloadCharacterLoadout(const TSoftClassPtr<AZBCharacterBase>& CharacterClass)
+{
+	if (!CharacterClass.IsNull())
+	{
+		UnloadPrimaryAsset(GetCharacterLoadoutId(CharacterClass));
+	}
+}
+
+void UZBAssetManager::PinCharacterLoadout(const UWorld* World, const TSoftClassPtr<AZBCharacterBase>& CharacterClass)
+{
+	if (World && !CharacterClass.IsNull())
+	{
+		WorldPinnedLoadouts.FindOrAdd(World).Add(GetCharacterLoadoutId(CharacterClass));
+	}
+}
+
+void UZBAssetManager::AddLoadoutUser(const AZBCharacterBase& Character)
+{
+	const FPrimaryAssetId LoadoutId = GetLoadoutIdOf(Character);
+	if (LoadoutId.IsValid())
+	{
+		++LoadoutUserCounts.FindOrAdd(LoadoutId);
+	}
+}
+
+void UZBAssetManager::RemoveLoadoutUser(const AZBCharacterBase& Character)
+{
+	const FPrimaryAssetId LoadoutId = GetLoadoutIdOf(Character);
+	int32* Count = LoadoutUserCounts.Find(LoadoutId);
+	if (!Count) return;
+
+	if (--(*Count) <= 0)
+	{
+		LoadoutUserCounts.Remove(LoadoutId);
+		TryUnloadLoadout(LoadoutId);
+	}
+}
+
+FPrimaryAssetId UZBAssetManager::GetLoadoutIdOf(const AZBCharacterBase& Character)
+{
+	// 实例本身不是主资源，取其蓝图类 CDO 的 ID
+	return Character.GetClass()->GetDefaultObject<AZBCharacterBase>()->GetPrimaryAssetId();
+}
+
+void UZBAssetManager::TryUnloadLoadout(const FPrimaryAssetId& LoadoutId)
+{
+	if (ResidentLoadouts.Contains(LoadoutId) || LoadoutUserCounts.Contains(LoadoutId)) return;
+	for (const TPair<TObjectKey<UWorld>, TSet<FPrimaryAssetId>>& Pair : WorldPinnedLoadouts)
+	{
+		if (Pair.Value.Contains(LoadoutId)) return;
+	}
+
+	// 没有通过 LoadPrimaryAsset 加载过时 UnloadPrimaryAsset 什么也不做
+	if (UnloadPrimaryAsset(LoadoutId) > 0)
+	{
+		UE_LOG(LogZBetaAsset, Log, TEXT("[Loadout] 已释放 %s"), *LoadoutId.ToString());
+	}
+}
+
+void UZBAssetManager::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	TSet<FPrimaryAssetId> Pinned;
+	if (!WorldPinnedLoadouts.RemoveAndCopyValue(World, Pinned)) return;
+
+	for (const FPrimaryAssetId& LoadoutId : Pinned)
+	{
+		TryUnloadLoadout(LoadoutId);
+	}
+}
+
 void UZBAssetManager::StartInitialLoading()
 {
-	Super::StartInitialLoading();
+	StartupBeginSeconds = FPlatformTime::Seconds();
+
+	// 1. 原生 Tag：后面加载的蓝图反序列化 FGameplayTag 时需要它们已经注册
+	double PhaseStart = FPlatformTime::Seconds();
 	FZBGameplayTags::InitializeNativeTags();
-} 
+	AddStartupPhase(TEXT("NativeTags"), PhaseStart, FPlatformTime::Seconds());
+
+	// 2. 主资源扫描（之后才能按 ID 加载 CharacterLoadout）
+	PhaseStart = FPlatformTime::Seconds();
+	Super::StartInitialLoading();
+	AddStartupPhase(TEXT("PrimaryAssetScan"), PhaseStart, FPlatformTime::Seconds());
+
+	// 3. 角色 Loadout 异步预载，和下面的 GAS 初始化并行
+	StartPreloadCharacterClasses();
+	FWorldDelegates::OnWorldCleanup.AddUObject(this, &UZBAssetManager::OnWorldCleanup);
+
+	// 4. GAS 全局数据（TargetData、GameplayCue 管理器等），提前到启动阶段做，避免第一次用技能时卡顿
+	PhaseStart = FPlatformTime::Seconds();
+	UAbilitySystemGlobals::Get().InitGlobalData();
+	AddStartupPhase(TEXT("AbilitySystemGlobals"), PhaseStart, FPlatformTime::Seconds());
+
+	bSyncPhasesDone = true;
+	TryWriteStartupReport();
+}
+
+void UZBAssetManager::AddStartupPhase(const TCHAR* Name, double StartSeconds, double EndSeconds)
+{
+	FStartupPhase& Phase = StartupPhases.AddDefaulted_GetRef();
+	Phase.Name = Name;
+	Phase.StartSeconds = StartSeconds - StartupBeginSeconds;
+	Phase.Milliseconds = (EndSeconds - StartSeconds) * 1000.0;
+
+	UE_LOG(LogZBetaAsset, Log, TEXT("[Startup] %s：%.2f ms"), Name, Phase.Milliseconds);
+}
+
+void UZBAssetManager::StartPreloadCharacterClasses()
+{
+	PreloadStartSeconds = FPlatformTime::Seconds();
+
+	// 能力与 GE 是软引用，按 Loadout 的 Bundle 一起流送
+	TArray<TSharedPtr<FStreamableHandle>> Handles;
+	for (const TSoftClassPtr<AZBCharacterBase>& CharacterClass : PreloadCharacterClasses)
+	{
+		if (!CharacterClass.IsNull())
+		{
+			ResidentLoadouts.Add(GetCharacterLoadoutId(CharacterClass));
+		}
+		if (TSharedPtr<FStreamableHandle> Handle = LoadCharacterLoadout(CharacterClass))
+		{
+			Handles.Add(Handle);
+		}
+	}
+
+	if (Handles.IsEmpty())
+	{
+		OnPreloadCharacterClassesComplete();
+		return;
+	}
+
+	PreloadHandle = GetStreamableManager().CreateCombinedHandle(Handles);
+	if (!PreloadHandle.IsValid() || PreloadHandle->HasLoadCompleted())
+	{
+		OnPreloadCharacterClassesComplete();
+		return;
+	}
+	PreloadHandle->BindCompleteDelegate(FStreamableDelegate::CreateUObject(this, &UZBAssetManager::OnPreloadCharacterClassesComplete));
+}
+
+void UZBAssetManager::OnPreloadCharacterClassesComplete()
+{
+	if (bPreloadDone) return;
+
+	AddStartupPhase(TEXT("PreloadCharacters"), PreloadStartSeconds, FPlatformTime::Seconds());
+	bPreloadDone = true;
+	TryWriteStartupReport();
+}
+
+/**
+ * @brief 写启动报告
+ * @details 各阶段的起点（相对 StartInitialLoading）与耗时，外加进程启动到现在的总时长；
+ *          预载与同步阶段并行，所以各阶段耗时之和大于 Wall 时长是正常的。
+ */
+void UZBAssetManager::TryWriteStartupReport()
+{
+	if (!bSyncPhasesDone || !bPreloadDone) return;
+
+	const double NowSeconds = FPlatformTime::Seconds();
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("Timestamp"), FDateTime::UtcNow().ToIso8601());
+	Root->SetBoolField(TEXT("DedicatedServer"), IsRunningDedicatedServer());
+	Root->SetNumberField(TEXT("WallMs"), (NowSeconds - StartupBeginSeconds) * 1000.0);
+	Root->SetNumberField(TEXT("SinceProcessStartMs"), (NowSeconds - GStartTime) * 1000.0);
+	Root->SetNumberField(TEXT("NativeTags"), FZBGameplayTags::GetNumNativeTags());
+	Root->SetNumberField(TEXT("PreloadedClasses"), PreloadCharacterClasses.Num());
+
+	TArray<TSharedPtr<FJsonValue>> Phases;
+	for (const FStartupPhase& Phase : StartupPhases)
+	{
+		TSharedRef<FJsonObject> PhaseObject = MakeShared<FJsonObject>();
+		PhaseObject->SetStringField(TEXT("Name"), Phase.Name);
+		PhaseObject->SetNumberField(TEXT("StartMs"), Phase.StartSeconds * 1000.0);
+		PhaseObject->SetNumberField(TEXT("Ms"), Phase.Milliseconds);
+		Phases.Add(MakeShared<FJsonValueObject>(PhaseObject));
+	}
+	Root->SetArrayField(TEXT("Phases"), Phases);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("ZBStartupReport.json");
+	const double WallMs = (NowSeconds - StartupBeginSeconds) * 1000.0;
+	if (!FFileHelper::SaveStringToFile(Json, *Path))
+	{
+		UE_LOG(LogZBetaAsset, Warning, TEXT("[Startup] 初始加载完成，总计 %.2f ms；启动报告写入失败：%s"), WallMs, *Path);
+		return;
+	}
+	UE_LOG(LogZBetaAsset, Display, TEXT("[Startup] 初始加载完成，总计 %.2f ms，报告：%s"), WallMs, *Path);
+}
@@ -0,0 +1,546 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/ZBCombatSoakSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "EngineUtils.h"
+#include "GameplayEffect.h"
+#include "AbilitySystem/ZBAbilitySystemComponent.h"
+#include "AbilitySystem/ZBAttributeSet.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "Characters/ZBEnemyCharacter.h"
+#include "Characters/ZBPlayerCharacter.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Net/ZBReplicationGraph.h"
+#include "Player/ZBPlayerState.h"
+#include "ZBetaLog.h"
+
+
+AZBSoakBotController::AZBSoakBotController()
+{
+	bWantsPlayerState = true;
+}
+
+void AZBSoakBotController::InitPlayerState()
+{
+	Super::InitPlayerState();
+
+	// GameMode 配置的 PlayerState 不是 AZBPlayerState 时，玩家角色拿不到 ASC，这里换成原生类
+	if (PlayerState && PlayerState->IsA<AZBPlayerState>()) return;
+	if (PlayerState)
+	{
+		PlayerState->Destroy();
+		PlayerState = nullptr;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.Owner = this;
+	SpawnInfo.Instigator = GetInstigator();
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+	PlayerState = GetWorld()->SpawnActor<AZBPlayerState>(AZBPlayerState::StaticClass(), SpawnInfo);
+}
+
+
+bool UZBCombatSoakSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer)) return false;
+	return FParse::Param(FCommandLine::Get(), TEXT("ZBSoak"));
+}
+
+bool UZBCombatSoakSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UZBCombatSoakSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UZBCombatSoakSubsystem, STATGROUP_Tickables);
+}
+
+void UZBCombatSoakSubsystem::ParseCommandLine()
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("ZBSoakEnemies="), NumEnemies);
+	FParse::Value(CommandLine, TEXT("ZBSoakPlayers="), NumPlayers);
+	FParse::Value(CommandLine, TEXT("ZBSoakDuration="), DurationSeconds);
+	FParse::Value(CommandLine, TEXT("ZBSoakWarmup="), WarmupSeconds);
+	FParse::Value(CommandLine, TEXT("ZBSoakRate="), ActionsPerActorPerSecond);
+	FParse::Value(CommandLine, TEXT("ZBSoakSeed="), RandomSeed);
+	FParse::Value(CommandLine, TEXT("ZBSoakConnections="), NumConnections);
+	FParse::Value(CommandLine, TEXT("ZBSoakConnectTimeout="), ConnectTimeoutSeconds);
+
+	if (!FParse::Value(CommandLine, TEXT("ZBSoakCsv="), CsvPath))
+	{
+		CsvPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("ZBCombatSoak.csv");
+	}
+
+	NumEnemies = FMath::Max(0, NumEnemies);
+	NumPlayers = FMath::Max(0, NumPlayers);
+	DurationSeconds = FMath::Max(1.f, DurationSeconds);
+	WarmupSeconds = FMath::Max(0.f, WarmupSeconds);
+	NumConnections = FMath::Max(0, NumConnections);
+	ConnectTimeoutSeconds = FMath::Max(0.f, ConnectTimeoutSeconds);
+}
+
+int32 UZBCombatSoakSubsystem::GetNumClientConnections() const
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	return NetDriver ? NetDriver->ClientConnections.Num() : 0;
+}
+
+uint64 UZBCombatSoakSubsystem::GetOutTotalBytes() const
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	return NetDriver ? NetDriver->OutTotalBytes : 0;
+}
+
+bool UZBCombatSoakSubsystem::GetReplicationMs(float& OutMs) const
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	const UZBReplicationGraph* Graph = NetDriver ? Cast<UZBReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr;
+	if (!Graph) return false;
+
+	OutMs = static_cast<float>(Graph->GetLastReplicateSeconds() * 1000.0);
+	return true;
+}
+
+/**
+ * @brief 地图 BeginPlay 后开始压测（仅服务器）
+ *
+ * 详细流程：
+ *   1. 解析命令行，初始化随机流（固定种子，保证多次运行的动作序列一致）；
+ *   2. 准备战斗 GE 与 Tag 翻转表；
+ *   3. 生成敌人与 AI 玩家，并绑定计数回调；
+ */
+void UZBCombatSoakSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() == NM_Client) return;
+
+	ParseCommandLine();
+	RandomStream.Initialize(RandomSeed);
+	MapName = InWorld.GetMapName();
+
+	if (!CombatEffectClass.IsNull())
+	{
+		if (const UClass* EffectClass = CombatEffectClass.LoadSynchronous())
+		{
+			CombatEffect = EffectClass->GetDefaultObject<UGameplayEffect>();
+		}
+	}
+	if (!CombatEffect)
+	{
+		// 没有配置 GE 时构造一个临时的瞬时扣血 GE
+		UGameplayEffect* TransientEffect = NewObject<UGameplayEffect>(this, TEXT("GE_ZBSoakDamage"), RF_Transient);
+		TransientEffect->DurationPolicy = EGameplayEffectDurationType::Instant;
+		FGameplayModifierInfo& Modifier = TransientEffect->Modifiers.AddDefaulted_GetRef();
+		Modifier.Attribute = UZBAttributeSet::GetHealthAttribute();
+		Modifier.ModifierOp = EGameplayModOp::Additive;
+		Modifier.ModifierMagnitude = FScalableFloat(-1.f);
+		CombatEffect = TransientEffect;
+	}
+
+	const FZBGameplayTags& GameplayTags = FZBGameplayTags::Get();
+	ChurnTags = {
+		GameplayTags.State_InCombat,
+		GameplayTags.State_Attacking,
+		GameplayTags.State_Blocking,
+		GameplayTags.HitReact_Light,
+		GameplayTags.HitReact_Medium,
+		GameplayTags.HitReact_Heavy,
+	};
+	InputTagRoot = FGameplayTag::RequestGameplayTag(TEXT("InputTag"), false);
+
+	SpawnSoakActors(InWorld);
+
+	FrameTimesMs.Reserve(FMath::CeilToInt(DurationSeconds * 120.f));
+	ReplicationTimesMs.Reserve(FrameTimesMs.Max());
+	StartTime = FPlatformTime::Seconds();
+	bRunning = true;
+
+	UE_LOG(LogZBetaBenchmark, Display, TEXT("[ZBSoak] 开始压测：地图 %s，敌人 %d，玩家 %d，连接 %d，预热 %.1fs，统计 %.1fs"),
+		*MapName, NumEnemies, NumPlayers, NumConnections, WarmupSeconds, DurationSeconds);
+}
+
+void UZBCombatSoakSubsystem::Deinitialize()
+{
+	SoakActors.Reset();
+	bRunning = false;
+	Super::Deinitialize();
+}
+
+FVector UZBCombatSoakSubsystem::GetRandomSpawnLocation(const FVector& Origin)
+{
+	const FVector2D Offset = FVector2D(RandomStream.VRand()).GetSafeNormal() * RandomStream.FRandRange(0.f, SpawnRadius);
+	return Origin + FVector(Offset.X, Offset.Y, 0.f);
+}
+
+void UZBCombatSoakSubsystem::SpawnSoakActors(UWorld& InWorld)
+{
+	FVector Origin = FVector::ZeroVector;
+	for (TActorIterator<APlayerStart> It(&InWorld); It; ++It)
+	{
+		Origin = It->GetActorLocation();
+		break;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	// 敌人：ASC 在自身上，BeginPlay 里初始化
+	UClass* EnemyPawnClass = EnemyClass.IsNull() ? AZBEnemyCharacter::StaticClass() : EnemyClass.LoadSynchronous();
+	for (int32 Index = 0; EnemyPawnClass && Index < NumEnemies; ++Index)
+	{
+		const FRotator Rotation(0.f, RandomStream.FRandRange(0.f, 360.f), 0.f);
+		if (AZBEnemyCharacter* Enemy = InWorld.SpawnActor<AZBEnemyCharacter>(EnemyPawnClass, GetRandomSpawnLocation(Origin), Rotation, SpawnParams))
+		{
+			RegisterSoakActor(Enemy, Enemy->GetAbilitySystemComponent(), false);
+		}
+	}
+
+	// 玩家：ASC 在 PlayerState 上，Possess 时由 InitAbilityActorInfo 初始化（需要蓝图配置的默认属性 GE）
+	UClass* PlayerPawnClass = PlayerClass.LoadSynchronous();
+	if (!PlayerPawnClass && NumPlayers > 0)
+	{
+		UE_LOG(LogZBetaBenchmark, Warning, TEXT("[ZBSoak] 未配置 PlayerClass，跳过 %d 个 AI 玩家"), NumPlayers);
+		return;
+	}
+	for (int32 Index = 0; Index < NumPlayers; ++Index)
+	{
+		AZBSoakBotController* Controller = InWorld.SpawnActor<AZBSoakBotController>(AZBSoakBotController::StaticClass(), SpawnParams);
+		const FRotator Rotation(0.f, RandomStream.FRandRange(0.f, 360.f), 0.f);
+		AZBPlayerCharacter* Player = InWorld.SpawnActor<AZBPlayerCharacter>(PlayerPawnClass, GetRandomSpawnLocation(Origin), Rotation, SpawnParams);
+		if (!Controller || !Player) continue;
+
+		Controller->Possess(Player);
+		RegisterSoakActor(Player, Player->GetAbilitySystemComponent(), true);
+	}
+}
+
+void UZBCombatSoakSubsystem::RegisterSoakActor(APawn* Pawn, UAbilitySystemComponent* ASC, bool bIsPlayer)
+{
+	if (!Pawn || !ASC) return;
+
+	FSoakActor& Actor = SoakActors.AddDefaulted_GetRef();
+	Actor.Pawn = Pawn;
+	Actor.ASC = ASC;
+	Actor.bIsPlayer = bIsPlayer;
+	// 错开各角色的动作时机，避免所有人在同一帧动作
+	Actor.ActionAccumulator = RandomStream.FRand();
+	Actor.MoveDirection = FVector(FVector2D(RandomStream.VRand()).GetSafeNormal(), 0.f);
+
+	ASC->OnGameplayEffectAppliedDelegateToSelf.AddUObject(this, &UZBCombatSoakSubsystem::OnGameplayEffectApplied);
+	ASC->AbilityActivatedCallbacks.AddUObject(this, &UZBCombatSoakSubsystem::OnAbilityActivated);
+	ASC->RegisterGenericGameplayTagEvent().AddUObject(this, &UZBCombatSoakSubsystem::OnAnyTagChanged);
+}
+
+/**
+ * @brief 每帧：记录帧时间、驱动脚本化战斗、到时结束
+ *
+ * 注意事项：
+ *   - 预热结束且连接数达到 NumConnections（或等待超时）后才开始统计；
+ *   - 复制图在本 Tick 之后的 TickFlush 中运行，这里记录的是上一帧的复制耗时；
+ *   - 内存统计在 Linux 上要读 /proc，开销不小，每秒采样一次峰值即可。
+ */
+void UZBCombatSoakSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bRunning) return;
+
+	const double Now = FPlatformTime::Seconds();
+	if (!bMeasuring && Now - StartTime >= WarmupSeconds)
+	{
+		const int32 Connections = GetNumClientConnections();
+		const bool bTimedOut = Now - StartTime >= WarmupSeconds + ConnectTimeoutSeconds;
+		if (Connections >= NumConnections || bTimedOut)
+		{
+			if (Connections < NumConnections)
+			{
+				UE_LOG(LogZBetaBenchmark, Warning, TEXT("[ZBSoak] 等待 %.0fs 后只有 %d / %d 个连接，照常开始统计"), ConnectTimeoutSeconds, Connections, NumConnections);
+			}
+
+			bMeasuring = true;
+			MeasureStartTime = Now;
+			StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+			PeakUsedPhysical = StartUsedPhysical;
+			StartOutBytes = GetOutTotalBytes();
+		}
+	}
+
+	if (bMeasuring)
+	{
+		// 扣掉限帧休眠，只统计真实工作时间
+		const double WorkSeconds = FMath::Max(0.0, FApp::GetDeltaTime() - FApp::GetIdleTime());
+		FrameTimesMs.Add(static_cast<float>(WorkSeconds * 1000.0));
+
+		float ReplicationMs = 0.f;
+		if (GetReplicationMs(ReplicationMs))
+		{
+			ReplicationTimesMs.Add(ReplicationMs);
+		}
+
+		const int32 SecondIndex = static_cast<int32>(Now - MeasureStartTime);
+		if (SecondIndex != LastMemorySampleSecond)
+		{
+			LastMemorySampleSecond = SecondIndex;
+			PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+		}
+	}
+
+	for (FSoakActor& Actor : SoakActors)
+	{
+		if (!Actor.Pawn.IsValid() || !Actor.ASC.IsValid()) continue;
+
+		if (Actor.bIsPlayer)
+		{
+			Actor.Pawn->AddMovementInput(Actor.MoveDirection);
+		}
+
+		Actor.ActionAccumulator += ActionsPerActorPerSecond * DeltaTime;
+		while (Actor.ActionAccumulator >= 1.f)
+		{
+			Actor.ActionAccumulator -= 1.f;
+			PerformCombatAction(Actor);
+		}
+	}
+
+	if (bMeasuring && Now - MeasureStartTime >= DurationSeconds)
+	{
+		FinishSoak();
+	}
+}
+
+void UZBCombatSoakSubsystem::PerformCombatAction(FSoakActor& Actor)
+{
+	switch (RandomStream.RandHelper(3))
+	{
+	case 0:
+		ActivateRandomAbility(Actor);
+		break;
+	case 1:
+		ApplyCombatEffect(Actor);
+		break;
+	default:
+		ChurnTag(Actor);
+		break;
+	}
+
+	if (Actor.bIsPlayer && RandomStream.FRand() < 0.25f)
+	{
+		Actor.MoveDirection = FVector(FVector2D(RandomStream.VRand()).GetSafeNormal(), 0.f);
+	}
+}
+
+/**
+ * @brief 随机激活一个已授予的技能
+ * @details 玩家走 UZBAbilitySystemComponent 的输入标签路径（按下 / 长按 / 松开），和真实输入一致；
+ *          敌人没有输入，直接 TryActivateAbility。
+ */
+void UZBCombatSoakSubsystem::ActivateRandomAbility(FSoakActor& Actor)
+{
+	UAbilitySystemComponent* ASC = Actor.ASC.Get();
+	const TArray<FGameplayAbilitySpec>& Specs = ASC->GetActivatableAbilities();
+	if (Specs.IsEmpty()) return;
+
+	const FGameplayAbilitySpec& Spec = Specs[RandomStream.RandHelper(Specs.Num())];
+	const FGameplayAbilitySpecHandle Handle = Spec.Handle;
+
+	UZBAbilitySystemComponent* ZBASC = Cast<UZBAbilitySystemComponent>(ASC);
+	if (Actor.bIsPlayer && ZBASC && InputTagRoot.IsValid())
+	{
+		FGameplayTag InputTag;
+		for (const FGameplayTag& Tag : Spec.GetDynamicSpecSourceTags())
+		{
+			if (Tag.MatchesTag(InputTagRoot))
+			{
+				InputTag = Tag;
+				break;
+			}
+		}
+		if (InputTag.IsValid())
+		{
+			ZBASC->AbilityInputForTagPressed(InputTag);
+			ZBASC->AbilityInputForTagHeld(InputTag);
+			ZBASC->AbilityInputForTagReleased(InputTag);
+			return;
+		}
+	}
+
+	ASC->TryActivateAbility(Handle);
+}
+
+/**
+ * @brief 随机挑一个目标应用战斗 GE
+ * @details 血量低于 25% 时直接回满，保证角色一直存活、压测负载稳定。
+ */
+void UZBCombatSoakSubsystem::ApplyCombatEffect(FSoakActor& Actor)
+{
+	if (!CombatEffect || SoakActors.IsEmpty()) return;
+
+	UAbilitySystemComponent* SourceASC = Actor.ASC.Get();
+	UAbilitySystemComponent* TargetASC = SoakActors[RandomStream.RandHelper(SoakActors.Num())].ASC.Get();
+	if (!TargetASC) return;
+
+	FGameplayEffectContextHandle ContextHandle = SourceASC->MakeEffectContext();
+	ContextHandle.AddSourceObject(Actor.Pawn.Get());
+	SourceASC->ApplyGameplayEffectToTarget(CombatEffect, TargetASC, 1.f, ContextHandle);
+
+	const float MaxHealth = TargetASC->GetNumericAttribute(UZBAttributeSet::GetMaxHealthAttribute());
+	if (MaxHealth > 0.f && TargetASC->GetNumericAttribute(UZBAttributeSet::GetHealthAttribute()) < MaxHealth * 0.25f)
+	{
+		TargetASC->SetNumericAttributeBase(UZBAttributeSet::GetHealthAttribute(), MaxHealth);
+	}
+}
+
+void UZBCombatSoakSubsystem::ChurnTag(FSoakActor& Actor)
+{
+	if (ChurnTags.IsEmpty()) return;
+
+	UAbilitySystemComponent* ASC = Actor.ASC.Get();
+	const FGameplayTag& Tag = ChurnTags[RandomStream.RandHelper(ChurnTags.Num())];
+	if (ASC->HasMatchingGameplayTag(Tag))
+	{
+		ASC->RemoveLooseGameplayTag(Tag);
+	}
+	else
+	{
+		ASC->AddLooseGameplayTag(Tag);
+	}
+}
+
+void UZBCombatSoakSubsystem::OnGameplayEffectApplied(UAbilitySystemComponent* Target, const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle)
+{
+	if (bMeasuring) ++NumEffectsApplied;
+}
+
+void UZBCombatSoakSubsystem::OnAbilityActivated(UGameplayAbility* Ability)
+{
+	if (bMeasuring) ++NumAbilitiesActivated;
+}
+
+void UZBCombatSoakSubsystem::OnAnyTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	if (bMeasuring) ++NumTagChanges;
+}
+
+void UZBCombatSoakSubsystem::FinishSoak()
+{
+	bRunning = false;
+	MeasureEndTime = FPlatformTime::Seconds();
+	PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+	EndOutBytes = GetOutTotalBytes();
+	EndConnections = GetNumClientConnections();
+
+	const bool bWritten = WriteCsv();
+
+	if (!FParse::Param(FCommandLine::Get(), TEXT("ZBSoakNoExit")))
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bWritten ? 0 : 1, TEXT("ZBCombatSoak"));
+	}
+}
+
+/**
+ * @brief 追加一行统计结果到 CSV（文件不存在时先写表头）
+ * @return 是否写入成功；失败时统计仍会输出到日志
+ */
+bool UZBCombatSoakSubsystem::WriteCsv() const
+{
+	TArray<float> Sorted = FrameTimesMs;
+	Sorted.Sort();
+
+	TArray<float> SortedReplication = ReplicationTimesMs;
+	SortedReplication.Sort();
+
+	auto PercentileOf = [](const TArray<float>& Values, float Ratio) -> float
+	{
+		if (Values.IsEmpty()) return 0.f;
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Ratio * Values.Num()) - 1, 0, Values.Num() - 1);
+		return Values[Index];
+	};
+	auto Percentile = [&Sorted, &PercentileOf](float Ratio) -> float
+	{
+		return PercentileOf(Sorted, Ratio);
+	};
+
+	double TotalReplicationMs = 0.0;
+	for (const float ReplicationMs : SortedReplication)
+	{
+		TotalReplicationMs += ReplicationMs;
+	}
+
+	double TotalMs = 0.0;
+	for (const float FrameMs : Sorted)
+	{
+		TotalMs += FrameMs;
+	}
+
+	const double Elapsed = FMath::Max(MeasureEndTime - MeasureStartTime, UE_SMALL_NUMBER);
+	const float AverageMs = Sorted.IsEmpty() ? 0.f : static_cast<float>(TotalMs / Sorted.Num());
+	const float MaxMs = Sorted.IsEmpty() ? 0.f : Sorted.Last();
+	const double ToMB = 1.0 / (1024.0 * 1024.0);
+	const float ReplicationAverageMs = SortedReplication.IsEmpty() ? 0.f : static_cast<float>(TotalReplicationMs / SortedReplication.Num());
+	const double OutKBytesPerSecond = (EndOutBytes - StartOutBytes) / 1024.0 / Elapsed;
+
+	FString Output;
+	if (IFileManager::Get().FileSize(*CsvPath) < 0)
+	{
+		Output += TEXT("Timestamp,Map,Build,Enemies,Players,Seconds,Frames,AvgMs,P50Ms,P90Ms,P99Ms,MaxMs,")
+			TEXT("EffectsApplied,EffectsPerSec,AbilitiesActivated,AbilitiesPerSec,TagChanges,TagChangesPerSec,")
+			TEXT("StartUsedPhysicalMB,PeakUsedPhysicalMB,Connections,RepAvgMs,RepP50Ms,RepP99Ms,OutKBytesPerSec\n");
+	}
+	Output += FString::Printf(TEXT("%s,%s,%s,%d,%d,%.2f,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%lld,%.1f,%lld,%.1f,%lld,%.1f,%.1f,%.1f,%d,%.3f,%.3f,%.3f,%.1f\n"),
+		*FDateTime::Now().ToString(),
+		*MapName,
+		LexToString(FApp::GetBuildConfiguration()),
+		NumEnemies,
+		NumPlayers,
+		Elapsed,
+		Sorted.Num(),
+		AverageMs,
+		Percentile(0.50f),
+		Percentile(0.90f),
+		Percentile(0.99f),
+		MaxMs,
+		NumEffectsApplied,
+		NumEffectsApplied / Elapsed,
+		NumAbilitiesActivated,
+		NumAbilitiesActivated / Elapsed,
+		NumTagChanges,
+		NumTagChanges / Elapsed,
+		StartUsedPhysical * ToMB,
+		PeakUsedPhysical * ToMB,
+		EndConnections,
+		ReplicationAverageMs,
+		PercentileOf(SortedReplication, 0.50f),
+		PercentileOf(SortedReplication, 0.99f),
+		OutKBytesPerSecond);
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(CsvPath), true);
+	const bool bWritten = FFileHelper::SaveStringToFile(Output, *CsvPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+
+	UE_LOG(LogZBetaBenchmark, Display, TEXT("[ZBSoak] 完成：%d 帧，P50 %.2fms / P90 %.2fms / P99 %.2fms，GE %.1f/s，峰值内存 %.1fMB，")
+		TEXT("%d 个连接，复制 %.2fms / P99 %.2fms，发送 %.1fKB/s"),
+		Sorted.Num(), Percentile(0.50f), Percentile(0.90f), Percentile(0.99f), NumEffectsApplied / Elapsed, PeakUsedPhysical * ToMB,
+		EndConnections, ReplicationAverageMs, PercentileOf(SortedReplication, 0.99f), OutKBytesPerSecond);
+	if (bWritten)
+	{
+		UE_LOG(LogZBetaBenchmark, Display, TEXT("[ZBSoak] CSV 已写入：%s"), *CsvPath);
+	}
+	else
+	{
+		UE_LOG(LogZBetaBenchmark, Error, TEXT("[ZBSoak] CSV 写入失败：%s"), *CsvPath);
+	}
+	return bWritten;
+}
@@ -0,0 +1,240 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/ZBMemoryReport.h"
+
+#include "AbilitySystemComponent.h"
+#include "EngineUtils.h"
+#include "Abilities/GameplayAbility.h"
+#include "Characters/ZBCharacterBase.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Net/DataReplication.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "ZBetaLog.h"
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GZBMemReportCommand(
+	TEXT("ZB.MemReport"),
+	TEXT("统计当前世界中每个 ZBeta 角色的内存占用（按子系统），并导出 CSV。参数：[CsvPath]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		FZBMemoryReport::Report(FZBMemoryReport::Collect(World), Args.Num() > 0 ? Args[0] : FString(), Ar);
+	}));
+
+namespace ZBMemoryReport
+{
+	SIZE_T GetObjectBytes(const UObject* Object)
+	{
+		return Object ? Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive) : 0;
+	}
+
+	// 估算一个 TMap<FGameplayTag, int32> 装 Num 个元素时的分配大小
+	SIZE_T GetTagCountMapBytes(int32 Num)
+	{
+		TMap<FGameplayTag, int32> Probe;
+		Probe.Reserve(Num);
+		return Probe.GetAllocatedSize();
+	}
+}
+
+
+TArray<FZBCharacterMemory> FZBMemoryReport::Collect(UWorld* World)
+{
+	TArray<FZBCharacterMemory> Entries;
+	if (!World) return Entries;
+
+	for (TActorIterator<AZBCharacterBase> It(World); It; ++It)
+	{
+		Entries.Add(MeasureCharacter(*It));
+	}
+	return Entries;
+}
+
+FZBCharacterMemory FZBMemoryReport::MeasureCharacter(AZBCharacterBase* Character)
+{
+	using namespace ZBMemoryReport;
+
+	FZBCharacterMemory Entry;
+	Entry.Name = Character->GetName();
+	Entry.ClassName = Character->GetClass()->GetName();
+
+	UAbilitySystemComponent* ASC = Character->GetAbilitySystemComponent();
+	// 玩家的 ASC 与 AttributeSet 挂在 PlayerState 上，PlayerState 一并算到该角色头上
+	const APlayerState* PlayerState = Character->GetPlayerState();
+	Entry.bIsPlayer = PlayerState && ASC && ASC->GetOwner() == PlayerState;
+
+	TArray<const AActor*, TInlineAllocator<2>> Actors;
+	Actors.Add(Character);
+	if (Entry.bIsPlayer)
+	{
+		Actors.Add(PlayerState);
+	}
+
+	for (const AActor* Actor : Actors)
+	{
+		Entry.ActorBytes += GetObjectBytes(Actor);
+		Entry.ReplicationBytes += MeasureReplication(Actor);
+
+		for (const UActorComponent* Component : Actor->GetComponents())
+		{
+			if (Component && Component != ASC)
+			{
+				Entry.ComponentBytes += GetObjectBytes(Component);
+			}
+		}
+	}
+
+	if (ASC)
+	{
+		Entry.ASCBytes = GetObjectBytes(ASC);
+		MeasureAbilitySystem(ASC, Entry);
+	}
+	return Entry;
+}
+
+void FZBMemoryReport::MeasureAbilitySystem(const UAbilitySystemComponent* ASC, FZBCharacterMemory& OutEntry)
+{
+	using namespace ZBMemoryReport;
+
+	for (const UAttributeSet* AttributeSet : ASC->GetSpawnedAttributes())
+	{
+		OutEntry.AttributeSetBytes += GetObjectBytes(AttributeSet);
+	}
+
+	// 能力：Spec 数组 + 每个 Spec 的实例数组；实例本身是独立的 UObject
+	const TArray<FGameplayAbilitySpec>& Specs = ASC->GetActivatableAbilities();
+	OutEntry.NumAbilitySpecs = Specs.Num();
+	OutEntry.AbilitySpecBytes = Specs.GetAllocatedSize();
+	for (const FGameplayAbilitySpec& Spec : Specs)
+	{
+		const TArray<UGameplayAbility*> Instances = Spec.GetAbilityInstances();
+		OutEntry.AbilitySpecBytes += Instances.GetAllocatedSize();
+		OutEntry.NumAbilityInstances += Instances.Num();
+		for (const UGameplayAbility* Instance : Instances)
+		{
+			OutEntry.AbilityInstanceBytes += GetObjectBytes(Instance);
+		}
+	}
+
+	// GE：每个激活中的 GE 本体 + Spec 里的修改器、SetByCaller、动态标签
+	for (const FActiveGameplayEffectHandle& Handle : ASC->GetActiveEffects(FGameplayEffectQuery()))
+	{
+		const FActiveGameplayEffect* Effect = ASC->GetActiveGameplayEffect(Handle);
+		if (!Effect) continue;
+
+		const FGameplayEffectSpec& Spec = Effect->Spec;
+		++OutEntry.NumActiveEffects;
+		OutEntry.ActiveEffectBytes += sizeof(FActiveGameplayEffect)
+			+ Spec.Modifiers.GetAllocatedSize()
+			+ Spec.SetByCallerNameMagnitudes.GetAllocatedSize()
+			+ Spec.SetByCallerTagMagnitudes.GetAllocatedSize()
+			+ (Spec.GetDynamicAssetTags().Num() + Spec.DynamicGrantedTags.Num()) * sizeof(FGameplayTag);
+	}
+
+	// Tag：显式标签计数表 + 含父标签的计数表
+	FGameplayTagContainer OwnedTags;
+	ASC->GetOwnedGameplayTags(OwnedTags);
+	const int32 NumExpandedTags = OwnedTags.GetGameplayTagParents().Num();
+	OutEntry.TagBytes = sizeof(FGameplayTagCountContainer)
+		+ GetTagCountMapBytes(OwnedTags.Num())
+		+ GetTagCountMapBytes(NumExpandedTags)
+		+ (OwnedTags.Num() + NumExpandedTags) * sizeof(FGameplayTag);
+}
+
+SIZE_T FZBMemoryReport::MeasureReplication(const AActor* Actor)
+{
+	const UNetDriver* NetDriver = Actor->GetNetDriver();
+	if (!NetDriver || !Actor->GetIsReplicated()) return 0;
+
+	FArchiveCountMem CountMem(nullptr);
+	SIZE_T Bytes = 0;
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		UActorChannel* Channel = Connection ? Connection->FindActorChannelRef(const_cast<AActor*>(Actor)) : nullptr;
+		if (!Channel) continue;
+
+		Bytes += Channel->GetClass()->GetStructureSize();
+		for (const TPair<UObject*, TSharedRef<FObjectReplicator>>& Pair : Channel->ReplicationMap)
+		{
+			Pair.Value->CountBytes(CountMem);
+		}
+	}
+	return Bytes + CountMem.GetMax();
+}
+
+void FZBMemoryReport::Report(const TArray<FZBCharacterMemory>& Entries, const FString& CsvPath, FOutputDevice& Ar)
+{
+	// 按类汇总
+	struct FClassSummary
+	{
+		int32 Count = 0;
+		FZBCharacterMemory Sum;
+	};
+	TMap<FString, FClassSummary> Summaries;
+	for (const FZBCharacterMemory& Entry : Entries)
+	{
+		FClassSummary& Summary = Summaries.FindOrAdd(Entry.ClassName);
+		++Summary.Count;
+		Summary.Sum.ActorBytes += Entry.ActorBytes;
+		Summary.Sum.ComponentBytes += Entry.ComponentBytes;
+		Summary.Sum.ASCBytes += Entry.ASCBytes;
+		Summary.Sum.ActiveEffectBytes += Entry.ActiveEffectBytes;
+		Summary.Sum.AbilitySpecBytes += Entry.AbilitySpecBytes;
+		Summary.Sum.AbilityInstanceBytes += Entry.AbilityInstanceBytes;
+		Summary.Sum.AttributeSetBytes += Entry.AttributeSetBytes;
+		Summary.Sum.TagBytes += Entry.TagBytes;
+		Summary.Sum.ReplicationBytes += Entry.ReplicationBytes;
+	}
+
+	Ar.Logf(TEXT("ZB.MemReport：%d 个角色（单位：字节/个，ActiveGEs/Specs/Tags 为 ASC 内部细分）"), Entries.Num());
+	Ar.Logf(TEXT("%-32s %6s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s"),
+		TEXT("Class"), TEXT("Count"), TEXT("Total"), TEXT("Actor"), TEXT("Comps"), TEXT("ASC"),
+		TEXT("ActiveGEs"), TEXT("Specs"), TEXT("Instances"), TEXT("AttrSets"), TEXT("Tags"), TEXT("Repl"));
+	for (const TPair<FString, FClassSummary>& Pair : Summaries)
+	{
+		const FZBCharacterMemory& Sum = Pair.Value.Sum;
+		const SIZE_T Count = Pair.Value.Count;
+		Ar.Logf(TEXT("%-32s %6d %10llu %10llu %10llu %10llu %10llu %10llu %10llu %10llu %10llu %10llu"),
+			*Pair.Key, Pair.Value.Count,
+			static_cast<uint64>(Sum.GetTotalBytes() / Count), static_cast<uint64>(Sum.ActorBytes / Count),
+			static_cast<uint64>(Sum.ComponentBytes / Count), static_cast<uint64>(Sum.ASCBytes / Count),
+			static_cast<uint64>(Sum.ActiveEffectBytes / Count), static_cast<uint64>(Sum.AbilitySpecBytes / Count),
+			static_cast<uint64>(Sum.AbilityInstanceBytes / Count), static_cast<uint64>(Sum.AttributeSetBytes / Count),
+			static_cast<uint64>(Sum.TagBytes / Count), static_cast<uint64>(Sum.ReplicationBytes / Count));
+	}
+
+	// CSV：每个角色一行
+	const FString Path = CsvPath.IsEmpty()
+		? FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("ZBMemReport_%s.csv"), *FDateTime::Now().ToString())
+		: CsvPath;
+
+	FString Csv = TEXT("Name,Class,IsPlayer,Total,Actor,Components,ASC,ActiveGEs,AbilitySpecs,AbilityInstances,AttributeSets,Tags,Replication,NumActiveGEs,NumAbilitySpecs,NumAbilityInstances\n");
+	for (const FZBCharacterMemory& Entry : Entries)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%d,%d,%d\n"),
+			*Entry.Name, *Entry.ClassName, Entry.bIsPlayer ? 1 : 0,
+			static_cast<uint64>(Entry.GetTotalBytes()), static_cast<uint64>(Entry.ActorBytes),
+			static_cast<uint64>(Entry.ComponentBytes), static_cast<uint64>(Entry.ASCBytes),
+			static_cast<uint64>(Entry.ActiveEffectBytes), static_cast<uint64>(Entry.AbilitySpecBytes),
+			static_cast<uint64>(Entry.AbilityInstanceBytes), static_cast<uint64>(Entry.AttributeSetBytes),
+			static_cast<uint64>(Entry.TagBytes), static_cast<uint64>(Entry.ReplicationBytes),
+			Entry.NumActiveEffects, Entry.NumAbilitySpecs, Entry.NumAbilityInstances);
+	}
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+	if (FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		UE_LOG(LogZBetaBenchmark, Display, TEXT("[ZBMemReport] CSV 已写入：%s"), *Path);
+	}
+	else
+	{
+		UE_LOG(LogZBetaBenchmark, Error, TEXT("[ZBMemReport] CSV 写入失败：%s"), *Path);
+	}
+}
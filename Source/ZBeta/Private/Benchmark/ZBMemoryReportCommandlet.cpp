@@ -0,0 +1,111 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/ZBMemoryReportCommandlet.h"
+
+#include "Benchmark/ZBCombatSoakSubsystem.h"
+#include "Benchmark/ZBMemoryReport.h"
+#include "Characters/ZBEnemyCharacter.h"
+#include "Characters/ZBPlayerCharacter.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "ZBetaLog.h"
+
+namespace ZBMemoryReportCommandlet
+{
+	// 让 BeginPlay 后延迟初始化的东西（默认 GE、初始能力）就位
+	constexpr int32 NumWarmupFrames = 10;
+	constexpr float WarmupDeltaTime = 1.f / 30.f;
+
+	const TCHAR* SoakConfigSection = TEXT("/Script/ZBeta.ZBCombatSoakSubsystem");
+
+	UClass* LoadCharacterClass(const FString& Params, const TCHAR* Key, UClass* BaseClass)
+	{
+		FString ClassPath;
+		if (!FParse::Value(*Params, *FString::Printf(TEXT("%s="), Key), ClassPath))
+		{
+			GConfig->GetString(SoakConfigSection, Key, ClassPath, GGameIni);
+		}
+		if (ClassPath.IsEmpty()) return nullptr;
+
+		UClass* Class = LoadClass<UObject>(nullptr, *ClassPath);
+		if (!Class || !Class->IsChildOf(BaseClass))
+		{
+			UE_LOG(LogZBetaBenchmark, Error, TEXT("[ZBMemReport] %s 无效：%s"), Key, *ClassPath);
+			return nullptr;
+		}
+		return Class;
+	}
+}
+
+UZBMemoryReportCommandlet::UZBMemoryReportCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UZBMemoryReportCommandlet::Main(const FString& Params)
+{
+	using namespace ZBMemoryReportCommandlet;
+
+	int32 NumEnemies = 100;
+	int32 NumPlayers = 4;
+	FString CsvPath;
+	FParse::Value(*Params, TEXT("Enemies="), NumEnemies);
+	FParse::Value(*Params, TEXT("Players="), NumPlayers);
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+
+	UClass* EnemyClass = LoadCharacterClass(Params, TEXT("EnemyClass"), AZBEnemyCharacter::StaticClass());
+	if (!EnemyClass)
+	{
+		EnemyClass = AZBEnemyCharacter::StaticClass();
+	}
+	UClass* PlayerClass = LoadCharacterClass(Params, TEXT("PlayerClass"), AZBPlayerCharacter::StaticClass());
+	if (!PlayerClass && NumPlayers > 0)
+	{
+		UE_LOG(LogZBetaBenchmark, Warning, TEXT("[ZBMemReport] 未配置 PlayerClass，跳过 %d 个玩家"), NumPlayers);
+		NumPlayers = 0;
+	}
+
+	// 空的临时游戏世界
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ZBMemReport"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	for (int32 Index = 0; Index < NumEnemies; ++Index)
+	{
+		World->SpawnActor<AZBEnemyCharacter>(EnemyClass, FVector(Index * 200.f, 0.f, 0.f), FRotator::ZeroRotator, SpawnParams);
+	}
+	for (int32 Index = 0; Index < NumPlayers; ++Index)
+	{
+		AZBSoakBotController* Controller = World->SpawnActor<AZBSoakBotController>(AZBSoakBotController::StaticClass(), SpawnParams);
+		APawn* Player = World->SpawnActor<AZBPlayerCharacter>(PlayerClass, FVector(Index * 200.f, 1000.f, 0.f), FRotator::ZeroRotator, SpawnParams);
+		if (Controller && Player)
+		{
+			Controller->Possess(Player);
+		}
+	}
+
+	for (int32 Frame = 0; Frame < NumWarmupFrames; ++Frame)
+	{
+		World->Tick(LEVELTICK_All, WarmupDeltaTime);
+	}
+
+	const TArray<FZBCharacterMemory> Entries = FZBMemoryReport::Collect(World);
+	FZBMemoryReport::Report(Entries, CsvPath, *GLog);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return Entries.Num() > 0 ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/ZBPerfAbility.h"
+
+void UZBPerfAbility::SetDefaultTagRequirements(const FGameplayTagContainer& RequiredTags, const FGameplayTagContainer& BlockedTags)
+{
+	UZBPerfAbility* DefaultAbility = GetMutableDefault<UZBPerfAbility>();
+	DefaultAbility->ActivationRequiredTags = RequiredTags;
+	DefaultAbility->ActivationBlockedTags = BlockedTags;
+}
@@ -0,0 +1,624 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/ZBPerfRegression.h"
+
+#include "GameplayEffect.h"
+#include "AbilitySystem/ZBAbilitySystemComponent.h"
+#include "AbilitySystem/ZBAttributeSet.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "AbilitySystem/Abilitys/ZBGameplayAbility.h"
+#include "Benchmark/ZBPerfAbility.h"
+#include "Characters/ZBEnemyCharacter.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "ZBetaLog.h"
+
+namespace ZBPerfRegression
+{
+	// 没有单独配置时的默认容差（+15%）
+	constexpr double DefaultTolerance = 0.15;
+	constexpr int32 DefaultSamples = 9;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GZBPerfRunCommand(
+	TEXT("ZB.Perf.Run"),
+	TEXT("运行 ZBeta 性能回归套件。参数：UpdateBaseline 用本次结果覆盖基线；Exit 跑完退出进程（有回归时退出码为 1）"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const bool bUpdateBaseline = Args.ContainsByPredicate([](const FString& Arg) { return Arg.Equals(TEXT("UpdateBaseline"), ESearchCase::IgnoreCase); });
+		const bool bExit = Args.ContainsByPredicate([](const FString& Arg) { return Arg.Equals(TEXT("Exit"), ESearchCase::IgnoreCase); });
+
+		const bool bPassed = FZBPerfRegression::Run(World, bUpdateBaseline);
+		if (bExit)
+		{
+			FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1, TEXT("ZB.Perf.Run"));
+		}
+	}));
+
+
+FString FZBPerfRegression::GetBaselinePath()
+{
+	FString Path;
+	if (FParse::Value(FCommandLine::Get(), TEXT("ZBPerfBaseline="), Path))
+	{
+		return Path;
+	}
+	return FPaths::ProjectConfigDir() / TEXT("Perf") / TEXT("ZBPerfBaseline.json");
+}
+
+FString FZBPerfRegression::GetResultsPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("ZBPerfResults.json");
+}
+
+template <typename FuncType>
+double FZBPerfRegression::MeasureNanosecondsPerOp(int32 Iterations, int32 Samples, FuncType&& Body)
+{
+	// 预热：填充缓存、触发懒初始化
+	for (int32 Index = 0; Index < Iterations; ++Index)
+	{
+		Body();
+	}
+
+	TArray<double> SampleNanoseconds;
+	SampleNanoseconds.Reserve(Samples);
+	for (int32 Sample = 0; Sample < Samples; ++Sample)
+	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			Body();
+		}
+		const uint64 EndCycles = FPlatformTime::Cycles64();
+		SampleNanoseconds.Add(FPlatformTime::ToSeconds64(EndCycles - StartCycles) * 1.0e9 / Iterations);
+	}
+
+	SampleNanoseconds.Sort();
+	return SampleNanoseconds[SampleNanoseconds.Num() / 2];
+}
+
+/**
+ * @brief 运行全部基准并与基线比较
+ *
+ * 详细流程：
+ *   1. 依次运行各项基准，收集每次操作的中位耗时；
+ *   2. 读取基线并逐项比较，超出 (1 + 容差) 倍判定为回归；
+ *   3. 写结果文件；需要时覆盖基线。任何一个文件写入失败都返回 false。
+ */
+bool FZBPerfRegression::Run(UWorld* World, bool bUpdateBaseline)
+{
+	if (!World || !World->HasBegunPlay())
+	{
+		UE_LOG(LogZBetaBenchmark, Error, TEXT("[ZBPerf] 没有可用的世界，请在地图加载完成后运行 ZB.Perf.Run"));
+		return false;
+	}
+
+	TArray<FZBPerfResult> Results;
+	for (const FBenchmarkGroup& Group : GetGroupTable())
+	{
+		Group.Function(*World, Results);
+	}
+
+	const bool bAnyFailed = Results.ContainsByPredicate([](const FZBPerfResult& Result) { return Result.bFailed; });
+	const TSharedPtr<FJsonObject> Baseline = LoadBaseline();
+	const bool bPassed = CompareWithBaseline(Results, Baseline);
+
+	// 结果或基线没写出去时整次运行按失败处理，CI 不会拿着旧文件当作本次结果
+	bool bWritten = WriteResults(GetResultsPath(), Results, Baseline);
+	if (bUpdateBaseline && !bAnyFailed)
+	{
+		if (WriteResults(GetBaselinePath(), Results, Baseline))
+		{
+			UE_LOG(LogZBetaBenchmark, Display, TEXT("[ZBPerf] 已更新基线：%s"), *GetBaselinePath());
+		}
+		else
+		{
+			bWritten = false;
+		}
+	}
+	else if (bUpdateBaseline)
+	{
+		UE_LOG(LogZBetaBenchmark, Error, TEXT("[ZBPerf] 有基准失败，未更新基线"));
+	}
+
+	UE_LOG(LogZBetaBenchmark, Display, TEXT("[ZBPerf] %s"), bPassed ? TEXT("通过") : TEXT("存在性能回归或失败"));
+	return bWritten && (bPassed || (bUpdateBaseline && !bAnyFailed));
+}
+
+TConstArrayView<FZBPerfRegression::FBenchmarkGroup> FZBPerfRegression::GetGroupTable()
+{
+	static const FBenchmarkGroup Groups[] = {
+		{ TEXT("InputDispatch"), &FZBPerfRegression::BenchmarkInputDispatch },
+		{ TEXT("TagQueries"), &FZBPerfRegression::BenchmarkTagQueries },
+		{ TEXT("CanActivate"), &FZBPerfRegression::BenchmarkCanActivate },
+		{ TEXT("ApplyEffect"), &FZBPerfRegression::BenchmarkApplyEffect },
+		{ TEXT("AttributeSerialization"), &FZBPerfRegression::BenchmarkAttributeSerialization },
+		{ TEXT("CharacterSpawn"), &FZBPerfRegression::BenchmarkCharacterSpawn },
+	};
+	return Groups;
+}
+
+TArray<FString> FZBPerfRegression::GetBenchmarkGroups()
+{
+	TArray<FString> Names;
+	for (const FBenchmarkGroup& Group : GetGroupTable())
+	{
+		Names.Add(Group.Name);
+	}
+	return Names;
+}
+
+bool FZBPerfRegression::RunGroup(UWorld& World, const FString& Group, TArray<FZBPerfResult>& OutResults)
+{
+	const FBenchmarkGroup* Found = GetGroupTable().FindByPredicate([&Group](const FBenchmarkGroup& Entry) { return Group.Equals(Entry.Name); });
+	if (!Found)
+	{
+		AddFailure(OutResults, *Group, TEXT("没有这个基准分组"));
+		return false;
+	}
+
+	Found->Function(World, OutResults);
+	return CompareWithBaseline(OutResults, LoadBaseline());
+}
+
+AZBEnemyCharacter* FZBPerfRegression::SpawnCharacter(UWorld& World, const TCHAR* BenchmarkName, TArray<FZBPerfResult>& OutResults)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	AZBEnemyCharacter* Character = World.SpawnActor<AZBEnemyCharacter>(AZBEnemyCharacter::StaticClass(), FTransform::Identity, SpawnParams);
+	if (!Character)
+	{
+		AddFailure(OutResults, BenchmarkName, TEXT("测试角色生成失败"));
+	}
+	return Character;
+}
+
+void FZBPerfRegression::AddFailure(TArray<FZBPerfResult>& OutResults, const TCHAR* BenchmarkName, const TCHAR* Reason)
+{
+	UE_LOG(LogZBetaBenchmark, Error, TEXT("[ZBPerf] %s 未能运行：%s"), BenchmarkName, Reason);
+
+	FZBPerfResult& Result = OutResults.AddDefaulted_GetRef();
+	Result.Name = BenchmarkName;
+	Result.bFailed = true;
+}
+
+/**
+ * @brief 输入分发：UZBAbilitySystemComponent 按输入标签遍历可激活技能
+ * @details 授予 8 个绑定不同 InputTag 的技能，测量一次 按下 + 松开 的遍历开销。
+ */
+void FZBPerfRegression::BenchmarkInputDispatch(UWorld& World, TArray<FZBPerfResult>& OutResults)
+{
+	const TCHAR* BenchmarkName = TEXT("InputDispatch.PressedReleased");
+	AZBEnemyCharacter* Character = SpawnCharacter(World, BenchmarkName, OutResults);
+	if (!Character) return;
+	ON_SCOPE_EXIT { Character->Destroy(); };
+
+	UZBAbilitySystemComponent* ASC = Cast<UZBAbilitySystemComponent>(Character->GetAbilitySystemComponent());
+	if (!ASC)
+	{
+		AddFailure(OutResults, BenchmarkName, TEXT("测试角色没有 UZBAbilitySystemComponent"));
+		return;
+	}
+
+	const FZBGameplayTags& GameplayTags = FZBGameplayTags::Get();
+	const TArray<FGameplayTag> InputTags = {
+		GameplayTags.InputTag_Attack_Main,
+		GameplayTags.InputTag_Dodge,
+		GameplayTags.InputTag_Block,
+		GameplayTags.InputTag_Sprint,
+		GameplayTags.InputTag_Rune_1,
+		GameplayTags.InputTag_Rune_2,
+		GameplayTags.InputTag_Rune_3,
+		GameplayTags.InputTag_Rune_4,
+	};
+	for (const FGameplayTag& InputTag : InputTags)
+	{
+		FGameplayAbilitySpec AbilitySpec(UZBGameplayAbility::StaticClass(), 1);
+		AbilitySpec.GetDynamicSpecSourceTags().AddTag(InputTag);
+		AbilitySpec.GetDynamicSpecSourceTags().AddTag(GameplayTags.Abilities_Status_Equipped);
+		ASC->GiveAbility(AbilitySpec);
+	}
+
+	const FGameplayTag& InputTag = InputTags.Last();
+	FZBPerfResult& Result = OutResults.AddDefaulted_GetRef();
+	Result.Name = BenchmarkName;
+	Result.Iterations = 10000;
+	Result.NanosecondsPerOp = MeasureNanosecondsPerOp(Result.Iterations, ZBPerfRegression::DefaultSamples, [ASC, &InputTag]()
+	{
+		ASC->AbilityInputForTagPressed(InputTag);
+		ASC->AbilityInputForTagReleased(InputTag);
+	});
+}
+
+/**
+ * @brief Tag 查询：原生 Tag 容器匹配、ASC 计数查询、按名字请求 Tag（对照组）
+ */
+void FZBPerfRegression::BenchmarkTagQueries(UWorld& World, TArray<FZBPerfResult>& OutResults)
+{
+	const FZBGameplayTags& GameplayTags = FZBGameplayTags::Get();
+
+	FGameplayTagContainer Container;
+	Container.AddTag(GameplayTags.State_InCombat);
+	Container.AddTag(GameplayTags.State_Attacking);
+	Container.AddTag(GameplayTags.State_CanCancel);
+	Container.AddTag(GameplayTags.State_HyperArmor);
+	Container.AddTag(GameplayTags.State_Movement_Moving);
+	Container.AddTag(GameplayTags.State_Movement_Sprinting);
+	Container.AddTag(GameplayTags.State_Movement_Weight_Light);
+	Container.AddTag(GameplayTags.HitReact_Light);
+
+	int32 MatchCount = 0;
+	{
+		FZBPerfResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Name = TEXT("TagQuery.ContainerHasTag");
+		Result.Iterations = 100000;
+		Result.NanosecondsPerOp = MeasureNanosecondsPerOp(Result.Iterations, ZBPerfRegression::DefaultSamples, [&]()
+		{
+			MatchCount += Container.HasTag(GameplayTags.State_Dead) ? 1 : 0;
+			MatchCount += Container.HasTag(GameplayTags.State) ? 1 : 0;
+		});
+	}
+
+	const TCHAR* ASCBenchmarkName = TEXT("TagQuery.ASCHasMatchingTag");
+	if (AZBEnemyCharacter* Character = SpawnCharacter(World, ASCBenchmarkName, OutResults))
+	{
+		ON_SCOPE_EXIT { Character->Destroy(); };
+
+		UAbilitySystemComponent* ASC = Character->GetAbilitySystemComponent();
+		ASC->AddLooseGameplayTags(Container);
+
+		FZBPerfResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Name = ASCBenchmarkName;
+		Result.Iterations = 100000;
+		Result.NanosecondsPerOp = MeasureNanosecondsPerOp(Result.Iterations, ZBPerfRegression::DefaultSamples, [&]()
+		{
+			MatchCount += ASC->HasMatchingGameplayTag(GameplayTags.State_Dead) ? 1 : 0;
+			MatchCount += ASC->HasMatchingGameplayTag(GameplayTags.State_Attacking) ? 1 : 0;
+		});
+	}
+
+	{
+		const FName TagName = GameplayTags.State_Attacking.GetTagName();
+		FZBPerfResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Name = TEXT("TagQuery.RequestGameplayTag");
+		Result.Iterations = 100000;
+		Result.NanosecondsPerOp = MeasureNanosecondsPerOp(Result.Iterations, ZBPerfRegression::DefaultSamples, [&]()
+		{
+			MatchCount += FGameplayTag::RequestGameplayTag(TagName).IsValid() ? 1 : 0;
+		});
+	}
+
+	// 防止编译器把查询整个优化掉
+	UE_LOG(LogZBetaBenchmark, Verbose, TEXT("[ZBPerf] TagQuery MatchCount = %d"), MatchCount);
+}
+
+/**
+ * @brief 技能激活检查：标签需求的通用检查与掩码快速路径对比，以及完整 CanActivateAbility 的吞吐
+ * @details 需求取典型的近战技能配置：需要 InCombat，被 Dead / Staggered / Attacking 阻止；ASC 上挂 5 个状态标签，检查通过。
+ *          需求写在 UZBPerfAbility 的类默认对象上并授予给角色，测量的是正式技能的同一条路径（实例 -> 类默认对象的掩码）。
+ */
+void FZBPerfRegression::BenchmarkCanActivate(UWorld& World, TArray<FZBPerfResult>& OutResults)
+{
+	const TCHAR* BenchmarkName = TEXT("Ability.CanActivate");
+	AZBEnemyCharacter* Character = SpawnCharacter(World, BenchmarkName, OutResults);
+	if (!Character) return;
+	ON_SCOPE_EXIT { Character->Destroy(); };
+
+	UZBAbilitySystemComponent* ASC = Cast<UZBAbilitySystemComponent>(Character->GetAbilitySystemComponent());
+	if (!ASC || !ASC->AbilityActorInfo.IsValid())
+	{
+		AddFailure(OutResults, BenchmarkName, TEXT("测试角色的 ASC 没有初始化 ActorInfo"));
+		return;
+	}
+
+	const FZBGameplayTags& GameplayTags = FZBGameplayTags::Get();
+	FGameplayTagContainer OwnedTags;
+	OwnedTags.AddTag(GameplayTags.State_InCombat);
+	OwnedTags.AddTag(GameplayTags.State_HyperArmor);
+	OwnedTags.AddTag(GameplayTags.State_Movement_Moving);
+	OwnedTags.AddTag(GameplayTags.State_Movement_Sprinting);
+	OwnedTags.AddTag(GameplayTags.State_Movement_Weight_Light);
+	ASC->AddLooseGameplayTags(OwnedTags);
+
+	FGameplayTagContainer RequiredTags;
+	RequiredTags.AddTag(GameplayTags.State_InCombat);
+	FGameplayTagContainer BlockedTags;
+	BlockedTags.AddTag(GameplayTags.State_Dead);
+	BlockedTags.AddTag(GameplayTags.State_Staggered);
+	BlockedTags.AddTag(GameplayTags.State_Attacking);
+	UZBPerfAbility::SetDefaultTagRequirements(RequiredTags, BlockedTags);
+
+	const FGameplayAbilitySpecHandle Handle = ASC->GiveAbility(FGameplayAbilitySpec(UZBPerfAbility::StaticClass(), 1));
+	const FGameplayAbilitySpec* Spec = ASC->FindAbilitySpecFromHandle(Handle);
+	if (!Spec || !Spec->Ability)
+	{
+		AddFailure(OutResults, BenchmarkName, TEXT("技能授予失败"));
+		return;
+	}
+	// 按实例的技能检查的是实例（取类默认对象的掩码），不实例化的直接是类默认对象
+	const UGameplayAbility* Ability = Spec->GetPrimaryInstance() ? Spec->GetPrimaryInstance() : Spec->Ability.Get();
+	const FGameplayAbilityActorInfo* ActorInfo = ASC->AbilityActorInfo.Get();
+
+	int32 SatisfiedCount = 0;
+	{
+		FZBPerfResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Name = TEXT("Ability.TagRequirements.Generic");
+		Result.Iterations = 100000;
+		Result.NanosecondsPerOp = MeasureNanosecondsPerOp(Result.Iterations, ZBPerfRegression::DefaultSamples, [&]()
+		{
+			SatisfiedCount += Ability->UGameplayAbility::DoesAbilitySatisfyTagRequirements(*ASC) ? 1 : 0;
+		});
+	}
+	{
+		FZBPerfResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Name = TEXT("Ability.TagRequirements.Masked");
+		Result.Iterations = 100000;
+		Result.NanosecondsPerOp = MeasureNanosecondsPerOp(Result.Iterations, ZBPerfRegression::DefaultSamples, [&]()
+		{
+			SatisfiedCount += Ability->DoesAbilitySatisfyTagRequirements(*ASC) ? 1 : 0;
+		});
+	}
+
+	// 完整的 CanActivateAbility（冷却、消耗、输入阻止、标签需求），与按住输入时每帧的尝试相同
+	{
+		FZBPerfResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Name = BenchmarkName;
+		Result.Iterations = 20000;
+		Result.NanosecondsPerOp = MeasureNanosecondsPerOp(Result.Iterations, ZBPerfRegression::DefaultSamples, [&]()
+		{
+			SatisfiedCount += Ability->CanActivateAbility(Handle, ActorInfo) ? 1 : 0;
+		});
+	}
+	ASC->ClearAbility(Handle);
+
+	UE_LOG(LogZBetaBenchmark, Verbose, TEXT("[ZBPerf] CanActivate SatisfiedCount = %d"), SatisfiedCount);
+}
+
+/**
+ * @brief GE 应用：与 AZBCharacterBase::ApplyEffectToSelf 相同的 Context + Spec + Apply 路径
+ * @details 使用临时的瞬时 GE（Health +0），只测 GAS 管线本身。
+ */
+void FZBPerfRegression::BenchmarkApplyEffect(UWorld& World, TArray<FZBPerfResult>& OutResults)
+{
+	const TCHAR* BenchmarkName = TEXT("GameplayEffect.ApplyToSelf");
+	AZBEnemyCharacter* Character = SpawnCharacter(World, BenchmarkName, OutResults);
+	if (!Character) return;
+	ON_SCOPE_EXIT { Character->Destroy(); };
+
+	UAbilitySystemComponent* ASC = Character->GetAbilitySystemComponent();
+	UGameplayEffect* Effect = NewObject<UGameplayEffect>(GetTransientPackage(), TEXT("GE_ZBPerfInstant"), RF_Transient);
+	Effect->DurationPolicy = EGameplayEffectDurationType::Instant;
+	FGameplayModifierInfo& Modifier = Effect->Modifiers.AddDefaulted_GetRef();
+	Modifier.Attribute = UZBAttributeSet::GetHealthAttribute();
+	Modifier.ModifierOp = EGameplayModOp::Additive;
+	Modifier.ModifierMagnitude = FScalableFloat(0.f);
+
+	FZBPerfResult& Result = OutResults.AddDefaulted_GetRef();
+	Result.Name = BenchmarkName;
+	Result.Iterations = 2000;
+	Result.NanosecondsPerOp = MeasureNanosecondsPerOp(Result.Iterations, ZBPerfRegression::DefaultSamples, [ASC, Effect, Character]()
+	{
+		FGameplayEffectContextHandle ContextHandle = ASC->MakeEffectContext();
+		ContextHandle.AddSourceObject(Character);
+		ASC->ApplyGameplayEffectToSelf(Effect, 1.f, ContextHandle);
+	});
+}
+
+/**
+ * @brief 属性复制序列化：把 UZBAttributeSet 全部复制属性的 BaseValue / CurrentValue 写入位流再读回
+ * @details 与 RepLayout 对单个属性的 NetSerializeItem 调用一致，不含属性比较与包头开销。
+ */
+void FZBPerfRegression::BenchmarkAttributeSerialization(UWorld& World, TArray<FZBPerfResult>& OutResults)
+{
+	UZBAttributeSet* Source = NewObject<UZBAttributeSet>(GetTransientPackage());
+	UZBAttributeSet* Target = NewObject<UZBAttributeSet>(GetTransientPackage());
+
+	const FFloatProperty* BaseValueProperty = FindFProperty<FFloatProperty>(FGameplayAttributeData::StaticStruct(), TEXT("BaseValue"));
+	const FFloatProperty* CurrentValueProperty = FindFProperty<FFloatProperty>(FGameplayAttributeData::StaticStruct(), TEXT("CurrentValue"));
+	if (!BaseValueProperty || !CurrentValueProperty)
+	{
+		AddFailure(OutResults, TEXT("AttributeSet.NetSerialize"), TEXT("找不到 FGameplayAttributeData 的值属性"));
+		return;
+	}
+
+	TArray<const FStructProperty*> AttributeProperties;
+	for (TFieldIterator<FStructProperty> It(UZBAttributeSet::StaticClass()); It; ++It)
+	{
+		if (It->HasAnyPropertyFlags(CPF_Net) && It->Struct->IsChildOf(FGameplayAttributeData::StaticStruct()))
+		{
+			AttributeProperties.Add(*It);
+		}
+	}
+
+	FZBPerfResult& Result = OutResults.AddDefaulted_GetRef();
+	Result.Name = FString::Printf(TEXT("AttributeSet.NetSerialize%dAttributes"), AttributeProperties.Num());
+	Result.Iterations = 5000;
+	Result.NanosecondsPerOp = MeasureNanosecondsPerOp(Result.Iterations, ZBPerfRegression::DefaultSamples, [&]()
+	{
+		FBitWriter Writer(AttributeProperties.Num() * 64, true);
+		for (const FStructProperty* Property : AttributeProperties)
+		{
+			void* Data = Property->ContainerPtrToValuePtr<void>(Source);
+			BaseValueProperty->NetSerializeItem(Writer, nullptr, BaseValueProperty->ContainerPtrToValuePtr<void>(Data));
+			CurrentValueProperty->NetSerializeItem(Writer, nullptr, CurrentValueProperty->ContainerPtrToValuePtr<void>(Data));
+		}
+
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		for (const FStructProperty* Property : AttributeProperties)
+		{
+			void* Data = Property->ContainerPtrToValuePtr<void>(Target);
+			BaseValueProperty->NetSerializeItem(Reader, nullptr, BaseValueProperty->ContainerPtrToValuePtr<void>(Data));
+			CurrentValueProperty->NetSerializeItem(Reader, nullptr, CurrentValueProperty->ContainerPtrToValuePtr<void>(Data));
+		}
+	});
+}
+
+/**
+ * @brief 角色生成：生成并销毁 AZBEnemyCharacter（含 ASC / AttributeSet 子对象创建与 BeginPlay）
+ */
+void FZBPerfRegression::BenchmarkCharacterSpawn(UWorld& World, TArray<FZBPerfResult>& OutResults)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	int32 NumSpawnFailures = 0;
+	FZBPerfResult Result;
+	Result.Name = TEXT("Character.SpawnEnemy");
+	Result.Iterations = 50;
+	Result.NanosecondsPerOp = MeasureNanosecondsPerOp(Result.Iterations, 5, [&World, &SpawnParams, &NumSpawnFailures]()
+	{
+		if (AZBEnemyCharacter* Character = World.SpawnActor<AZBEnemyCharacter>(AZBEnemyCharacter::StaticClass(), FTransform::Identity, SpawnParams))
+		{
+			Character->Destroy();
+		}
+		else
+		{
+			++NumSpawnFailures;
+		}
+	});
+
+	// 生成失败的轮次耗时没有意义
+	if (NumSpawnFailures > 0)
+	{
+		AddFailure(OutResults, *Result.Name, *FString::Printf(TEXT("%d 次生成失败"), NumSpawnFailures));
+		return;
+	}
+	OutResults.Add(Result);
+}
+
+TSharedPtr<FJsonObject> FZBPerfRegression::LoadBaseline()
+{
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *GetBaselinePath()))
+	{
+		UE_LOG(LogZBetaBenchmark, Warning, TEXT("[ZBPerf] 未找到基线文件：%s"), *GetBaselinePath());
+		return nullptr;
+	}
+
+	TSharedPtr<FJsonObject> Baseline;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonText), Baseline) || !Baseline.IsValid())
+	{
+		UE_LOG(LogZBetaBenchmark, Error, TEXT("[ZBPerf] 基线文件解析失败：%s"), *GetBaselinePath());
+		return nullptr;
+	}
+	return Baseline;
+}
+
+/**
+ * @brief 逐项与基线比较
+ * @details 基线格式：
+ *          { "DefaultTolerance": 0.15, "Benchmarks": { "<Name>": { "NanosecondsPerOp": 123.4, "Tolerance": 0.2 } } }
+ *          Tolerance 可省略，省略时使用 DefaultTolerance。
+ */
+bool FZBPerfRegression::CompareWithBaseline(const TArray<FZBPerfResult>& Results, const TSharedPtr<FJsonObject>& Baseline)
+{
+	double DefaultTolerance = ZBPerfRegression::DefaultTolerance;
+	const TSharedPtr<FJsonObject>* Benchmarks = nullptr;
+	if (Baseline.IsValid())
+	{
+		Baseline->TryGetNumberField(TEXT("DefaultTolerance"), DefaultTolerance);
+		Baseline->TryGetObjectField(TEXT("Benchmarks"), Benchmarks);
+	}
+
+	bool bPassed = true;
+	for (const FZBPerfResult& Result : Results)
+	{
+		// 失败已在 AddFailure 时记录
+		if (Result.bFailed)
+		{
+			bPassed = false;
+			continue;
+		}
+
+		const TSharedPtr<FJsonObject>* Entry = nullptr;
+		double BaselineNanoseconds = 0.0;
+		if (!Benchmarks || !(*Benchmarks)->TryGetObjectField(Result.Name, Entry) || !(*Entry)->TryGetNumberField(TEXT("NanosecondsPerOp"), BaselineNanoseconds) || BaselineNanoseconds <= 0.0)
+		{
+			UE_LOG(LogZBetaBenchmark, Display, TEXT("[ZBPerf] %-40s %12.1f ns/op  （无基线）"), *Result.Name, Result.NanosecondsPerOp);
+			continue;
+		}
+
+		double Tolerance = DefaultTolerance;
+		(*Entry)->TryGetNumberField(TEXT("Tolerance"), Tolerance);
+
+		const double Ratio = Result.NanosecondsPerOp / BaselineNanoseconds;
+		const bool bRegressed = Ratio > 1.0 + Tolerance;
+		bPassed &= !bRegressed;
+
+		if (bRegressed)
+		{
+			UE_LOG(LogZBetaBenchmark, Error, TEXT("[ZBPerf] %-40s %12.1f ns/op  基线 %.1f  %+.1f%%  超出容差 %.0f%%"),
+				*Result.Name, Result.NanosecondsPerOp, BaselineNanoseconds, (Ratio - 1.0) * 100.0, Tolerance * 100.0);
+		}
+		else
+		{
+			UE_LOG(LogZBetaBenchmark, Display, TEXT("[ZBPerf] %-40s %12.1f ns/op  基线 %.1f  %+.1f%%"),
+				*Result.Name, Result.NanosecondsPerOp, BaselineNanoseconds, (Ratio - 1.0) * 100.0);
+		}
+	}
+	return bPassed;
+}
+
+bool FZBPerfRegression::WriteResults(const FString& Path, const TArray<FZBPerfResult>& Results, const TSharedPtr<FJsonObject>& Baseline)
+{
+	double DefaultTolerance = ZBPerfRegression::DefaultTolerance;
+	const TSharedPtr<FJsonObject>* OldBenchmarks = nullptr;
+	if (Baseline.IsValid())
+	{
+		Baseline->TryGetNumberField(TEXT("DefaultTolerance"), DefaultTolerance);
+		Baseline->TryGetObjectField(TEXT("Benchmarks"), OldBenchmarks);
+	}
+
+	TSharedRef<FJsonObject> Benchmarks = MakeShared<FJsonObject>();
+	for (const FZBPerfResult& Result : Results)
+	{
+		if (Result.bFailed) continue;
+
+		TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+		Entry->SetNumberField(TEXT("NanosecondsPerOp"), FMath::RoundToDouble(Result.NanosecondsPerOp * 10.0) / 10.0);
+		Entry->SetNumberField(TEXT("Iterations"), Result.Iterations);
+
+		// 保留手工调过的单项容差
+		const TSharedPtr<FJsonObject>* OldEntry = nullptr;
+		double Tolerance = 0.0;
+		if (OldBenchmarks && (*OldBenchmarks)->TryGetObjectField(Result.Name, OldEntry) && (*OldEntry)->TryGetNumberField(TEXT("Tolerance"), Tolerance))
+		{
+			Entry->SetNumberField(TEXT("Tolerance"), Tolerance);
+		}
+		Benchmarks->SetObjectField(Result.Name, Entry);
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("Version"), 1);
+	Root->SetNumberField(TEXT("DefaultTolerance"), DefaultTolerance);
+	Root->SetStringField(TEXT("Build"), LexToString(FApp::GetBuildConfiguration()));
+	Root->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+	Root->SetObjectField(TEXT("Benchmarks"), Benchmarks);
+
+	FString JsonText;
+	FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&JsonText));
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+	if (!FFileHelper::SaveStringToFile(JsonText, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogZBetaBenchmark, Error, TEXT("[ZBPerf] JSON 写入失败：%s"), *Path);
+		return false;
+	}
+	return true;
+}
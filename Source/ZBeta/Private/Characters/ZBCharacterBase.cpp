@@ -6,7 +6,44 @@
 #include "AbilitySystem/ZBAbilitySystemComponent.h"
 #include "AbilitySystem/ZBAttributeSet.h"
 #include "AbilitySystem/ZBGameplayTags.h"
+#include "Asset/ZBAssetManager.h"
+#include "Combat/ZBMeleeWeaponComponent.h"
+#include "Combat/ZBTargetLockSubsystem.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Misc/PackageName.h"
+#include "Net/ZBLagCompensationSubsystem.h"
+#include "UObject/ObjectSaveContext.h"
+#include "ZBetaLog.h"
+#include "ZBetaStats.h"
+
+namespace ZBCharacterLoadout
+{
+	// 已流送时直接返回；否则同步加载兜底（说明生成前没有走 UZBAssetManager::LoadCharacterLoadout）
+	template <typename T>
+	TSubclassOf<T> ResolveClass(const TSoftClassPtr<T>& SoftClass, const AActor* Owner)
+	{
+		if (SoftClass.IsNull()) return nullptr;
+		if (UClass* LoadedClass = SoftClass.Get()) return LoadedClass;
+
+		UE_LOG(LogZBetaAsset, Log, TEXT("%s 的 %s 未预先流送，同步加载"), *GetNameSafe(Owner), *SoftClass.ToString());
+		return SoftClass.LoadSynchronous();
+	}
+
+	template <typename T>
+	TArray<TSubclassOf<T>> ResolveClasses(const TArray<TSoftClassPtr<T>>& SoftClasses, const AActor* Owner)
+	{
+		TArray<TSubclassOf<T>> Classes;
+		Classes.Reserve(SoftClasses.Num());
+		for (const TSoftClassPtr<T>& SoftClass : SoftClasses)
+		{
+			if (TSubclassOf<T> LoadedClass = ResolveClass(SoftClass, Owner))
+			{
+				Classes.Add(LoadedClass);
+			}
+		}
+		return Classes;
+	}
+}
 
 
 AZBCharacterBase::AZBCharacterBase()
@@ -21,7 +58,44 @@ AZBCharacterBase::AZBCharacterBase()
 void AZBCharacterBase::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// 登记存活实例，最后一个实例结束后 Loadout 才可能被释放
+	UZBAssetManager::Get().AddLoadoutUser(*this);
+
+	// 服务器记录受击历史，供延迟补偿回溯
+	if (HasAuthority())
+	{
+		if (UZBLagCompensationSubsystem* LagCompensation = UWorld::GetSubsystem<UZBLagCompensationSubsystem>(GetWorld()))
+		{
+			LagCompensation->RegisterCharacter(this);
+		}
+	}
+
+	if (bTargetLockable)
+	{
+		if (UZBTargetLockSubsystem* TargetLock = UWorld::GetSubsystem<UZBTargetLockSubsystem>(GetWorld()))
+		{
+			TargetLock->RegisterLockable(this);
+		}
+	}
+}
+
+void AZBCharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UZBLagCompensationSubsystem* LagCompensation = UWorld::GetSubsystem<UZBLagCompensationSubsystem>(GetWorld()))
+	{
+		LagCompensation->UnregisterCharacter(this);
+	}
+	if (UZBTargetLockSubsystem* TargetLock = UWorld::GetSubsystem<UZBTargetLockSubsystem>(GetWorld()))
+	{
+		TargetLock->UnregisterLockable(this);
+	}
+	if (UAssetManager::IsInitialized())
+	{
+		UZBAssetManager::Get().RemoveLoadoutUser(*this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AZBCharacterBase::InitAbilityActorInfo()
@@ -29,23 +103,47 @@ void AZBCharacterBase::InitAbilityActorInfo()
 	
 }
 
+FPrimaryAssetId AZBCharacterBase::GetPrimaryAssetId() const
+{
+	// 只有蓝图类的 CDO 是主资源，场景里的实例和原生类都不是
+	if (HasAnyFlags(RF_ClassDefaultObject) && !GetClass()->HasAnyClassFlags(CLASS_Native))
+	{
+		return FPrimaryAssetId(UZBAssetManager::CharacterLoadoutType, FPackageName::GetShortFName(GetOutermost()->GetFName()));
+	}
+	return Super::GetPrimaryAssetId();
+}
+
+#if WITH_EDITOR
+void AZBCharacterBase::PreSave(FObjectPreSaveContext SaveContext)
+{
+	Super::PreSave(SaveContext);
+
+	// 与 UPrimaryDataAsset 相同：保存 CDO 时按 AssetBundles 元数据重建 Bundle 数据
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		if (UAssetManager* AssetManager = UAssetManager::GetIfInitialized())
+		{
+			AssetBundleData.Reset();
+			AssetManager->InitializeAssetBundlesFromMetadata(this, AssetBundleData);
+		}
+	}
+}
+#endif
+
 void AZBCharacterBase::InitializeDefaultAttributes()
 {
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_InitializeDefaultAttributes);
 	check(IsValid(GetAbilitySystemComponent()));
-	check(DefaultPrimaryAttributes);
-	check(DefaultDerivedAttributes);
+	check(!DefaultPrimaryAttributes.IsNull());
+	check(!DefaultDerivedAttributes.IsNull());
 	BindAttributeChangeDelegates();
 	
-	ApplyEffectToSelf(DefaultPrimaryAttributes,1.f);
-	ApplyEffectToSelf(DefaultDerivedAttributes,1.f);
+	ApplyEffectToSelf(ZBCharacterLoadout::ResolveClass(DefaultPrimaryAttributes, this),1.f);
+	ApplyEffectToSelf(ZBCharacterLoadout::ResolveClass(DefaultDerivedAttributes, this),1.f);
 	
-	for (const TSubclassOf<UGameplayEffect>& EffectClass : AttributesEffects)
+	for (const TSubclassOf<UGameplayEffect>& EffectClass : ZBCharacterLoadout::ResolveClasses(AttributesEffects, this))
 	{
-		if (EffectClass)
-		{
-			ApplyEffectToSelf(EffectClass,1.f);
-		}
-		
+		ApplyEffectToSelf(EffectClass,1.f);
 	}
 	
 
@@ -82,6 +180,7 @@ void AZBCharacterBase::InitializeDefaultAttributes()
 
 void AZBCharacterBase::ApplyEffectToSelf(TSubclassOf<UGameplayEffect> GamePlayEffectClass, float Level)
 {
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_ApplyEffectToSelf);
 	// 检查 AbilitySystemComponent 是否有效，防止空指针崩溃
 	check(IsValid(GetAbilitySystemComponent()));
 	// 检查 GameplayEffect 类是否有效
@@ -151,14 +250,27 @@ void AZBCharacterBase::AddCharacterAbilities()
 {
 	UZBAbilitySystemComponent* ZBASC = CastChecked<UZBAbilitySystemComponent>(AbilitySystemComponent);
 	if (!HasAuthority()) return;
-	ZBASC->AddCharacterAbilities(StartupAbilities);
-	ZBASC->AddCharacterPassiveAbilities(StartupPassiveAbilities);
+	ZBASC->AddCharacterAbilities(ZBCharacterLoadout::ResolveClasses(StartupAbilities, this));
+	ZBASC->AddCharacterPassiveAbilities(ZBCharacterLoadout::ResolveClasses(StartupPassiveAbilities, this));
+}
+
+void AZBCharacterBase::BindMeleeWeapons()
+{
+	// 服务器判定，拥有者客户端预测（见 UZBMeleeWeaponComponent::BindAbilitySystem）
+	if (!AbilitySystemComponent) return;
+
+	TInlineComponentArray<UZBMeleeWeaponComponent*> Weapons(this);
+	for (UZBMeleeWeaponComponent* Weapon : Weapons)
+	{
+		Weapon->BindAbilitySystem(AbilitySystemComponent);
+	}
 }
 
 
 void AZBCharacterBase::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_CharacterTick);
 	// -------------------------------------------------------------------------
 	//  移动状态同步 (Velocity -> GameplayTag)
 	// -------------------------------------------------------------------------
@@ -170,12 +282,12 @@ void AZBCharacterBase::Tick(float DeltaTime)
 		// 1.1 检查 Tag 是否有效
 		if (!MovingTag.IsValid())
 		{
-			UE_LOG(LogTemp, Error, TEXT("错误：State_Movement_Moving 未注册！请检查 ZBGameplayTags.cpp"));
+			ZB_LOG_HOT(LogZBetaCharacter, Error, TEXT("错误：State_Movement_Moving 未注册！请检查 ZBGameplayTags.cpp"));
 			return;
 		}
 		if (!IdleTag.IsValid())
 		{
-			UE_LOG(LogTemp, Error, TEXT("错误：State_Movement_Idle 未注册！请检查 ZBGameplayTags.cpp"));
+			ZB_LOG_HOT(LogZBetaCharacter, Error, TEXT("错误：State_Movement_Idle 未注册！请检查 ZBGameplayTags.cpp"));
 			return;
 		}
 		// 2. 获取速度平方 (只看水平移动)
@@ -192,12 +304,12 @@ void AZBCharacterBase::Tick(float DeltaTime)
 		{
 			AbilitySystemComponent->RemoveLooseGameplayTag(IdleTag);
 			AbilitySystemComponent->AddLooseGameplayTag(MovingTag);
-			UE_LOG(LogTemp, Display, TEXT("结束待机,移动中······"));
+			ZB_LOG_HOT(LogZBetaCharacter, Verbose, TEXT("{0} 结束待机,移动中······"), this);
 		}else if (!bIsMoving && bHasTag)
 		{
 			AbilitySystemComponent->RemoveLooseGameplayTag(MovingTag);
 			AbilitySystemComponent->AddLooseGameplayTag(IdleTag);
-			UE_LOG(LogTemp, Display, TEXT("结束移动,待机中······"));
+			ZB_LOG_HOT(LogZBetaCharacter, Verbose, TEXT("{0} 结束移动,待机中······"), this);
 		}
 	}
 }
@@ -3,18 +3,37 @@
 
 #include "Characters/ZBEnemyCharacter.h"
 
+#include "TimerManager.h"
 #include "AbilitySystem/ZBGameplayTags.h"
 #include "AbilitySystem/ZBAbilitySystemComponent.h"
+#include "AbilitySystem/ZBAttributeSet.h"
+#include "Abilities/GameplayAbility.h"
+#include "GameFramework/PlayerController.h"
+#include "Net/UnrealNetwork.h"
 
 
 AZBEnemyCharacter::AZBEnemyCharacter()
 {
 	 
 	PrimaryActorTick.bCanEverTick = true;
-	AbilitySystemComponent = CreateDefaultSubobject<UZBAbilitySystemComponent>("AbilitySystemComponent");
-	AbilitySystemComponent->SetIsReplicated(true);
-	AbilitySystemComponent->SetReplicationMode(EGameplayEffectReplicationMode::Minimal);
-	AttributeSet = CreateDefaultSubobject<UAttributeSet>("AttributeSet");
+	UZBAbilitySystemComponent* ZBAbilitySystemComponent = CreateDefaultSubobject<UZBAbilitySystemComponent>("AbilitySystemComponent");
+	ZBAbilitySystemComponent->SetIsReplicated(true);
+	ZBAbilitySystemComponent->SetReplicationMode(EGameplayEffectReplicationMode::Minimal);
+	//可见标签走 CombatProxy 的 VisibleTagMask，不再重复复制 ASC 的标签计数表
+	ZBAbilitySystemComponent->SetReplicateTagMap(false);
+	AbilitySystemComponent = ZBAbilitySystemComponent;
+	AttributeSet = CreateDefaultSubobject<UZBAttributeSet>("AttributeSet");
+	//默认唤醒，由 UpdateNetDormancy 决定何时休眠
+	NetDormancy = DORM_Awake;
+	//使用注册子对象列表，便于把 AttributeSet 从复制中摘掉，只复制 CombatProxy
+	bReplicateUsingRegisteredSubObjectList = true;
+	bTargetLockable = true;
+}
+
+void AZBEnemyCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(AZBEnemyCharacter, CombatProxy);
 }
 
 void AZBEnemyCharacter::PossessedBy(AController* NewController)
@@ -30,6 +49,20 @@ void AZBEnemyCharacter::BeginPlay()
 	if (HasAuthority())
 	{
 		//TODO 初始化能力
+
+		// 完整属性只留在服务器，客户端只拿 CombatProxy
+		if (!bReplicateFullAttributeSet && AttributeSet)
+		{
+			AbilitySystemComponent->RemoveReplicatedSubObject(AttributeSet);
+		}
+		BindCombatProxyDelegates();
+
+		if (bAutoNetDormancy)
+		{
+			BindNetDormancyDelegates();
+			LastNetActivityTime = GetWorld()->GetTimeSeconds();
+			GetWorldTimerManager().SetTimer(NetDormancyTimerHandle, this, &AZBEnemyCharacter::UpdateNetDormancy, DormancyCheckInterval, true);
+		}
 	}
 	
 }
@@ -37,10 +70,239 @@ void AZBEnemyCharacter::BeginPlay()
 void AZBEnemyCharacter::InitAbilityActorInfo()
 {
 	Super::InitAbilityActorInfo();
+	BindMeleeWeapons();
 	
 }
 
 
+/**
+ * @brief 服务器端绑定战斗代理的数据源
+ *
+ * 详细流程：
+ *   1. Health / MaxHealth / Toughness / MaxToughness 变化 -> 重新量化比例；
+ *   2. 可见标签表中每个标签的增删 -> 更新对应位；
+ *   3. 技能激活 -> 在技能提示表中查找技能标签，写入 ID 并递增序号；
+ *   4. 技能结束 -> 若当前提示仍是这个技能则清零，之后首次同步 / 休眠唤醒的客户端不会重放过期的提示；
+ */
+void AZBEnemyCharacter::BindCombatProxyDelegates()
+{
+	const UZBAttributeSet* ZBAttributeSet = Cast<UZBAttributeSet>(AttributeSet);
+	if (!AbilitySystemComponent || !ZBAttributeSet) return;
+
+	for (const FGameplayAttribute& Attribute : {
+		ZBAttributeSet->GetHealthAttribute(), ZBAttributeSet->GetMaxHealthAttribute(),
+		ZBAttributeSet->GetToughnessAttribute(), ZBAttributeSet->GetMaxToughnessAttribute() })
+	{
+		AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(Attribute).AddUObject(this, &AZBEnemyCharacter::OnCombatProxyAttributeChanged);
+	}
+
+	for (const FGameplayTag& Tag : FZBEnemyCombatProxy::GetVisibleTagTable())
+	{
+		AbilitySystemComponent->RegisterGameplayTagEvent(Tag, EGameplayTagEventType::NewOrRemoved).AddUObject(this, &AZBEnemyCharacter::OnCombatProxyTagChanged);
+	}
+
+	AbilitySystemComponent->AbilityActivatedCallbacks.AddUObject(this, &AZBEnemyCharacter::OnCombatProxyAbilityActivated);
+	AbilitySystemComponent->AbilityEndedCallbacks.AddUObject(this, &AZBEnemyCharacter::OnCombatProxyAbilityEnded);
+
+	// 以当前数值初始化一次
+	RefreshCombatProxyRatios();
+}
+
+void AZBEnemyCharacter::OnCombatProxyAttributeChanged(const FOnAttributeChangeData& Data)
+{
+	RefreshCombatProxyRatios();
+}
+
+void AZBEnemyCharacter::RefreshCombatProxyRatios()
+{
+	const UZBAttributeSet* ZBAttributeSet = Cast<UZBAttributeSet>(AttributeSet);
+	if (!ZBAttributeSet) return;
+
+	FZBEnemyCombatProxy NewProxy = CombatProxy;
+	const float MaxHealth = ZBAttributeSet->GetMaxHealth();
+	const float MaxToughness = ZBAttributeSet->GetMaxToughness();
+	NewProxy.HealthRatio = FZBEnemyCombatProxy::QuantizeRatio(MaxHealth > 0.f ? ZBAttributeSet->GetHealth() / MaxHealth : 1.f);
+	NewProxy.ToughnessRatio = FZBEnemyCombatProxy::QuantizeRatio(MaxToughness > 0.f ? ZBAttributeSet->GetToughness() / MaxToughness : 1.f);
+	SetCombatProxy(NewProxy);
+}
+
+void AZBEnemyCharacter::OnCombatProxyTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	const int32 Bit = FZBEnemyCombatProxy::GetVisibleTagBit(Tag);
+	if (Bit == INDEX_NONE) return;
+
+	FZBEnemyCombatProxy NewProxy = CombatProxy;
+	if (NewCount > 0)
+	{
+		NewProxy.VisibleTagMask |= (1u << Bit);
+	}
+	else
+	{
+		NewProxy.VisibleTagMask &= ~(1u << Bit);
+	}
+	SetCombatProxy(NewProxy);
+}
+
+void AZBEnemyCharacter::OnCombatProxyAbilityActivated(UGameplayAbility* Ability)
+{
+	const uint8 CueId = FindAbilityCueId(Ability);
+	if (CueId == 0) return;
+
+	FZBEnemyCombatProxy NewProxy = CombatProxy;
+	NewProxy.AbilityCueId = CueId;
+	NewProxy.AbilityCueSequence = (CombatProxy.AbilityCueSequence + 1) & 0xF;
+	SetCombatProxy(NewProxy);
+}
+
+void AZBEnemyCharacter::OnCombatProxyAbilityEnded(UGameplayAbility* Ability)
+{
+	// 只清除自己的提示：技能 A 结束时若 B 已经接着激活，保留 B
+	const uint8 CueId = FindAbilityCueId(Ability);
+	if (CueId == 0 || CueId != CombatProxy.AbilityCueId) return;
+
+	FZBEnemyCombatProxy NewProxy = CombatProxy;
+	NewProxy.AbilityCueId = 0;
+	SetCombatProxy(NewProxy);
+}
+
+uint8 AZBEnemyCharacter::FindAbilityCueId(const UGameplayAbility* Ability)
+{
+	if (!Ability) return 0;
+
+	const TArray<FGameplayTag>& CueTable = FZBEnemyCombatProxy::GetAbilityCueTable();
+	for (int32 Index = 0; Index < CueTable.Num(); ++Index)
+	{
+		if (Ability->GetAssetTags().HasTag(CueTable[Index]))
+		{
+			return static_cast<uint8>(Index + 1);
+		}
+	}
+	return 0;
+}
+
+void AZBEnemyCharacter::SetCombatProxy(const FZBEnemyCombatProxy& NewProxy)
+{
+	if (NewProxy == CombatProxy) return;
+
+	const FZBEnemyCombatProxy OldProxy = CombatProxy;
+	CombatProxy = NewProxy;
+	// 服务器（含 Listen Server 本地显示）不会走 OnRep，这里手动广播
+	OnCombatProxyChanged.Broadcast(CombatProxy, OldProxy);
+}
+
+void AZBEnemyCharacter::OnRep_CombatProxy(const FZBEnemyCombatProxy& OldProxy)
+{
+	// 标签计数表不复制，把可见标签的变化镜像成本地 Loose Tag，客户端上的 HasMatchingGameplayTag 查询照常可用
+	const uint32 ChangedMask = CombatProxy.VisibleTagMask ^ OldProxy.VisibleTagMask;
+	if (ChangedMask != 0 && AbilitySystemComponent)
+	{
+		const TArray<FGameplayTag>& TagTable = FZBEnemyCombatProxy::GetVisibleTagTable();
+		for (int32 Bit = 0; Bit < TagTable.Num(); ++Bit)
+		{
+			if (ChangedMask & (1u << Bit))
+			{
+				AbilitySystemComponent->SetLooseGameplayTagCount(TagTable[Bit], (CombatProxy.VisibleTagMask >> Bit) & 1u);
+			}
+		}
+	}
+	OnCombatProxyChanged.Broadcast(CombatProxy, OldProxy);
+}
+
+void AZBEnemyCharacter::WakeFromNetDormancy()
+{
+	if (!HasAuthority()) return;
+
+	LastNetActivityTime = GetWorld()->GetTimeSeconds();
+	if (NetDormancy > DORM_Awake)
+	{
+		// 从休眠切回唤醒会冲刷休眠状态，休眠期间的属性变化在下一次网络更新中发出
+		SetNetDormancy(DORM_Awake);
+	}
+}
+
+/**
+ * @brief 绑定 ASC 的 Tag / 属性变化委托
+ *
+ * 详细流程：
+ *   1. 任意 Tag 增删（含受击、进入战斗、移动状态切换）-> 唤醒；
+ *   2. AttributeSet 中每个属性的数值变化（含伤害、回复）-> 唤醒；
+ *
+ * 注意事项：
+ *   - 属性变化回调发生在数值写入之后，唤醒后引擎会把与上次发送状态的差异补发，不会丢失。
+ */
+void AZBEnemyCharacter::BindNetDormancyDelegates()
+{
+	if (!AbilitySystemComponent) return;
+
+	AbilitySystemComponent->RegisterGenericGameplayTagEvent().AddUObject(this, &AZBEnemyCharacter::OnDormancyTagChanged);
+
+	if (AttributeSet)
+	{
+		TArray<FGameplayAttribute> Attributes;
+		UAttributeSet::GetAttributesFromSetClass(AttributeSet->GetClass(), Attributes);
+		for (const FGameplayAttribute& Attribute : Attributes)
+		{
+			AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(Attribute).AddUObject(this, &AZBEnemyCharacter::OnDormancyAttributeChanged);
+		}
+	}
+}
+
+void AZBEnemyCharacter::OnDormancyTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	WakeFromNetDormancy();
+}
+
+void AZBEnemyCharacter::OnDormancyAttributeChanged(const FOnAttributeChangeData& Data)
+{
+	WakeFromNetDormancy();
+}
+
+/**
+ * @brief 周期性判断是否进入网络休眠
+ *
+ * 详细流程：
+ *   1. 战斗中 / 正在移动 / 玩家在唤醒半径内：保持唤醒并刷新活动时间；
+ *   2. 死亡的敌人不受玩家距离影响，空闲延迟后直接休眠；
+ *   3. 距最后一次活动超过 DormancyIdleDelay：进入 DORM_DormantAll。
+ */
+void AZBEnemyCharacter::UpdateNetDormancy()
+{
+	if (!AbilitySystemComponent) return;
+
+	const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+	const bool bDead = AbilitySystemComponent->HasMatchingGameplayTag(Tags.State_Dead);
+	const bool bInCombat = AbilitySystemComponent->HasMatchingGameplayTag(Tags.State_InCombat);
+	const bool bMoving = GetVelocity().SizeSquared() > 1.f;
+
+	if (!bDead && (bInCombat || bMoving || IsAnyPlayerWithinWakeRadius()))
+	{
+		WakeFromNetDormancy();
+		return;
+	}
+
+	if (NetDormancy == DORM_Awake && GetWorld()->GetTimeSeconds() - LastNetActivityTime >= DormancyIdleDelay)
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+bool AZBEnemyCharacter::IsAnyPlayerWithinWakeRadius() const
+{
+	const FVector Location = GetActorLocation();
+	const float WakeRadiusSquared = DormancyWakeRadius * DormancyWakeRadius;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		const APawn* PlayerPawn = PC ? PC->GetPawn() : nullptr;
+		if (PlayerPawn && FVector::DistSquared(PlayerPawn->GetActorLocation(), Location) <= WakeRadiusSquared)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
 void AZBEnemyCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
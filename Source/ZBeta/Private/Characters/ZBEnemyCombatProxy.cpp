@@ -0,0 +1,123 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/ZBEnemyCombatProxy.h"
+
+#include "AbilitySystem/ZBGameplayTags.h"
+
+
+uint8 FZBEnemyCombatProxy::QuantizeRatio(float Ratio)
+{
+	return static_cast<uint8>(FMath::RoundToInt(FMath::Clamp(Ratio, 0.f, 1.f) * 255.f));
+}
+
+bool FZBEnemyCombatProxy::HasVisibleTag(const FGameplayTag& Tag) const
+{
+	const int32 Bit = GetVisibleTagBit(Tag);
+	return Bit != INDEX_NONE && (VisibleTagMask & (1u << Bit)) != 0;
+}
+
+FGameplayTagContainer FZBEnemyCombatProxy::GetVisibleTags() const
+{
+	FGameplayTagContainer Result;
+	const TArray<FGameplayTag>& Table = GetVisibleTagTable();
+	for (int32 Bit = 0; Bit < Table.Num(); ++Bit)
+	{
+		if (VisibleTagMask & (1u << Bit))
+		{
+			Result.AddTag(Table[Bit]);
+		}
+	}
+	return Result;
+}
+
+FGameplayTag FZBEnemyCombatProxy::GetAbilityCueTag() const
+{
+	const TArray<FGameplayTag>& Table = GetAbilityCueTable();
+	return Table.IsValidIndex(AbilityCueId - 1) ? Table[AbilityCueId - 1] : FGameplayTag();
+}
+
+/**
+ * @brief 可见标签表（位顺序）
+ * @note  首次调用时从 FZBGameplayTags 构建，必须在 InitializeNativeTags 之后调用。
+ *        只能在末尾追加，且总数不超过 32。
+ */
+const TArray<FGameplayTag>& FZBEnemyCombatProxy::GetVisibleTagTable()
+{
+	static const TArray<FGameplayTag> Table = []()
+	{
+		const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+		TArray<FGameplayTag> Result = {
+			// State.*
+			Tags.State_IFrame,
+			Tags.State_HyperArmor,
+			Tags.State_Blocking,
+			Tags.State_Staggered,
+			Tags.State_GuardBroken,
+			Tags.State_CanCancel,
+			Tags.State_HitWindowActive,
+			Tags.State_ParryWindowActive,
+			Tags.State_Attacking,
+			Tags.State_Dodging,
+			Tags.State_Dead,
+			Tags.State_InCombat,
+			Tags.State_Executability,
+			// HitReact.*
+			Tags.HitReact_Light,
+			Tags.HitReact_Medium,
+			Tags.HitReact_Heavy,
+			Tags.HitReact_Knockback,
+			Tags.HitReact_Knockdown,
+		};
+		check(Result.Num() <= 32);
+		return Result;
+	}();
+	return Table;
+}
+
+const TArray<FGameplayTag>& FZBEnemyCombatProxy::GetAbilityCueTable()
+{
+	static const TArray<FGameplayTag> Table = []()
+	{
+		const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+		return TArray<FGameplayTag>{
+			Tags.Ability_Attack_Light,
+			Tags.Ability_Attack_Heavy,
+			Tags.Ability_Dodge,
+			Tags.Ability_Block,
+			Tags.Ability_Parry,
+			Tags.Ability_Rune,
+		};
+	}();
+	return Table;
+}
+
+int32 FZBEnemyCombatProxy::GetVisibleTagBit(const FGameplayTag& Tag)
+{
+	return GetVisibleTagTable().IndexOfByKey(Tag);
+}
+
+bool FZBEnemyCombatProxy::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << HealthRatio;
+	Ar << ToughnessRatio;
+
+	// 只发送表长度那么多位
+	const uint32 NumTagBits = GetVisibleTagTable().Num();
+	Ar.SerializeBits(&VisibleTagMask, NumTagBits);
+	if (Ar.IsLoading() && NumTagBits < 32)
+	{
+		VisibleTagMask &= (1u << NumTagBits) - 1;
+	}
+
+	uint32 CueId = AbilityCueId;
+	Ar.SerializeIntPacked(CueId);
+	AbilityCueId = static_cast<uint8>(CueId);
+
+	uint8 Sequence = AbilityCueSequence & 0xF;
+	Ar.SerializeBits(&Sequence, 4);
+	AbilityCueSequence = Sequence & 0xF;
+
+	bOutSuccess = true;
+	return true;
+}
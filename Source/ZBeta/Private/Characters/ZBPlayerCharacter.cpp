@@ -15,6 +15,9 @@ AZBPlayerCharacter::AZBPlayerCharacter()
 {
 	
 	PrimaryActorTick.bCanEverTick = true;
+
+	// 所有目标都创建相机和弹簧臂，保证子对象布局一致（蓝图覆盖的属性在服务器上也能正常反序列化）；
+	// 专用服务器没有视口，在 BeginPlay 里停掉它们的 Tick
 	SpringArmComponent = CreateDefaultSubobject<USpringArmComponent>("SpringArmComponent");
 	SpringArmComponent->SetupAttachment(GetRootComponent());
 	SpringArmComponent->TargetArmLength = 1500.0;
@@ -99,7 +102,13 @@ void AZBPlayerCharacter::OnRep_PlayerState()
 void AZBPlayerCharacter::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// 专用服务器：弹簧臂每帧的相机位置计算没人用
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		SpringArmComponent->SetComponentTickEnabled(false);
+		TopDownCameraComponent->Deactivate();
+	}
 }
 
 
@@ -135,6 +144,7 @@ void AZBPlayerCharacter::InitAbilityActorInfo()
 	AttributeSet = ZBPlayerState->GetAttributeSet();
 	InitializeDefaultAttributes();
 	AddCharacterAbilities();
+	BindMeleeWeapons();
 }
 
 
@@ -0,0 +1,131 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ZBCombatResolutionSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/ZBAttributeSet.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "Engine/World.h"
+#include "ZBetaStats.h"
+
+bool UZBCombatResolutionSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// 纯客户端不结算
+	return Super::ShouldCreateSubsystem(Outer) && !IsRunningClientOnly();
+}
+
+bool UZBCombatResolutionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UZBCombatResolutionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// 一个 GE 同时携带三种返还，数值走 SetByCaller
+	const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+	ReturnsEffect = NewObject<UGameplayEffect>(this, TEXT("GE_ZBCombatReturns"), RF_Transient);
+	ReturnsEffect->DurationPolicy = EGameplayEffectDurationType::Instant;
+	const TPair<FGameplayAttribute, FGameplayTag> ReturnModifiers[] = {
+		{ UZBAttributeSet::GetHealthAttribute(), Tags.Attributes_Vital_Health },
+		{ UZBAttributeSet::GetManaAttribute(), Tags.Attributes_Vital_Mana },
+		{ UZBAttributeSet::GetStaminaAttribute(), Tags.Attributes_Vital_Stamina },
+	};
+	for (const TPair<FGameplayAttribute, FGameplayTag>& ReturnModifier : ReturnModifiers)
+	{
+		FSetByCallerFloat SetByCaller;
+		SetByCaller.DataTag = ReturnModifier.Value;
+
+		FGameplayModifierInfo& Modifier = ReturnsEffect->Modifiers.AddDefaulted_GetRef();
+		Modifier.Attribute = ReturnModifier.Key;
+		Modifier.ModifierOp = EGameplayModOp::Additive;
+		Modifier.ModifierMagnitude = FGameplayEffectModifierMagnitude(SetByCaller);
+	}
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UZBCombatResolutionSubsystem::OnWorldPostActorTick);
+}
+
+void UZBCombatResolutionSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PendingReturns.Reset();
+	ReturnIndexByAttacker.Reset();
+
+	Super::Deinitialize();
+}
+
+void UZBCombatResolutionSubsystem::QueueReturns(UAbilitySystemComponent* Attacker, float Health, float Mana, float Stamina)
+{
+	if (!Attacker || (Health <= 0.f && Mana <= 0.f && Stamina <= 0.f)) return;
+
+	INC_DWORD_STAT(STAT_ZBeta_CombatReturnsQueued);
+
+	int32& Index = ReturnIndexByAttacker.FindOrAdd(Attacker, INDEX_NONE);
+	if (Index == INDEX_NONE)
+	{
+		Index = PendingReturns.AddDefaulted();
+		PendingReturns[Index].Attacker = Attacker;
+		PendingReturns[Index].OrderKey = GetOrderKey(Attacker);
+	}
+
+	FPendingReturn& Return = PendingReturns[Index];
+	Return.Health += FMath::Max(Health, 0.f);
+	Return.Mana += FMath::Max(Mana, 0.f);
+	Return.Stamina += FMath::Max(Stamina, 0.f);
+}
+
+void UZBCombatResolutionSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		Flush();
+	}
+}
+
+void UZBCombatResolutionSubsystem::Flush()
+{
+	if (PendingReturns.IsEmpty()) return;
+
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_CombatResolutionFlush);
+
+	// 先把队列换出来，施加过程中新入队的留到下一帧
+	TArray<FPendingReturn> Returns = MoveTemp(PendingReturns);
+	PendingReturns.Reset();
+	ReturnIndexByAttacker.Reset();
+
+	ApplyReturns(Returns);
+}
+
+void UZBCombatResolutionSubsystem::ApplyReturns(TArray<FPendingReturn>& Returns) const
+{
+	// 入队顺序取决于命中顺序，这里再按名字稳定排序，保证施加顺序与对象地址无关
+	Returns.StableSort([](const FPendingReturn& A, const FPendingReturn& B)
+	{
+		return A.OrderKey < B.OrderKey;
+	});
+
+	const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+	for (const FPendingReturn& Return : Returns)
+	{
+		UAbilitySystemComponent* Attacker = Return.Attacker.Get();
+		if (!Attacker) continue;
+
+		FGameplayEffectSpec Spec(ReturnsEffect, Attacker->MakeEffectContext(), 1.f);
+		Spec.SetSetByCallerMagnitude(Tags.Attributes_Vital_Health, Return.Health);
+		Spec.SetSetByCallerMagnitude(Tags.Attributes_Vital_Mana, Return.Mana);
+		Spec.SetSetByCallerMagnitude(Tags.Attributes_Vital_Stamina, Return.Stamina);
+		Attacker->ApplyGameplayEffectSpecToSelf(Spec);
+
+		INC_DWORD_STAT(STAT_ZBeta_CombatReturnsApplied);
+	}
+}
+
+FString UZBCombatResolutionSubsystem::GetOrderKey(const UAbilitySystemComponent* AbilitySystemComponent)
+{
+	if (!AbilitySystemComponent) return FString();
+
+	const AActor* Actor = AbilitySystemComponent->GetAvatarActor_Direct();
+	return GetNameSafe(Actor ? Actor : AbilitySystemComponent->GetOwnerActor());
+}
@@ -0,0 +1,73 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ZBDeadlineQueue.h"
+
+void FZBDeadlineQueue::Schedule(int32 Slot, double Time)
+{
+	check(Slot >= 0);
+	if (Slot >= Serials.Num())
+	{
+		Serials.SetNumZeroed(Slot + 1);
+		Pending.SetNum(Slot + 1, false);
+	}
+
+	if (!Pending[Slot])
+	{
+		Pending[Slot] = true;
+		++NumPending;
+	}
+
+	FEntry Entry;
+	Entry.Time = Time;
+	Entry.Slot = Slot;
+	Entry.Serial = ++Serials[Slot];
+	Heap.HeapPush(Entry);
+}
+
+void FZBDeadlineQueue::Cancel(int32 Slot)
+{
+	if (!IsPending(Slot)) return;
+
+	Pending[Slot] = false;
+	++Serials[Slot];
+	--NumPending;
+}
+
+bool FZBDeadlineQueue::PopDue(double Now, int32& OutSlot)
+{
+	DiscardStaleTop();
+	if (Heap.IsEmpty() || Heap.HeapTop().Time > Now) return false;
+
+	FEntry Entry;
+	Heap.HeapPop(Entry, EAllowShrinking::No);
+	Pending[Entry.Slot] = false;
+	--NumPending;
+	OutSlot = Entry.Slot;
+	return true;
+}
+
+bool FZBDeadlineQueue::GetNextTime(double& OutTime)
+{
+	DiscardStaleTop();
+	if (Heap.IsEmpty()) return false;
+
+	OutTime = Heap.HeapTop().Time;
+	return true;
+}
+
+void FZBDeadlineQueue::Reset()
+{
+	Heap.Reset();
+	Serials.Reset();
+	Pending.Reset();
+	NumPending = 0;
+}
+
+void FZBDeadlineQueue::DiscardStaleTop()
+{
+	while (Heap.Num() > 0 && IsStale(Heap.HeapTop()))
+	{
+		Heap.HeapPopDiscard(EAllowShrinking::No);
+	}
+}
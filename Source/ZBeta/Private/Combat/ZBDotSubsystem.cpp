@@ -0,0 +1,442 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ZBDotSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/ZBAttributeSet.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "Engine/World.h"
+#include "GameplayEffect.h"
+#include "GameplayTagsManager.h"
+#include "ZBetaLog.h"
+#include "ZBetaStats.h"
+
+namespace
+{
+	// 只有叶子标签才是具体的 DOT（Effect.DOT.Fire 这类中间层只用于分类与匹配）
+	bool IsLeafDotTag(const FGameplayTag& Tag)
+	{
+		const TSharedPtr<FGameplayTagNode> Node = UGameplayTagsManager::Get().FindTagNode(Tag);
+		return Node.IsValid() && Node->GetChildTagNodes().IsEmpty() && Tag.MatchesTag(FZBGameplayTags::Get().Effect_DOT);
+	}
+}
+
+bool UZBDotSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// 纯客户端不跳伤
+	return Super::ShouldCreateSubsystem(Outer) && !IsRunningClientOnly();
+}
+
+bool UZBDotSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UZBDotSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TickResolution = FMath::Max(TickResolution, 0.01f);
+	MaxStacksPerStatus = FMath::Max(MaxStacksPerStatus, 1);
+
+	// 每个目标每帧一次的跳伤结算，数值走 SetByCaller
+	FSetByCallerFloat SetByCaller;
+	SetByCaller.DataTag = FZBGameplayTags::Get().Debuff_Data_Damage;
+
+	DamageEffect = NewObject<UGameplayEffect>(this, TEXT("GE_ZBDotDamage"), RF_Transient);
+	DamageEffect->DurationPolicy = EGameplayEffectDurationType::Instant;
+	FGameplayModifierInfo& Modifier = DamageEffect->Modifiers.AddDefaulted_GetRef();
+	Modifier.Attribute = UZBAttributeSet::GetIncomingDamageAttribute();
+	Modifier.ModifierOp = EGameplayModOp::Additive;
+	Modifier.ModifierMagnitude = FGameplayEffectModifierMagnitude(SetByCaller);
+
+	ResolveStatusEffects();
+}
+
+void UZBDotSubsystem::Deinitialize()
+{
+	Dots.Reset();
+	FreeDots.Reset();
+	Targets.Reset();
+	FreeTargets.Reset();
+	TargetIndexByASC.Reset();
+	ResolvedStatusEffects.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UZBDotSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UZBDotSubsystem, STATGROUP_Tickables);
+}
+
+uint64 UZBDotSubsystem::GetNowTick() const
+{
+	const UWorld* World = GetWorld();
+	return World ? static_cast<uint64>(FMath::FloorToDouble(World->GetTimeSeconds() / TickResolution)) : Wheel.GetCurrentTick();
+}
+
+void UZBDotSubsystem::ApplyDot(UAbilitySystemComponent* Source, UAbilitySystemComponent* Target, FGameplayTag DotTag, float DamagePerTick, float Frequency, float Duration)
+{
+	if (!Target || Duration <= 0.f) return;
+	if (!IsLeafDotTag(DotTag))
+	{
+		UE_LOG(LogZBetaAbility, Warning, TEXT("[DOT] %s 不是具体的 DOT 标签（Effect.DOT.* 的叶子标签），已忽略"), *DotTag.ToString());
+		return;
+	}
+
+	const uint32 PeriodTicks = FMath::Max(FMath::RoundToInt(FMath::Max(Frequency, 0.f) / TickResolution), 1);
+	const int32 NumTicks = FMath::Max(FMath::FloorToInt(Duration / (PeriodTicks * TickResolution)), 1);
+
+	const int32 TargetIndex = FindOrAddTarget(Target);
+	FStatus& Status = FindOrAddStatus(TargetIndex, DotTag, Source);
+
+	// 满层：刷新剩余跳数最少的一层，沿用它在时间轮上的下一跳
+	if (Status.DotIds.Num() >= MaxStacksPerStatus)
+	{
+		int32 RefreshId = INDEX_NONE;
+		for (const int32 DotId : Status.DotIds)
+		{
+			const FDot& Dot = Dots[DotId];
+			if (Dot.RemainingTicks > 0 && (RefreshId == INDEX_NONE || Dot.RemainingTicks < Dots[RefreshId].RemainingTicks))
+			{
+				RefreshId = DotId;
+			}
+		}
+
+		if (RefreshId != INDEX_NONE)
+		{
+			FDot& Dot = Dots[RefreshId];
+			Dot.Source = Source;
+			Dot.DamagePerTick = FMath::Max(DamagePerTick, 0.f);
+			Dot.PeriodTicks = PeriodTicks;
+			Dot.RemainingTicks = NumTicks;
+			return;
+		}
+	}
+
+	const int32 DotId = AllocateDot();
+	FDot& Dot = Dots[DotId];
+	Dot.Source = Source;
+	Dot.TargetIndex = TargetIndex;
+	Dot.Tag = DotTag;
+	Dot.DamagePerTick = FMath::Max(DamagePerTick, 0.f);
+	Dot.PeriodTicks = PeriodTicks;
+	Dot.RemainingTicks = NumTicks;
+	Dot.bCancelled = false;
+
+	// FindOrAddStatus 之后没有再增删目标，引用仍然有效
+	Status.DotIds.Add(DotId);
+	Wheel.Schedule(DotId, GetNowTick() + PeriodTicks);
+}
+
+bool UZBDotSubsystem::ApplyDotFromSpec(const FGameplayEffectSpec& Spec, UAbilitySystemComponent* Target)
+{
+	const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+
+	const float Duration = Spec.GetSetByCallerMagnitude(Tags.Debuff_Data_Duration, false, 0.f);
+	if (Duration <= 0.f) return false;
+
+	// 取 GE 上第一个具体（叶子）的 Effect.DOT.* 标签，Effect.DOT.Fire 这类中间层不算
+	FGameplayTagContainer AssetTags;
+	Spec.GetAllAssetTags(AssetTags);
+
+	FGameplayTag DotTag;
+	for (const FGameplayTag& Tag : AssetTags)
+	{
+		if (IsLeafDotTag(Tag))
+		{
+			DotTag = Tag;
+			break;
+		}
+	}
+
+	if (!DotTag.IsValid())
+	{
+		UE_LOG(LogZBetaAbility, Warning, TEXT("[DOT] %s 设置了 Debuff.Data.Duration 但没有具体的 Effect.DOT.* 标签"), *GetNameSafe(Spec.Def));
+		return false;
+	}
+
+	ApplyDot(
+		Spec.GetContext().GetOriginalInstigatorAbilitySystemComponent(),
+		Target,
+		DotTag,
+		Spec.GetSetByCallerMagnitude(Tags.Debuff_Data_Damage, false, 0.f),
+		Spec.GetSetByCallerMagnitude(Tags.Debuff_Data_Frequency, false, 1.f),
+		Duration);
+	return true;
+}
+
+void UZBDotSubsystem::RemoveDots(UAbilitySystemComponent* Target, FGameplayTag DotTag)
+{
+	const int32* TargetIndex = TargetIndexByASC.Find(Target);
+	if (!TargetIndex) return;
+
+	// 先收集再摘除：摘除最后一层会改动 Statuses，甚至回收目标
+	TArray<int32, TInlineAllocator<8>> DotIds;
+	for (const FStatus& Status : Targets[*TargetIndex].Statuses)
+	{
+		if (!DotTag.IsValid() || Status.Tag == DotTag)
+		{
+			DotIds.Append(Status.DotIds);
+		}
+	}
+
+	for (const int32 DotId : DotIds)
+	{
+		DetachDot(DotId);
+		// 时间轮上的条目到期时再回收
+		Dots[DotId].bCancelled = true;
+	}
+}
+
+/**
+ * @brief 推进时间轮并批量结算本帧全部跳伤
+ *
+ * 详细流程：
+ *   1. 取出到当前 Tick 为止到期的全部 DOT（已取消的直接回收）；
+ *   2. 伤害累加到目标，记录本帧受伤的目标；还有剩余跳数的按周期重新调度，否则记为结束；
+ *   3. 每个受伤目标施加一次伤害 GE；
+ *   4. 最后回收结束的 DOT（放在伤害之后，保证最后一跳结算时状态标签仍在）。
+ */
+void UZBDotSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const uint64 NowTick = GetNowTick();
+	if (Wheel.Num() == 0 || NowTick <= Wheel.GetCurrentTick())
+	{
+		Wheel.Advance(NowTick, ExpiredEntries);
+		return;
+	}
+
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_DotTick);
+
+	ExpiredEntries.Reset();
+	Wheel.Advance(NowTick, ExpiredEntries);
+
+	for (const FZBTimingWheel::FEntry& Entry : ExpiredEntries)
+	{
+		FDot& Dot = Dots[Entry.Id];
+		if (Dot.bCancelled)
+		{
+			Dot = FDot();
+			FreeDots.Add(Entry.Id);
+			continue;
+		}
+
+		FTarget& Target = Targets[Dot.TargetIndex];
+		if (Dot.DamagePerTick > 0.f)
+		{
+			if (Target.PendingDamage <= 0.f)
+			{
+				DamagedTargets.Add(Dot.TargetIndex);
+				Target.PendingInstigator = Dot.Source;
+			}
+			Target.PendingDamage += Dot.DamagePerTick;
+		}
+
+		INC_DWORD_STAT(STAT_ZBeta_DotTicks);
+
+		if (--Dot.RemainingTicks > 0)
+		{
+			Wheel.Schedule(Entry.Id, Entry.DueTick + Dot.PeriodTicks);
+		}
+		else
+		{
+			FinishedDots.Add(Entry.Id);
+		}
+	}
+	ExpiredEntries.Reset();
+
+	ApplyPendingDamage();
+
+	for (const int32 DotId : FinishedDots)
+	{
+		if (!Dots[DotId].bCancelled)
+		{
+			DetachDot(DotId);
+		}
+		Dots[DotId] = FDot();
+		FreeDots.Add(DotId);
+	}
+	FinishedDots.Reset();
+}
+
+void UZBDotSubsystem::ApplyPendingDamage()
+{
+	if (DamagedTargets.IsEmpty()) return;
+
+	// 按名字稳定排序，施加顺序与命中 / 调度顺序无关
+	DamagedTargets.StableSort([this](const int32 A, const int32 B)
+	{
+		return Targets[A].OrderKey < Targets[B].OrderKey;
+	});
+
+	const FGameplayTag DamageTag = FZBGameplayTags::Get().Debuff_Data_Damage;
+	for (const int32 TargetIndex : DamagedTargets)
+	{
+		// 伤害结算可能触发死亡等回调并改动 Targets，每次重新取
+		FTarget& Target = Targets[TargetIndex];
+		const float Damage = Target.PendingDamage;
+		UAbilitySystemComponent* Instigator = Target.PendingInstigator.Get();
+		UAbilitySystemComponent* AbilitySystemComponent = Target.AbilitySystemComponent.Get();
+		Target.PendingDamage = 0.f;
+		Target.PendingInstigator.Reset();
+
+		if (!AbilitySystemComponent || Damage <= 0.f) continue;
+
+		FGameplayEffectSpec Spec(DamageEffect, (Instigator ? Instigator : AbilitySystemComponent)->MakeEffectContext(), 1.f);
+		Spec.SetSetByCallerMagnitude(DamageTag, Damage);
+		AbilitySystemComponent->ApplyGameplayEffectSpecToSelf(Spec);
+
+		INC_DWORD_STAT(STAT_ZBeta_DotDamageApplications);
+	}
+	DamagedTargets.Reset();
+}
+
+int32 UZBDotSubsystem::FindOrAddTarget(UAbilitySystemComponent* Target)
+{
+	int32& Index = TargetIndexByASC.FindOrAdd(Target, INDEX_NONE);
+	if (Index == INDEX_NONE)
+	{
+		Index = FreeTargets.Num() > 0 ? FreeTargets.Pop(EAllowShrinking::No) : Targets.AddDefaulted();
+
+		FTarget& NewTarget = Targets[Index];
+		NewTarget.AbilitySystemComponent = Target;
+		NewTarget.Key = Target;
+
+		const AActor* Avatar = Target->GetAvatarActor_Direct();
+		NewTarget.OrderKey = GetNameSafe(Avatar ? Avatar : Target->GetOwnerActor());
+	}
+	return Index;
+}
+
+UZBDotSubsystem::FStatus& UZBDotSubsystem::FindOrAddStatus(int32 TargetIndex, FGameplayTag DotTag, UAbilitySystemComponent* Source)
+{
+	FTarget& Target = Targets[TargetIndex];
+	for (FStatus& Status : Target.Statuses)
+	{
+		if (Status.Tag == DotTag)
+		{
+			return Status;
+		}
+	}
+
+	FStatus& Status = Target.Statuses.AddDefaulted_GetRef();
+	Status.Tag = DotTag;
+
+	// 首层：挂上状态 GE（标签 + 特效），之后的层数与计时都不再经过 GE；
+	// 没有配置状态 GE 时退回复制的松散标签，客户端仍能看到状态，只是没有特效
+	UAbilitySystemComponent* AbilitySystemComponent = Target.AbilitySystemComponent.Get();
+	if (const UGameplayEffect* StatusEffect = GetStatusEffect(DotTag))
+	{
+		const FGameplayEffectSpec Spec(StatusEffect, (Source ? Source : AbilitySystemComponent)->MakeEffectContext(), 1.f);
+		Status.StatusHandle = AbilitySystemComponent->ApplyGameplayEffectSpecToSelf(Spec);
+	}
+	else
+	{
+		AbilitySystemComponent->AddLooseGameplayTag(DotTag);
+		AbilitySystemComponent->AddReplicatedLooseGameplayTag(DotTag);
+		Status.bLooseTag = true;
+	}
+	return Status;
+}
+
+int32 UZBDotSubsystem::AllocateDot()
+{
+	return FreeDots.Num() > 0 ? FreeDots.Pop(EAllowShrinking::No) : Dots.AddDefaulted();
+}
+
+void UZBDotSubsystem::DetachDot(int32 DotId)
+{
+	FDot& Dot = Dots[DotId];
+	if (Dot.TargetIndex == INDEX_NONE) return;
+
+	const int32 TargetIndex = Dot.TargetIndex;
+	Dot.TargetIndex = INDEX_NONE;
+
+	FTarget& Target = Targets[TargetIndex];
+	const int32 StatusIndex = Target.Statuses.IndexOfByPredicate([&Dot](const FStatus& Status) { return Status.Tag == Dot.Tag; });
+	if (StatusIndex == INDEX_NONE) return;
+
+	FStatus& Status = Target.Statuses[StatusIndex];
+	Status.DotIds.RemoveSingleSwap(DotId, EAllowShrinking::No);
+	if (Status.DotIds.Num() > 0) return;
+
+	// 最后一层结束：移除状态 GE（或退回用的松散标签）
+	UAbilitySystemComponent* AbilitySystemComponent = Target.AbilitySystemComponent.Get();
+	if (AbilitySystemComponent && Status.StatusHandle.IsValid())
+	{
+		AbilitySystemComponent->RemoveActiveGameplayEffect(Status.StatusHandle);
+	}
+	else if (AbilitySystemComponent && Status.bLooseTag)
+	{
+		AbilitySystemComponent->RemoveLooseGameplayTag(Status.Tag);
+		AbilitySystemComponent->RemoveReplicatedLooseGameplayTag(Status.Tag);
+	}
+	Target.Statuses.RemoveAtSwap(StatusIndex, EAllowShrinking::No);
+
+	if (Target.Statuses.IsEmpty())
+	{
+		TargetIndexByASC.Remove(Target.Key);
+		Target = FTarget();
+		FreeTargets.Add(TargetIndex);
+	}
+}
+
+/**
+ * @brief 加载并校验每个 DOT 的状态 GE
+ * @details 状态 GE 负责把 DOT 标签与特效复制到客户端，所以必须是资产，且为无限时长、授予该标签；
+ *          配置了但无效的项报错。只检查叶子标签（具体的 DOT），没有配置的只在进程内警告一次：
+ *          这些 DOT 照常跳伤，状态退回复制的松散标签，客户端没有特效。
+ */
+void UZBDotSubsystem::ResolveStatusEffects()
+{
+	ResolvedStatusEffects.Reset();
+
+	for (const TPair<FGameplayTag, TSoftClassPtr<UGameplayEffect>>& Entry : StatusEffects)
+	{
+		const UClass* LoadedClass = Entry.Value.LoadSynchronous();
+		const UGameplayEffect* StatusEffect = LoadedClass ? LoadedClass->GetDefaultObject<UGameplayEffect>() : nullptr;
+		if (!StatusEffect)
+		{
+			UE_LOG(LogZBetaAbility, Error, TEXT("[DOT] %s 的状态 GE 加载失败：%s"), *Entry.Key.ToString(), *Entry.Value.ToString());
+			continue;
+		}
+		if (StatusEffect->DurationPolicy != EGameplayEffectDurationType::Infinite || !StatusEffect->GetGrantedTags().HasTagExact(Entry.Key))
+		{
+			UE_LOG(LogZBetaAbility, Error, TEXT("[DOT] %s 的状态 GE %s 必须为无限时长并授予该标签"), *Entry.Key.ToString(), *GetNameSafe(LoadedClass));
+			continue;
+		}
+		ResolvedStatusEffects.Add(Entry.Key, StatusEffect);
+	}
+
+	// 每个世界初始化都会走到这里，缺失的配置只提示一次
+	static bool bWarnedMissing = false;
+	if (bWarnedMissing) return;
+
+	TArray<FString> Missing;
+	const FGameplayTagContainer DotTags = UGameplayTagsManager::Get().RequestGameplayTagChildren(FZBGameplayTags::Get().Effect_DOT);
+	for (const FGameplayTag& DotTag : DotTags)
+	{
+		if (IsLeafDotTag(DotTag) && !StatusEffects.Contains(DotTag))
+		{
+			Missing.Add(DotTag.ToString());
+		}
+	}
+
+	if (!Missing.IsEmpty())
+	{
+		bWarnedMissing = true;
+		UE_LOG(LogZBetaAbility, Warning, TEXT("[DOT] 以下 DOT 没有配置状态 GE（DefaultGame.ini [/Script/ZBeta.ZBDotSubsystem] StatusEffects），改用复制的松散标签，客户端没有特效：%s"),
+			*FString::Join(Missing, TEXT(", ")));
+	}
+}
+
+const UGameplayEffect* UZBDotSubsystem::GetStatusEffect(FGameplayTag DotTag) const
+{
+	const TObjectPtr<const UGameplayEffect>* Resolved = ResolvedStatusEffects.Find(DotTag);
+	return Resolved ? Resolved->Get() : nullptr;
+}
@@ -0,0 +1,319 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ZBMeleeHitSubsystem.h"
+
+#include "AbilitySystemBlueprintLibrary.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "AbilitySystem/ZBAbilityTypes.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "Combat/ZBMeleeWeaponComponent.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/ZBLagCompensationSubsystem.h"
+#include "Player/ZBPlayerController.h"
+#include "ZBetaLog.h"
+#include "ZBetaStats.h"
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<bool> CVarZBMeleeDrawDebug(
+	TEXT("zb.Melee.DrawDebug"),
+	false,
+	TEXT("为 true 时绘制每个子步的刀身扫掠"),
+	ECVF_Cheat);
+#endif
+
+bool UZBMeleeHitSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UZBMeleeHitSubsystem::Deinitialize()
+{
+	ActiveWeapons.Reset();
+	PendingSweeps.Reset();
+	FrameHits.Reset();
+	OnMeleeHitsResolved.Clear();
+
+	Super::Deinitialize();
+}
+
+TStatId UZBMeleeHitSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UZBMeleeHitSubsystem, STATGROUP_Tickables);
+}
+
+void UZBMeleeHitSubsystem::RegisterWeapon(UZBMeleeWeaponComponent* Weapon)
+{
+	if (Weapon)
+	{
+		ActiveWeapons.AddUnique(Weapon);
+	}
+}
+
+void UZBMeleeHitSubsystem::UnregisterWeapon(UZBMeleeWeaponComponent* Weapon)
+{
+	ActiveWeapons.RemoveSingleSwap(Weapon);
+}
+
+void UZBMeleeHitSubsystem::Tick(float DeltaTime)
+{
+	if (ActiveWeapons.IsEmpty() && PendingSweeps.IsEmpty() && FrameHits.IsEmpty()) return;
+
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_MeleeHitDetection);
+
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	CollectSweepResults(*World);
+	ResolveHits();
+	IssueSweeps(*World);
+}
+
+/**
+ * @brief 收取上一帧发出的扫掠结果
+ * @details 同一挥砍的多个子步、多个帧可能扫到同一目标，由武器的 HitActors 去重；
+ *          挥砍已换（SwingId 不同）的结果直接丢弃。
+ */
+void UZBMeleeHitSubsystem::CollectSweepResults(UWorld& World)
+{
+	FTraceDatum Datum;
+	for (const FPendingSweep& Pending : PendingSweeps)
+	{
+		UZBMeleeWeaponComponent* Weapon = Pending.Weapon.Get();
+		if (!Weapon || Weapon->GetSwingId() != Pending.SwingId) continue;
+		if (!World.QueryTraceData(Pending.Handle, Datum)) continue;
+
+		for (const FHitResult& Hit : Datum.OutHits)
+		{
+			AActor* HitActor = Hit.GetActor();
+			if (!Weapon->TryRecordHit(HitActor)) continue;
+
+			FZBMeleeHit& MeleeHit = FrameHits.AddDefaulted_GetRef();
+			MeleeHit.Weapon = Weapon;
+			MeleeHit.Attacker = Weapon->GetOwner();
+			MeleeHit.Victim = HitActor;
+			MeleeHit.SwingId = Pending.SwingId;
+			MeleeHit.HitResult = Hit;
+		}
+	}
+	PendingSweeps.Reset();
+}
+
+/**
+ * @brief 统一结算本帧命中
+ * @details 服务器上对每个命中由攻击者 ASC 施加武器的伤害 GE（EffectContext 带命中结果与武器）；
+ *          客户端上的命中是本地玩家的预测，改为带时间戳上报服务器校验。
+ *          最后把整批命中广播一次，供其它系统（受击反馈、统计等）使用。
+ */
+void UZBMeleeHitSubsystem::ResolveHits()
+{
+	if (FrameHits.IsEmpty()) return;
+
+	INC_DWORD_STAT_BY(STAT_ZBeta_MeleeHits, FrameHits.Num());
+
+	for (const FZBMeleeHit& Hit : FrameHits)
+	{
+		const AActor* Attacker = Hit.Attacker.Get();
+		if (!Attacker) continue;
+
+		if (Attacker->HasAuthority())
+		{
+			ApplyHitDamage(Hit);
+		}
+		else if (const APawn* Pawn = Cast<APawn>(Attacker))
+		{
+			if (AZBPlayerController* PlayerController = Pawn->GetController<AZBPlayerController>())
+			{
+				PlayerController->ReportMeleeHit(Hit.Weapon.Get(), Hit.Victim.Get(), Hit.HitResult.TraceStart, Hit.HitResult.TraceEnd);
+			}
+		}
+	}
+
+	OnMeleeHitsResolved.Broadcast(FrameHits);
+	FrameHits.Reset();
+}
+
+void UZBMeleeHitSubsystem::ApplyHitDamage(const FZBMeleeHit& Hit) const
+{
+	const UZBMeleeWeaponComponent* Weapon = Hit.Weapon.Get();
+	UAbilitySystemComponent* SourceASC = Weapon ? Weapon->GetAbilitySystemComponent() : nullptr;
+	UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Hit.Victim.Get());
+	if (!SourceASC || !TargetASC || !Weapon->GetDamageEffectClass()) return;
+
+	FGameplayEffectContextHandle Context = SourceASC->MakeEffectContext();
+	Context.AddSourceObject(Weapon);
+	Context.AddHitResult(Hit.HitResult);
+	if (FZBGameplayEffectContext* ZBContext = FZBGameplayEffectContext::Get(Context))
+	{
+		// 同一次激活里的连段各自一条随机流
+		ZBContext->HitIndex = Hit.SwingId;
+	}
+
+	const FGameplayEffectSpecHandle Spec = SourceASC->MakeOutgoingSpec(Weapon->GetDamageEffectClass(), 1.f, Context);
+	if (Spec.IsValid())
+	{
+		SourceASC->ApplyGameplayEffectSpecToTarget(*Spec.Data, TargetASC);
+	}
+}
+
+/**
+ * @brief 服务器校验客户端上报的命中
+ *
+ * 详细流程：
+ *   1. 基本校验：武器属于该玩家的 Pawn，服务器上的挥砍仍在进行或刚结束（宽限为最大回溯时长），
+ *      扫掠起点离 Pawn 不超过 MaxReportedTraceOffset；
+ *   2. 由客户端时间戳估算它画面上的时刻，过旧直接拒绝；
+ *   3. 入队回溯校验，回调里确认命中、目标当时不在无敌帧、本次挥砍第一次命中该目标，记入本帧命中，
+ *      下一次 Tick 与服务器自己的命中一起结算。
+ */
+void UZBMeleeHitSubsystem::ValidateClientHit(AZBPlayerController* PlayerController, UZBMeleeWeaponComponent* Weapon, AActor* Victim,
+	double ClientTime, const FVector& TraceStart, const FVector& TraceEnd)
+{
+	UZBLagCompensationSubsystem* LagCompensation = UWorld::GetSubsystem<UZBLagCompensationSubsystem>(GetWorld());
+	const APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	if (!LagCompensation || !Pawn || !Weapon || !Victim || Weapon->GetOwner() != Pawn) return;
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (!Weapon->IsSwingActiveOrRecent(Now, LagCompensation->GetMaxRewindSeconds())
+		|| FVector::DistSquared(TraceStart, Pawn->GetActorLocation()) > FMath::Square(Weapon->GetMaxReportedTraceOffset()))
+	{
+		UE_LOG(LogZBetaNet, Verbose, TEXT("拒绝 %s 上报的命中：不在挥砍中或扫掠位置不符"), *GetNameSafe(PlayerController));
+		return;
+	}
+
+	double ViewTime = 0.0;
+	if (!LagCompensation->EstimateClientViewTime(PlayerController, ClientTime, ViewTime)) return;
+
+	FZBRewindRequest Request;
+	Request.Target = Victim;
+	Request.Time = ViewTime;
+	Request.TraceStart = TraceStart;
+	Request.TraceEnd = TraceEnd;
+	Request.TraceRadius = Weapon->GetRadius();
+	Request.OnValidated = [WeakThis = TWeakObjectPtr<UZBMeleeHitSubsystem>(this), WeakWeapon = TWeakObjectPtr<UZBMeleeWeaponComponent>(Weapon),
+		WeakVictim = TWeakObjectPtr<AActor>(Victim), TraceStart, TraceEnd](const FZBRewindResult& Result)
+	{
+		UZBMeleeHitSubsystem* Subsystem = WeakThis.Get();
+		UZBMeleeWeaponComponent* ValidatedWeapon = WeakWeapon.Get();
+		AActor* ValidatedVictim = WeakVictim.Get();
+		if (!Subsystem || !ValidatedWeapon || !ValidatedVictim || !Result.bRewound || !Result.bHit) return;
+		if (Result.Pose.HadStateTag(FZBGameplayTags::Get().State_IFrame)) return;
+		if (!ValidatedWeapon->TryRecordHit(ValidatedVictim)) return;
+
+		const FVector HitLocation = Result.Pose.HitboxLocations.IsValidIndex(Result.HitboxIndex)
+			? Result.Pose.HitboxLocations[Result.HitboxIndex]
+			: Result.Pose.Location;
+
+		FZBMeleeHit& MeleeHit = Subsystem->FrameHits.AddDefaulted_GetRef();
+		MeleeHit.Weapon = ValidatedWeapon;
+		MeleeHit.Attacker = ValidatedWeapon->GetOwner();
+		MeleeHit.Victim = ValidatedVictim;
+		MeleeHit.SwingId = ValidatedWeapon->GetSwingId();
+		MeleeHit.HitResult = FHitResult(ValidatedVictim, nullptr, HitLocation, (TraceStart - HitLocation).GetSafeNormal());
+		MeleeHit.HitResult.TraceStart = TraceStart;
+		MeleeHit.HitResult.TraceEnd = TraceEnd;
+	};
+	LagCompensation->QueueValidation(MoveTemp(Request));
+}
+
+bool UZBMeleeHitSubsystem::ValidateClientParry(AZBPlayerController* PlayerController, AActor* Attacker, double ClientTime)
+{
+	UZBLagCompensationSubsystem* LagCompensation = UWorld::GetSubsystem<UZBLagCompensationSubsystem>(GetWorld());
+	APawn* Defender = PlayerController ? PlayerController->GetPawn() : nullptr;
+	if (!LagCompensation || !Defender || !Attacker || Attacker == Defender) return false;
+
+	double ViewTime = 0.0;
+	FZBRewoundCharacter Pose;
+	const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+	if (!LagCompensation->EstimateClientViewTime(PlayerController, ClientTime, ViewTime)
+		|| !LagCompensation->RewindCharacter(Attacker, ViewTime, Pose)
+		|| !Pose.HadStateTag(Tags.State_ParryWindowActive))
+	{
+		UE_LOG(LogZBetaNet, Verbose, TEXT("拒绝 %s 上报的弹反：%s 当时不在可弹反窗口"), *GetNameSafe(PlayerController), *GetNameSafe(Attacker));
+		return false;
+	}
+
+	// 攻击者本次挥砍不再命中弹反者
+	TInlineComponentArray<UZBMeleeWeaponComponent*> Weapons(Attacker);
+	for (UZBMeleeWeaponComponent* Weapon : Weapons)
+	{
+		Weapon->TryRecordHit(Defender);
+	}
+
+	FGameplayEventData Payload;
+	Payload.EventTag = Tags.Ability_Parry;
+	Payload.Instigator = Attacker;
+	Payload.Target = Defender;
+	UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(Defender, Tags.Ability_Parry, Payload);
+	return true;
+}
+
+void UZBMeleeHitSubsystem::IssueSweeps(UWorld& World)
+{
+	for (int32 Index = ActiveWeapons.Num() - 1; Index >= 0; --Index)
+	{
+		UZBMeleeWeaponComponent* Weapon = ActiveWeapons[Index].Get();
+		if (!Weapon)
+		{
+			ActiveWeapons.RemoveAtSwap(Index);
+			continue;
+		}
+		IssueWeaponSweeps(World, *Weapon);
+	}
+}
+
+/**
+ * @brief 为一把武器发出本帧的扫掠
+ *
+ * 详细流程：
+ *   1. 采样本帧刀身姿态；
+ *   2. 按刀尖从上一帧到本帧的位移计算子步数（至少 1，至多 MaxSubSteps）；挥砍第一帧没有上一帧姿态，只扫当前姿态；
+ *   3. 每个子步插值出刀身姿态，发出一次从根部到刀尖的球形异步扫掠（按对象类型查询，
+ *      不存在阻挡，路径上的所有目标都会返回；同一目标的多个形体由 TryRecordHit 去重）；
+ *   4. 记下本帧姿态作为下一帧的起点。
+ */
+void UZBMeleeHitSubsystem::IssueWeaponSweeps(UWorld& World, UZBMeleeWeaponComponent& Weapon)
+{
+	FZBBladePose CurrentPose;
+	if (!Weapon.SampleBladePose(CurrentPose)) return;
+
+	int32 NumSubSteps = 1;
+	if (Weapon.bHasLastPose)
+	{
+		const float TipTravel = FVector::Dist(Weapon.LastPose.GetTipWorld(), CurrentPose.GetTipWorld());
+		NumSubSteps = FMath::Clamp(FMath::CeilToInt(TipTravel / Weapon.GetMaxSubStepDistance()), 1, Weapon.GetMaxSubSteps());
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ZBMeleeSweep), false, Weapon.GetOwner());
+	const FCollisionShape Shape = FCollisionShape::MakeSphere(Weapon.GetRadius());
+
+	for (int32 Step = 1; Step <= NumSubSteps; ++Step)
+	{
+		const FZBBladePose Pose = Weapon.bHasLastPose
+			? FZBBladePose::Interpolate(Weapon.LastPose, CurrentPose, float(Step) / NumSubSteps)
+			: CurrentPose;
+		const FVector Base = Pose.GetBaseWorld();
+		const FVector Tip = Pose.GetTipWorld();
+
+		FPendingSweep& Pending = PendingSweeps.AddDefaulted_GetRef();
+		Pending.Weapon = &Weapon;
+		Pending.SwingId = Weapon.GetSwingId();
+		Pending.Handle = World.AsyncSweepByObjectType(EAsyncTraceType::Multi, Base, Tip, FQuat::Identity, Weapon.GetTargetObjectQueryParams(), Shape, QueryParams);
+
+#if !UE_BUILD_SHIPPING
+		if (CVarZBMeleeDrawDebug.GetValueOnGameThread())
+		{
+			DrawDebugCapsule(&World, (Base + Tip) * 0.5f, FVector::Dist(Base, Tip) * 0.5f + Weapon.GetRadius(), Weapon.GetRadius(),
+				FRotationMatrix::MakeFromZ(Tip - Base).ToQuat(), FColor::Yellow, false, 1.f);
+		}
+#endif
+	}
+	INC_DWORD_STAT_BY(STAT_ZBeta_MeleeSweeps, NumSubSteps);
+
+	Weapon.LastPose = CurrentPose;
+	Weapon.bHasLastPose = true;
+}
@@ -0,0 +1,177 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ZBMeleeWeaponComponent.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "Combat/ZBMeleeHitSubsystem.h"
+#include "Components/MeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "ZBetaLog.h"
+
+FZBBladePose FZBBladePose::Interpolate(const FZBBladePose& A, const FZBBladePose& B, float Alpha)
+{
+	FZBBladePose Result;
+	Result.BaseLocal = FMath::Lerp(A.BaseLocal, B.BaseLocal, Alpha);
+
+	// 刀身绕根部旋转：方向走球面插值，长度线性插值，比直接插值刀尖更贴近动画弧线
+	const FVector BladeA = A.TipLocal - A.BaseLocal;
+	const FVector BladeB = B.TipLocal - B.BaseLocal;
+	const float LengthA = BladeA.Size();
+	const float LengthB = BladeB.Size();
+	if (LengthA > UE_KINDA_SMALL_NUMBER && LengthB > UE_KINDA_SMALL_NUMBER)
+	{
+		const FVector DirA = BladeA / LengthA;
+		const FQuat Delta = FQuat::FindBetweenNormals(DirA, BladeB / LengthB);
+		const FVector Dir = FQuat::Slerp(FQuat::Identity, Delta, Alpha).RotateVector(DirA);
+		Result.TipLocal = Result.BaseLocal + Dir * FMath::Lerp(LengthA, LengthB, Alpha);
+	}
+	else
+	{
+		Result.TipLocal = FMath::Lerp(A.TipLocal, B.TipLocal, Alpha);
+	}
+
+	Result.MeshToWorld.Blend(A.MeshToWorld, B.MeshToWorld, Alpha);
+	return Result;
+}
+
+UZBMeleeWeaponComponent::UZBMeleeWeaponComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	TargetObjectTypes.Add(UEngineTypes::ConvertToObjectType(ECC_Pawn));
+}
+
+void UZBMeleeWeaponComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	TargetObjectQueryParams = FCollisionObjectQueryParams(TargetObjectTypes);
+
+	if (!MeshComponentTag.IsNone())
+	{
+		SocketMesh = GetOwner()->FindComponentByTag<UMeshComponent>(MeshComponentTag);
+	}
+	else if (const ACharacter* Character = Cast<ACharacter>(GetOwner()))
+	{
+		SocketMesh = Character->GetMesh();
+	}
+
+	if (!SocketMesh)
+	{
+		UE_LOG(LogZBetaCharacter, Warning, TEXT("%s 的近战武器找不到带插槽的网格体（MeshComponentTag = %s）"), *GetNameSafe(GetOwner()), *MeshComponentTag.ToString());
+	}
+}
+
+void UZBMeleeWeaponComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnbindAbilitySystem();
+	EndSwing();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UZBMeleeWeaponComponent::BindAbilitySystem(UAbilitySystemComponent* InAbilitySystemComponent)
+{
+	// 服务器判定，拥有者客户端预测；模拟代理不检测
+	const AActor* Owner = GetOwner();
+	if (!Owner || (!Owner->HasAuthority() && Owner->GetLocalRole() != ROLE_AutonomousProxy)) return;
+	if (BoundAbilitySystemComponent.Get() == InAbilitySystemComponent) return;
+
+	UnbindAbilitySystem();
+	if (!InAbilitySystemComponent) return;
+
+	const FGameplayTag& HitWindowTag = FZBGameplayTags::Get().State_HitWindowActive;
+	BoundAbilitySystemComponent = InAbilitySystemComponent;
+	HitWindowDelegateHandle = InAbilitySystemComponent->RegisterGameplayTagEvent(HitWindowTag, EGameplayTagEventType::NewOrRemoved)
+		.AddUObject(this, &UZBMeleeWeaponComponent::OnHitWindowTagChanged);
+
+	// 绑定时窗口可能已经打开
+	if (InAbilitySystemComponent->HasMatchingGameplayTag(HitWindowTag))
+	{
+		BeginSwing();
+	}
+}
+
+void UZBMeleeWeaponComponent::UnbindAbilitySystem()
+{
+	if (UAbilitySystemComponent* ASC = BoundAbilitySystemComponent.Get())
+	{
+		ASC->RegisterGameplayTagEvent(FZBGameplayTags::Get().State_HitWindowActive, EGameplayTagEventType::NewOrRemoved).Remove(HitWindowDelegateHandle);
+	}
+	BoundAbilitySystemComponent.Reset();
+	HitWindowDelegateHandle.Reset();
+}
+
+void UZBMeleeWeaponComponent::OnHitWindowTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	if (NewCount > 0)
+	{
+		BeginSwing();
+	}
+	else
+	{
+		EndSwing();
+	}
+}
+
+void UZBMeleeWeaponComponent::BeginSwing()
+{
+	if (bSwingActive) return;
+
+	bSwingActive = true;
+	++SwingId;
+	HitActors.Reset();
+	bHasLastPose = false;
+
+	// 远端玩家的武器由其客户端扫掠，服务器只需要挥砍状态
+	if (IsClientPredicted()) return;
+
+	if (UZBMeleeHitSubsystem* Subsystem = UWorld::GetSubsystem<UZBMeleeHitSubsystem>(GetWorld()))
+	{
+		Subsystem->RegisterWeapon(this);
+	}
+}
+
+void UZBMeleeWeaponComponent::EndSwing()
+{
+	if (!bSwingActive) return;
+
+	// 已发出的扫掠仍按本次挥砍收取，SwingId 在下一次 BeginSwing 时才变
+	bSwingActive = false;
+	bHasLastPose = false;
+	SwingEndTime = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+
+	if (UZBMeleeHitSubsystem* Subsystem = UWorld::GetSubsystem<UZBMeleeHitSubsystem>(GetWorld()))
+	{
+		Subsystem->UnregisterWeapon(this);
+	}
+}
+
+bool UZBMeleeWeaponComponent::IsClientPredicted() const
+{
+	// 服务器上被远端客户端占有的 Pawn，其 RemoteRole 为自主代理；Listen Server 房主与 AI 不是
+	const AActor* Owner = GetOwner();
+	return Owner && Owner->HasAuthority() && Owner->GetRemoteRole() == ROLE_AutonomousProxy;
+}
+
+bool UZBMeleeWeaponComponent::SampleBladePose(FZBBladePose& OutPose) const
+{
+	if (!SocketMesh) return false;
+
+	OutPose.MeshToWorld = SocketMesh->GetComponentTransform();
+	OutPose.BaseLocal = SocketMesh->GetSocketTransform(BaseSocket, RTS_Component).GetLocation();
+	OutPose.TipLocal = SocketMesh->GetSocketTransform(TipSocket, RTS_Component).GetLocation();
+	return true;
+}
+
+bool UZBMeleeWeaponComponent::TryRecordHit(AActor* HitActor)
+{
+	if (!HitActor || HitActor == GetOwner()) return false;
+
+	bool bAlreadyHit = false;
+	HitActors.Add(HitActor, &bAlreadyHit);
+	return !bAlreadyHit;
+}
@@ -0,0 +1,320 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ZBPoiseSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/ZBAttributeSet.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "Engine/World.h"
+#include "GameplayEffect.h"
+#include "TimerManager.h"
+#include "ZBetaLog.h"
+#include "ZBetaStats.h"
+
+namespace
+{
+	enum EZBPoiseRow : uint8 { PoiseRow_Normal, PoiseRow_Broken, PoiseRow_HyperArmor, PoiseRow_Num };
+	enum EZBHitSeverity : uint8 { HitSeverity_Light, HitSeverity_Medium, HitSeverity_Heavy, HitSeverity_Num };
+
+	using FZBTagMember = FGameplayTag FZBGameplayTags::*;
+
+	// 受击反应表：行为韧性状态，列为受击强度；nullptr 表示不做受击反应
+	constexpr FZBTagMember HitReactTable[PoiseRow_Num][HitSeverity_Num] = {
+		// 正常：按强度轻 / 中 / 重
+		{ &FZBGameplayTags::HitReact_Light, &FZBGameplayTags::HitReact_Medium, &FZBGameplayTags::HitReact_Heavy },
+		// 本次破韧：击退，重击击倒
+		{ &FZBGameplayTags::HitReact_Knockback, &FZBGameplayTags::HitReact_Knockback, &FZBGameplayTags::HitReact_Knockdown },
+		// 霸体：不打断动作，只有重击给一个轻受击
+		{ nullptr, nullptr, &FZBGameplayTags::HitReact_Light },
+	};
+}
+
+bool UZBPoiseSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// 纯客户端不结算韧性
+	return Super::ShouldCreateSubsystem(Outer) && !IsRunningClientOnly();
+}
+
+bool UZBPoiseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UZBPoiseSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	RegenStepInterval = FMath::Max(RegenStepInterval, 0.05f);
+
+	const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+	StaggerEffect = LoadStatusEffect(StaggerEffectClass, Tags.State_Staggered);
+	GuardBrokenEffect = LoadStatusEffect(GuardBrokenEffectClass, Tags.State_GuardBroken);
+
+	// 每个世界初始化都会走到这里，未配置只提示一次
+	static bool bWarnedMissing = false;
+	if (!bWarnedMissing && (StaggerEffectClass.IsNull() || GuardBrokenEffectClass.IsNull()))
+	{
+		bWarnedMissing = true;
+		UE_LOG(LogZBetaAbility, Warning, TEXT("[Poise] 硬直 / 破防状态 GE 未配置（DefaultGame.ini [/Script/ZBeta.ZBPoiseSubsystem]），改用复制的松散标签，客户端没有特效"));
+	}
+}
+
+/**
+ * @brief 加载状态 GE 并检查它能被客户端正确复制与计时
+ * @details 必须是资产（运行时生成的 GE 无法复制），HasDuration 且授予对应标签；时长由 ApplyStatusEffect 经 SetByCaller 写入。
+ *          未配置时返回空（由 Initialize 统一警告），配置了但无效时报错。
+ */
+const UGameplayEffect* UZBPoiseSubsystem::LoadStatusEffect(const TSoftClassPtr<UGameplayEffect>& EffectClass, const FGameplayTag& GrantedTag) const
+{
+	if (EffectClass.IsNull()) return nullptr;
+
+	const UClass* LoadedClass = EffectClass.LoadSynchronous();
+	const UGameplayEffect* Effect = LoadedClass ? LoadedClass->GetDefaultObject<UGameplayEffect>() : nullptr;
+	if (!Effect)
+	{
+		UE_LOG(LogZBetaAbility, Error, TEXT("[Poise] %s 的状态 GE 加载失败：%s（DefaultGame.ini [/Script/ZBeta.ZBPoiseSubsystem]）"),
+			*GrantedTag.ToString(), *EffectClass.ToString());
+		return nullptr;
+	}
+	if (Effect->DurationPolicy != EGameplayEffectDurationType::HasDuration || !Effect->GetGrantedTags().HasTagExact(GrantedTag))
+	{
+		UE_LOG(LogZBetaAbility, Error, TEXT("[Poise] 状态 GE %s 必须为 HasDuration 并授予 %s"), *GetNameSafe(LoadedClass), *GrantedTag.ToString());
+		return nullptr;
+	}
+	return Effect;
+}
+
+void UZBPoiseSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(TimerHandle);
+	}
+	States.Reset();
+	FreeStates.Reset();
+	StateIndexByASC.Reset();
+	EventQueue.Reset();
+
+	Super::Deinitialize();
+}
+
+double UZBPoiseSubsystem::GetTimeSeconds() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+/**
+ * @brief 一次削韧的完整处理
+ *
+ * 详细流程：
+ *   1. 已在硬直 / 破防中（本系统有待处理的 Recover，或带有别处授予的状态标签）、或目标没有韧性（MaxToughness 为 0）时忽略；
+ *   2. 扣除韧性（不低于 0），判断是否破韧（霸体不破）；
+ *   3. 按（状态，削韧 / 最大韧性）查表得到受击反应；
+ *   4. 破韧：施加硬直或破防 GE，调度到期后回满；未破韧：把回韧推迟到 RegenDelay 之后；
+ *   5. 受击反应作为 GameplayEvent 交给目标 ASC（由受击技能的 AbilityTriggers 响应）。
+ */
+void UZBPoiseSubsystem::ApplyToughnessDamage(UAbilitySystemComponent& Target, float ToughnessDamage, AActor* Instigator)
+{
+	if (ToughnessDamage <= 0.f) return;
+
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_PoiseDamage);
+
+	// 破韧状态以本系统的待处理 Recover 为准，不依赖状态 GE 是否配置、标签是否已复制
+	const int32* ExistingState = StateIndexByASC.Find(&Target);
+	if (ExistingState && States[*ExistingState].PendingEvent == EPoiseEvent::Recover) return;
+
+	const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+	if (Target.HasMatchingGameplayTag(Tags.State_Staggered) || Target.HasMatchingGameplayTag(Tags.State_GuardBroken)) return;
+
+	const float MaxToughness = Target.GetNumericAttribute(UZBAttributeSet::GetMaxToughnessAttribute());
+	if (MaxToughness <= 0.f) return;
+
+	const float Toughness = FMath::Max(Target.GetNumericAttribute(UZBAttributeSet::GetToughnessAttribute()) - ToughnessDamage, 0.f);
+	Target.SetNumericAttributeBase(UZBAttributeSet::GetToughnessAttribute(), Toughness);
+
+	const bool bHyperArmor = Target.HasMatchingGameplayTag(Tags.State_HyperArmor);
+	const bool bBroken = Toughness <= 0.f && !bHyperArmor;
+	const FGameplayTag HitReact = SelectHitReact(bHyperArmor, bBroken, ToughnessDamage / MaxToughness);
+
+	const int32 StateIndex = FindOrAddState(Target);
+	if (bBroken)
+	{
+		const bool bGuardBroken = Target.HasMatchingGameplayTag(Tags.State_Blocking);
+		const float Duration = bGuardBroken ? GuardBrokenDuration : StaggerDuration;
+		ApplyStatusEffect(StateIndex, bGuardBroken ? GuardBrokenEffect : StaggerEffect, bGuardBroken ? Tags.State_GuardBroken : Tags.State_Staggered, Duration);
+		Schedule(StateIndex, EPoiseEvent::Recover, GetTimeSeconds() + Duration);
+
+		INC_DWORD_STAT(STAT_ZBeta_PoiseBreaks);
+		OnPoiseBroken.Broadcast(&Target, bGuardBroken);
+	}
+	else
+	{
+		Schedule(StateIndex, EPoiseEvent::Regen, GetTimeSeconds() + RegenDelay);
+	}
+
+	if (HitReact.IsValid())
+	{
+		FGameplayEventData Payload;
+		Payload.EventTag = HitReact;
+		Payload.Instigator = Instigator;
+		Payload.Target = Target.GetAvatarActor();
+		Payload.EventMagnitude = ToughnessDamage;
+		Target.HandleGameplayEvent(HitReact, &Payload);
+	}
+}
+
+FGameplayTag UZBPoiseSubsystem::SelectHitReact(bool bHyperArmor, bool bBroken, float ToughnessRatio) const
+{
+	const EZBPoiseRow Row = bHyperArmor ? PoiseRow_HyperArmor : bBroken ? PoiseRow_Broken : PoiseRow_Normal;
+	const EZBHitSeverity Severity = ToughnessRatio >= HeavyHitRatio ? HitSeverity_Heavy
+		: ToughnessRatio >= MediumHitRatio ? HitSeverity_Medium
+		: HitSeverity_Light;
+
+	const FZBTagMember Member = HitReactTable[Row][Severity];
+	return Member ? FZBGameplayTags::Get().*Member : FGameplayTag();
+}
+
+/**
+ * @brief 授予破韧状态
+ * @details 有状态 GE 时由 GE 计时与复制；没有时退回复制的松散标签，由 Recover 事件移除。
+ */
+void UZBPoiseSubsystem::ApplyStatusEffect(int32 StateIndex, const UGameplayEffect* Effect, const FGameplayTag& StatusTag, float Duration)
+{
+	FPoiseState& State = States[StateIndex];
+	UAbilitySystemComponent* Target = State.AbilitySystemComponent.Get();
+	if (!Target) return;
+
+	if (Effect)
+	{
+		FGameplayEffectSpec Spec(Effect, Target->MakeEffectContext(), 1.f);
+		Spec.SetSetByCallerMagnitude(FZBGameplayTags::Get().Debuff_Data_Duration, Duration);
+		Target->ApplyGameplayEffectSpecToSelf(Spec);
+		return;
+	}
+
+	Target->AddLooseGameplayTag(StatusTag);
+	Target->AddReplicatedLooseGameplayTag(StatusTag);
+	State.LooseStatusTag = StatusTag;
+}
+
+int32 UZBPoiseSubsystem::FindOrAddState(UAbilitySystemComponent& Target)
+{
+	int32& Index = StateIndexByASC.FindOrAdd(&Target, INDEX_NONE);
+	if (Index == INDEX_NONE)
+	{
+		Index = FreeStates.Num() > 0 ? FreeStates.Pop(EAllowShrinking::No) : States.AddDefaulted();
+		States[Index].AbilitySystemComponent = &Target;
+		States[Index].Key = &Target;
+	}
+	return Index;
+}
+
+void UZBPoiseSubsystem::ReleaseState(int32 StateIndex)
+{
+	FPoiseState& State = States[StateIndex];
+	// 队列里残留的旧条目在槽位复用后依然作废
+	EventQueue.Cancel(StateIndex);
+
+	StateIndexByASC.Remove(State.Key);
+	if (State.LooseStatusTag.IsValid())
+	{
+		if (UAbilitySystemComponent* AbilitySystemComponent = State.AbilitySystemComponent.Get())
+		{
+			AbilitySystemComponent->RemoveLooseGameplayTag(State.LooseStatusTag);
+			AbilitySystemComponent->RemoveReplicatedLooseGameplayTag(State.LooseStatusTag);
+		}
+		State.LooseStatusTag = FGameplayTag();
+	}
+	State.AbilitySystemComponent.Reset();
+	State.Key = TObjectKey<UAbilitySystemComponent>();
+	State.PendingEvent = EPoiseEvent::None;
+	FreeStates.Add(StateIndex);
+}
+
+void UZBPoiseSubsystem::Schedule(int32 StateIndex, EPoiseEvent Event, double Time)
+{
+	States[StateIndex].PendingEvent = Event;
+	EventQueue.Schedule(StateIndex, Time);
+	ArmTimer();
+}
+
+/**
+ * @brief 把世界定时器对准最早的有效事件
+ * @details 定时器已经对准更早（或同一）时刻时不动它。
+ */
+void UZBPoiseSubsystem::ArmTimer()
+{
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	FTimerManager& TimerManager = World->GetTimerManager();
+	double NextTime = 0.0;
+	if (!EventQueue.GetNextTime(NextTime))
+	{
+		TimerManager.ClearTimer(TimerHandle);
+		return;
+	}
+
+	if (TimerManager.IsTimerActive(TimerHandle) && TimerTime <= NextTime) return;
+
+	TimerTime = NextTime;
+	TimerManager.SetTimer(TimerHandle, this, &UZBPoiseSubsystem::OnTimer, FMath::Max(static_cast<float>(NextTime - GetTimeSeconds()), 0.001f), false);
+}
+
+void UZBPoiseSubsystem::OnTimer()
+{
+	const double Now = GetTimeSeconds();
+	int32 StateIndex = INDEX_NONE;
+	while (EventQueue.PopDue(Now, StateIndex))
+	{
+		ProcessEvent(StateIndex);
+	}
+
+	ArmTimer();
+}
+
+void UZBPoiseSubsystem::ProcessEvent(int32 StateIndex)
+{
+	INC_DWORD_STAT(STAT_ZBeta_PoiseTimerEvents);
+
+	FPoiseState& State = States[StateIndex];
+	const EPoiseEvent Event = State.PendingEvent;
+	State.PendingEvent = EPoiseEvent::None;
+
+	UAbilitySystemComponent* AbilitySystemComponent = State.AbilitySystemComponent.Get();
+	if (!AbilitySystemComponent)
+	{
+		ReleaseState(StateIndex);
+		return;
+	}
+
+	const float MaxToughness = AbilitySystemComponent->GetNumericAttribute(UZBAttributeSet::GetMaxToughnessAttribute());
+	if (Event == EPoiseEvent::Recover)
+	{
+		// 状态 GE 自行到期，这里只把韧性回满（松散标签在 ReleaseState 中移除）
+		AbilitySystemComponent->SetNumericAttributeBase(UZBAttributeSet::GetToughnessAttribute(), MaxToughness);
+		ReleaseState(StateIndex);
+		return;
+	}
+
+	const float RegenRate = AbilitySystemComponent->GetNumericAttribute(UZBAttributeSet::GetToughnessRegenRateAttribute());
+	const float Toughness = AbilitySystemComponent->GetNumericAttribute(UZBAttributeSet::GetToughnessAttribute());
+	if (RegenRate <= 0.f || Toughness >= MaxToughness)
+	{
+		ReleaseState(StateIndex);
+		return;
+	}
+
+	const float NewToughness = FMath::Min(Toughness + RegenRate * RegenStepInterval, MaxToughness);
+	AbilitySystemComponent->SetNumericAttributeBase(UZBAttributeSet::GetToughnessAttribute(), NewToughness);
+	if (NewToughness < MaxToughness)
+	{
+		Schedule(StateIndex, EPoiseEvent::Regen, GetTimeSeconds() + RegenStepInterval);
+	}
+	else
+	{
+		ReleaseState(StateIndex);
+	}
+}
@@ -0,0 +1,400 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ZBProjectileSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "AbilitySystem/ZBAbilityTypes.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "Player/ZBPlayerController.h"
+#include "ZBetaStats.h"
+
+#if !UE_SERVER
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+#endif
+
+bool UZBProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UZBProjectileSubsystem::Deinitialize()
+{
+	Positions.Reset();
+	Velocities.Reset();
+	GravityZ.Reset();
+	RemainingLifetimes.Reset();
+	VolleyIndices.Reset();
+	ProjectileIds.Reset();
+	Finished.Reset();
+	PendingSweeps.Reset();
+	Volleys.Reset();
+	FreeVolleys.Reset();
+	FrameHits.Reset();
+	VisualComponents.Reset();
+	VisualTransforms.Reset();
+	VisualActor = nullptr;
+
+	Super::Deinitialize();
+}
+
+TStatId UZBProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UZBProjectileSubsystem, STATGROUP_Tickables);
+}
+
+int32 UZBProjectileSubsystem::AllocateVolley()
+{
+	return FreeVolleys.Num() > 0 ? FreeVolleys.Pop(EAllowShrinking::No) : Volleys.AddDefaulted();
+}
+
+uint32 UZBProjectileSubsystem::AllocateProjectileId()
+{
+	const uint32 ProjectileId = NextProjectileId;
+	NextProjectileId = NextProjectileId == MAX_uint32 ? 1 : NextProjectileId + 1;
+	return ProjectileId;
+}
+
+/**
+ * @brief 发射一批投射物
+ *
+ * 详细流程：
+ *   1. 按剩余容量截断数量，分配一份批次数据（伤害 Spec 只在权威端保留）；
+ *   2. 忽略发射者与 Spec 的 EffectCauser，有网格且需要表现时找到 / 创建对应的实例化网格组件；
+ *   3. 方向在水平面上按 SpreadAngle 均匀展开（360 度时首尾不重合），每个投射物追加一行数据；
+ *   4. 联网的权威端把这次发射转发给附近的客户端做表现（ReplicateVolley）。
+ */
+int32 UZBProjectileSubsystem::FireProjectiles(const FZBProjectileParams& Params, FGameplayEffectSpecHandle DamageSpec, AActor* Instigator)
+{
+	UWorld* World = GetWorld();
+	const int32 Count = FMath::Min(FMath::Max(Params.Count, 1), MaxProjectiles - Positions.Num());
+	if (!World || Count <= 0) return 0;
+
+	const bool bHasAuthority = World->GetNetMode() != NM_Client;
+	const bool bRendersVisuals = World->GetNetMode() != NM_DedicatedServer;
+
+	const int32 VolleyIndex = AllocateVolley();
+	FVolley& Volley = Volleys[VolleyIndex];
+	Volley.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(ZBProjectileSweep), false, Instigator);
+	if (bHasAuthority && DamageSpec.IsValid())
+	{
+		Volley.DamageSpec = DamageSpec;
+		Volley.Source = DamageSpec.Data->GetContext().GetInstigatorAbilitySystemComponent();
+		Volley.QueryParams.AddIgnoredActor(DamageSpec.Data->GetContext().GetEffectCauser());
+	}
+	if (!Volley.Source.IsValid())
+	{
+		Volley.Source = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Instigator);
+	}
+	Volley.Shape = FCollisionShape::MakeSphere(Params.Radius);
+	Volley.TraceChannel = Params.TraceChannel;
+	Volley.VisualIndex = bRendersVisuals && Params.Mesh ? FindOrAddVisual(Params.Mesh) : INDEX_NONE;
+	Volley.MeshScale = Params.MeshScale;
+	Volley.ImpactEffect = bRendersVisuals ? Params.ImpactEffect : nullptr;
+	Volley.NumAlive = Count;
+
+	const FVector Direction = Params.Direction.GetSafeNormal(UE_SMALL_NUMBER, FVector::ForwardVector);
+	const bool bFullCircle = Params.SpreadAngle >= 360.f;
+	const float YawStep = Count > 1 ? (bFullCircle ? 360.f / Count : Params.SpreadAngle / (Count - 1)) : 0.f;
+	const float FirstYaw = Count > 1 && !bFullCircle ? -Params.SpreadAngle * 0.5f : 0.f;
+	const float ProjectileGravityZ = World->GetGravityZ() * Params.GravityScale;
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FVector ProjectileDirection = Direction.RotateAngleAxis(FirstYaw + YawStep * Index, FVector::UpVector);
+		Positions.Add(Params.Origin);
+		Velocities.Add(ProjectileDirection * Params.Speed);
+		GravityZ.Add(ProjectileGravityZ);
+		RemainingLifetimes.Add(Params.Lifetime);
+		VolleyIndices.Add(VolleyIndex);
+		ProjectileIds.Add(AllocateProjectileId());
+		Finished.Add(false);
+	}
+
+	if (bHasAuthority && World->GetNetMode() != NM_Standalone)
+	{
+		ReplicateVolley(*World, Params, Instigator);
+	}
+	return Count;
+}
+
+/**
+ * @brief 把一次发射转发给需要看到它的远端玩家
+ * @details 逐个玩家控制器按距离裁剪：发射点距玩家的 Pawn 超过 VisualCullDistance + 飞行距离（Speed * Lifetime）的不发；
+ *          本地控制器（Listen Server 主机）已经在本次发射里渲染过，发射者自己的连接已经本地预测过，都跳过。
+ */
+void UZBProjectileSubsystem::ReplicateVolley(UWorld& World, const FZBProjectileParams& Params, AActor* Instigator) const
+{
+	const APawn* InstigatorPawn = Cast<APawn>(Instigator);
+	const AController* InstigatorController = InstigatorPawn ? InstigatorPawn->GetController() : Cast<AController>(Instigator);
+	const double Range = VisualCullDistance + static_cast<double>(Params.Speed) * Params.Lifetime;
+	const double RangeSquared = FMath::Square(Range);
+
+	for (FConstPlayerControllerIterator It = World.GetPlayerControllerIterator(); It; ++It)
+	{
+		AZBPlayerController* PlayerController = Cast<AZBPlayerController>(It->Get());
+		if (!PlayerController || PlayerController->IsLocalController() || PlayerController == InstigatorController) continue;
+
+		const APawn* ViewPawn = PlayerController->GetPawnOrSpectator();
+		if (!ViewPawn || FVector::DistSquared(ViewPawn->GetActorLocation(), Params.Origin) > RangeSquared) continue;
+
+		PlayerController->ClientFireProjectiles(Params, Instigator);
+	}
+}
+
+void UZBProjectileSubsystem::Tick(float DeltaTime)
+{
+	if (Positions.IsEmpty() && PendingSweeps.IsEmpty()) return;
+
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_ProjectileUpdate);
+
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	CollectSweepResults(*World);
+	ResolveHits();
+	RemoveFinished();
+	IntegrateAndSweep(*World, DeltaTime);
+	UpdateVisuals();
+}
+
+/**
+ * @brief 收取上一帧发出的扫掠结果
+ * @details 扫掠之后投射物没有再移动，下标仍一一对应；命中的投射物停在命中点并标记结束，
+ *          有伤害 Spec 的命中记入本帧命中列表。
+ */
+void UZBProjectileSubsystem::CollectSweepResults(UWorld& World)
+{
+	const bool bRendersVisuals = World.GetNetMode() != NM_DedicatedServer;
+
+	FTraceDatum Datum;
+	for (int32 Index = 0; Index < PendingSweeps.Num(); ++Index)
+	{
+		if (!World.QueryTraceData(PendingSweeps[Index], Datum)) continue;
+		if (Datum.OutHits.IsEmpty() || !Datum.OutHits[0].bBlockingHit) continue;
+
+		const FHitResult& Hit = Datum.OutHits[0];
+		Finished[Index] = true;
+		Positions[Index] = Hit.Location;
+
+		const FVolley& Volley = Volleys[VolleyIndices[Index]];
+		if (bRendersVisuals)
+		{
+			SpawnImpactEffect(Volley, Hit);
+		}
+		if (Volley.DamageSpec.IsValid() && Hit.GetActor())
+		{
+			FProjectileHit& ProjectileHit = FrameHits.AddDefaulted_GetRef();
+			ProjectileHit.VolleyIndex = VolleyIndices[Index];
+			ProjectileHit.ProjectileId = ProjectileIds[Index];
+			ProjectileHit.HitResult = Hit;
+		}
+	}
+	PendingSweeps.Reset();
+}
+
+/**
+ * @brief 统一结算本帧命中
+ * @details 每个命中复制一份批次的 Spec，Context 复制后写入命中结果，HitIndex 取投射物编号，
+ *          同一批次的多个投射物打中同一目标时暴击 / 触发各自独立判定。
+ */
+void UZBProjectileSubsystem::ResolveHits()
+{
+	if (FrameHits.IsEmpty()) return;
+
+	INC_DWORD_STAT_BY(STAT_ZBeta_ProjectileHits, FrameHits.Num());
+
+	for (const FProjectileHit& Hit : FrameHits)
+	{
+		const FVolley& Volley = Volleys[Hit.VolleyIndex];
+		UAbilitySystemComponent* SourceASC = Volley.Source.Get();
+		UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Hit.HitResult.GetActor());
+		if (!SourceASC || !TargetASC) continue;
+
+		FGameplayEffectSpec Spec(*Volley.DamageSpec.Data);
+		FGameplayEffectContextHandle Context = Spec.GetContext().Duplicate();
+		Context.AddHitResult(Hit.HitResult, true);
+		if (FZBGameplayEffectContext* ZBContext = FZBGameplayEffectContext::Get(Context))
+		{
+			ZBContext->HitIndex = Hit.ProjectileId;
+		}
+		Spec.SetContext(Context, true);
+
+		SourceASC->ApplyGameplayEffectSpecToTarget(Spec, TargetASC);
+	}
+	FrameHits.Reset();
+}
+
+/**
+ * @brief 删除已命中或超时的投射物
+ * @details 顺序压缩所有数组（只搬动存活的行），批次的存活数归零时回收。
+ */
+void UZBProjectileSubsystem::RemoveFinished()
+{
+	const int32 Num = Positions.Num();
+	int32 Write = 0;
+	for (int32 Read = 0; Read < Num; ++Read)
+	{
+		if (Finished[Read] || RemainingLifetimes[Read] <= 0.f)
+		{
+			const int32 VolleyIndex = VolleyIndices[Read];
+			if (--Volleys[VolleyIndex].NumAlive == 0)
+			{
+				Volleys[VolleyIndex] = FVolley();
+				FreeVolleys.Add(VolleyIndex);
+			}
+			continue;
+		}
+
+		if (Write != Read)
+		{
+			Positions[Write] = Positions[Read];
+			Velocities[Write] = Velocities[Read];
+			GravityZ[Write] = GravityZ[Read];
+			RemainingLifetimes[Write] = RemainingLifetimes[Read];
+			VolleyIndices[Write] = VolleyIndices[Read];
+			ProjectileIds[Write] = ProjectileIds[Read];
+		}
+		++Write;
+	}
+	if (Write == Num) return;
+
+	Positions.SetNum(Write, EAllowShrinking::No);
+	Velocities.SetNum(Write, EAllowShrinking::No);
+	GravityZ.SetNum(Write, EAllowShrinking::No);
+	RemainingLifetimes.SetNum(Write, EAllowShrinking::No);
+	VolleyIndices.SetNum(Write, EAllowShrinking::No);
+	ProjectileIds.SetNum(Write, EAllowShrinking::No);
+	Finished.Init(false, Write);
+}
+
+/**
+ * @brief 批量移动并发出本帧扫掠
+ * @details 每个投射物一段从上一帧位置到本帧位置的球形异步扫掠（Single，只要第一个阻挡命中），
+ *          整段覆盖飞行路径，高速投射物也不会穿透。
+ */
+void UZBProjectileSubsystem::IntegrateAndSweep(UWorld& World, float DeltaTime)
+{
+	const int32 Num = Positions.Num();
+	PendingSweeps.SetNum(Num, EAllowShrinking::No);
+	int32 NumSweeps = 0;
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		const FVector Start = Positions[Index];
+		Velocities[Index].Z += GravityZ[Index] * DeltaTime;
+		Positions[Index] += Velocities[Index] * DeltaTime;
+		RemainingLifetimes[Index] -= DeltaTime;
+
+		// 本帧已超时：不再扫掠（否则会在超时后造成伤害），下一帧由 RemoveFinished 删除
+		if (RemainingLifetimes[Index] <= 0.f)
+		{
+			PendingSweeps[Index] = FTraceHandle();
+			continue;
+		}
+
+		const FVolley& Volley = Volleys[VolleyIndices[Index]];
+		PendingSweeps[Index] = World.AsyncSweepByChannel(EAsyncTraceType::Single, Start, Positions[Index], FQuat::Identity,
+			Volley.TraceChannel, Volley.Shape, Volley.QueryParams);
+		++NumSweeps;
+	}
+	INC_DWORD_STAT_BY(STAT_ZBeta_ProjectileSweeps, NumSweeps);
+}
+
+/**
+ * @brief 把投射物位置写进实例化网格
+ * @details 按组件分组收集变换；实例数变化时只在末尾增删，随后一次批量更新全部实例。
+ */
+void UZBProjectileSubsystem::UpdateVisuals()
+{
+	if (VisualComponents.IsEmpty()) return;
+
+	VisualTransforms.SetNum(VisualComponents.Num());
+	for (TArray<FTransform>& Transforms : VisualTransforms)
+	{
+		Transforms.Reset();
+	}
+
+	for (int32 Index = 0; Index < Positions.Num(); ++Index)
+	{
+		const FVolley& Volley = Volleys[VolleyIndices[Index]];
+		if (Volley.VisualIndex == INDEX_NONE) continue;
+
+		VisualTransforms[Volley.VisualIndex].Emplace(Velocities[Index].Rotation(), Positions[Index], Volley.MeshScale);
+	}
+
+	for (int32 VisualIndex = 0; VisualIndex < VisualComponents.Num(); ++VisualIndex)
+	{
+		UInstancedStaticMeshComponent* Component = VisualComponents[VisualIndex];
+		const TArray<FTransform>& Transforms = VisualTransforms[VisualIndex];
+		if (!Component) continue;
+
+		const int32 NumInstances = Component->GetInstanceCount();
+		if (Transforms.Num() > NumInstances)
+		{
+			TArray<FTransform> Added(Transforms.GetData() + NumInstances, Transforms.Num() - NumInstances);
+			Component->AddInstances(Added, false, true, false);
+		}
+		else if (Transforms.Num() < NumInstances)
+		{
+			TArray<int32> Removed;
+			for (int32 InstanceIndex = Transforms.Num(); InstanceIndex < NumInstances; ++InstanceIndex)
+			{
+				Removed.Add(InstanceIndex);
+			}
+			Component->RemoveInstances(Removed);
+		}
+
+		if (Transforms.Num() > 0)
+		{
+			Component->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+		}
+	}
+}
+
+int32 UZBProjectileSubsystem::FindOrAddVisual(UStaticMesh* Mesh)
+{
+	for (int32 Index = 0; Index < VisualComponents.Num(); ++Index)
+	{
+		if (VisualComponents[Index] && VisualComponents[Index]->GetStaticMesh() == Mesh)
+		{
+			return Index;
+		}
+	}
+
+	UWorld* World = GetWorld();
+	if (!VisualActor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		VisualActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!VisualActor) return INDEX_NONE;
+	}
+
+	UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(VisualActor, NAME_None, RF_Transient);
+	Component->SetMobility(EComponentMobility::Movable);
+	Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Component->SetCanEverAffectNavigation(false);
+	Component->SetStaticMesh(Mesh);
+	Component->RegisterComponent();
+	VisualActor->AddInstanceComponent(Component);
+
+	return VisualComponents.Add(Component);
+}
+
+void UZBProjectileSubsystem::SpawnImpactEffect(const FVolley& Volley, const FHitResult& Hit) const
+{
+#if !UE_SERVER
+	// 命中特效走 Niagara 的组件池，播完自动归还
+	if (UNiagaraSystem* System = Cast<UNiagaraSystem>(Volley.ImpactEffect.Get()))
+	{
+		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), System, Hit.ImpactPoint, Hit.ImpactNormal.Rotation(),
+			FVector::OneVector, true, true, ENCPoolMethod::AutoRelease);
+	}
+#endif
+}
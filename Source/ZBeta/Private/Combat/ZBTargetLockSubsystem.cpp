@@ -0,0 +1,156 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ZBTargetLockSubsystem.h"
+
+#include "Characters/ZBCharacterBase.h"
+#include "ZBetaStats.h"
+
+bool UZBTargetLockSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// 专用服务器没有锁定视角
+	return Super::ShouldCreateSubsystem(Outer) && !IsRunningDedicatedServer();
+}
+
+bool UZBTargetLockSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UZBTargetLockSubsystem::Deinitialize()
+{
+	Entries.Reset();
+	FreeEntries.Reset();
+	EntryIndexByCharacter.Reset();
+	Cells.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UZBTargetLockSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UZBTargetLockSubsystem, STATGROUP_Tickables);
+}
+
+FIntPoint UZBTargetLockSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void UZBTargetLockSubsystem::RegisterLockable(AZBCharacterBase* Character)
+{
+	if (!Character) return;
+
+	int32& Index = EntryIndexByCharacter.FindOrAdd(Character, INDEX_NONE);
+	if (Index != INDEX_NONE) return;
+
+	Index = FreeEntries.Num() > 0 ? FreeEntries.Pop(EAllowShrinking::No) : Entries.AddDefaulted();
+
+	FEntry& Entry = Entries[Index];
+	Entry.Character = Character;
+	Entry.Key = Character;
+	Entry.IndexedLocation = Character->GetActorLocation();
+	Entry.Cell = GetCell(Entry.IndexedLocation);
+	AddToCell(Index);
+}
+
+void UZBTargetLockSubsystem::UnregisterLockable(AZBCharacterBase* Character)
+{
+	if (const int32* Index = EntryIndexByCharacter.Find(Character))
+	{
+		RemoveEntry(*Index);
+	}
+}
+
+void UZBTargetLockSubsystem::AddToCell(int32 EntryIndex)
+{
+	Cells.FindOrAdd(Entries[EntryIndex].Cell).Add(EntryIndex);
+}
+
+void UZBTargetLockSubsystem::RemoveFromCell(int32 EntryIndex)
+{
+	const FIntPoint Cell = Entries[EntryIndex].Cell;
+	if (TArray<int32>* CellEntries = Cells.Find(Cell))
+	{
+		CellEntries->RemoveSingleSwap(EntryIndex, EAllowShrinking::No);
+		if (CellEntries->IsEmpty())
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void UZBTargetLockSubsystem::RemoveEntry(int32 EntryIndex)
+{
+	RemoveFromCell(EntryIndex);
+	EntryIndexByCharacter.Remove(Entries[EntryIndex].Key);
+	Entries[EntryIndex] = FEntry();
+	FreeEntries.Add(EntryIndex);
+}
+
+/**
+ * @brief 低频检查位置，只有越过移动阈值的角色才更新索引
+ */
+void UZBTargetLockSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate < UpdateInterval || GetNumLockables() == 0) return;
+	TimeSinceUpdate = 0.f;
+
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_TargetLockIndex);
+
+	const double ThresholdSquared = FMath::Square(MoveThreshold);
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		FEntry& Entry = Entries[Index];
+		if (Entry.Key == TObjectKey<AZBCharacterBase>()) continue;
+
+		const AZBCharacterBase* Character = Entry.Character.Get();
+		if (!Character)
+		{
+			RemoveEntry(Index);
+			continue;
+		}
+
+		const FVector Location = Character->GetActorLocation();
+		if (FVector::DistSquared2D(Location, Entry.IndexedLocation) < ThresholdSquared) continue;
+
+		Entry.IndexedLocation = Location;
+		const FIntPoint Cell = GetCell(Location);
+		if (Cell != Entry.Cell)
+		{
+			RemoveFromCell(Index);
+			Entry.Cell = Cell;
+			AddToCell(Index);
+		}
+	}
+}
+
+void UZBTargetLockSubsystem::QueryCandidates(const FVector& Origin, float Radius, TArray<AZBCharacterBase*>& OutCandidates) const
+{
+	const float QueryRadius = Radius + GetIndexSlack();
+	const double QueryRadiusSquared = FMath::Square(QueryRadius);
+	const FIntPoint MinCell = GetCell(Origin - FVector(QueryRadius, QueryRadius, 0.f));
+	const FIntPoint MaxCell = GetCell(Origin + FVector(QueryRadius, QueryRadius, 0.f));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			const TArray<int32>* CellEntries = Cells.Find(FIntPoint(X, Y));
+			if (!CellEntries) continue;
+
+			for (const int32 EntryIndex : *CellEntries)
+			{
+				const FEntry& Entry = Entries[EntryIndex];
+				AZBCharacterBase* Character = Entry.Character.Get();
+				if (Character && FVector::DistSquared2D(Entry.IndexedLocation, Origin) <= QueryRadiusSquared)
+				{
+					OutCandidates.Add(Character);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,86 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ZBTimingWheel.h"
+
+void FZBTimingWheel::Schedule(int32 Id, uint64 DueTick)
+{
+	FEntry Entry;
+	Entry.Id = Id;
+	Entry.DueTick = FMath::Max(DueTick, CurrentTick + 1);
+	Insert(Entry);
+	++NumEntries;
+}
+
+/**
+ * @brief 按距离当前 Tick 的远近放进对应层
+ * @details 第 L 层的槽位由到期 Tick 的第 L 组 6 位决定；超过第 2 层范围的放在第 2 层"最远"的槽位，
+ *          下放时会重新计算，所以不会提前触发。
+ */
+void FZBTimingWheel::Insert(const FEntry& Entry)
+{
+	const uint64 Delta = Entry.DueTick - CurrentTick;
+	for (int32 Level = 0; Level < NumLevels - 1; ++Level)
+	{
+		if (Delta < (uint64(1) << (SlotBits * (Level + 1))))
+		{
+			Slots[Level][(Entry.DueTick >> (SlotBits * Level)) & (NumSlots - 1)].Add(Entry);
+			return;
+		}
+	}
+
+	constexpr int32 TopLevel = NumLevels - 1;
+	const uint64 MaxDelta = (uint64(1) << (SlotBits * NumLevels)) - 1;
+	const uint64 SlotTick = Delta > MaxDelta ? CurrentTick + MaxDelta : Entry.DueTick;
+	Slots[TopLevel][(SlotTick >> (SlotBits * TopLevel)) & (NumSlots - 1)].Add(Entry);
+}
+
+void FZBTimingWheel::Cascade(int32 Level)
+{
+	TArray<FEntry>& Slot = Slots[Level][(CurrentTick >> (SlotBits * Level)) & (NumSlots - 1)];
+	if (Slot.IsEmpty()) return;
+
+	// 先换出再插入，避免同一槽位被重新放回时边遍历边修改
+	TArray<FEntry> Entries = MoveTemp(Slot);
+	Slot.Reset();
+	for (const FEntry& Entry : Entries)
+	{
+		Insert(Entry);
+	}
+}
+
+void FZBTimingWheel::Advance(uint64 ToTick, TArray<FEntry>& OutExpired)
+{
+	while (CurrentTick < ToTick)
+	{
+		// 时间轮为空时直接跳到目标 Tick
+		if (NumEntries == 0)
+		{
+			CurrentTick = ToTick;
+			return;
+		}
+
+		++CurrentTick;
+
+		// 低层转完一圈，把上一层当前槽位下放（先高后低，保证下放的条目能继续落到第 0 层）
+		if ((CurrentTick & (NumSlots - 1)) == 0)
+		{
+			if (((CurrentTick >> SlotBits) & (NumSlots - 1)) == 0)
+			{
+				Cascade(2);
+			}
+			Cascade(1);
+		}
+
+		TArray<FEntry>& Slot = Slots[0][CurrentTick & (NumSlots - 1)];
+		for (int32 Index = Slot.Num() - 1; Index >= 0; --Index)
+		{
+			if (Slot[Index].DueTick <= CurrentTick)
+			{
+				OutExpired.Add(Slot[Index]);
+				Slot.RemoveAtSwap(Index, EAllowShrinking::No);
+				--NumEntries;
+			}
+		}
+	}
+}
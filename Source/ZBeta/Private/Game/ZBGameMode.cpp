@@ -2,3 +2,50 @@
 
 
 #include "Game/ZBGameMode.h"
+
+#include "Asset/ZBAssetManager.h"
+#include "Characters/ZBCharacterBase.h"
+#include "Game/ZBGameState.h"
+#include "Kismet/GameplayStatics.h"
+#include "ZBetaLog.h"
+
+AZBGameMode::AZBGameMode()
+{
+	GameStateClass = AZBGameState::StaticClass();
+}
+
+void AZBGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	// 回放 / 基准测试用 ?Seed= 固定种子，保证暴击与触发逐位复现
+	MatchSeed = UGameplayStatics::HasOption(Options, TEXT("Seed"))
+		? static_cast<uint32>(UGameplayStatics::GetIntOption(Options, TEXT("Seed"), 0))
+		: static_cast<uint32>(FMath::Rand()) ^ FPlatformTime::Cycles();
+
+	// 玩家登录、敌人生成之前先把 Loadout 流送起来；没赶上的在角色初始化时同步加载兜底
+	// 预流送的 Loadout 钉在本世界上，换图前不会因为暂时没有实例而被释放
+	UZBAssetManager& AssetManager = UZBAssetManager::Get();
+	if (DefaultPawnClass && DefaultPawnClass->IsChildOf<AZBCharacterBase>())
+	{
+		const TSoftClassPtr<AZBCharacterBase> PawnClass(DefaultPawnClass.Get());
+		AssetManager.PinCharacterLoadout(GetWorld(), PawnClass);
+		PrestreamHandles.Add(AssetManager.LoadCharacterLoadout(PawnClass));
+	}
+	for (const TSoftClassPtr<AZBCharacterBase>& CharacterClass : PrestreamCharacterClasses)
+	{
+		AssetManager.PinCharacterLoadout(GetWorld(), CharacterClass);
+		PrestreamHandles.Add(AssetManager.LoadCharacterLoadout(CharacterClass));
+	}
+}
+
+void AZBGameMode::InitGameState()
+{
+	Super::InitGameState();
+
+	if (AZBGameState* ZBGameState = GetGameState<AZBGameState>())
+	{
+		ZBGameState->SetMatchSeed(MatchSeed);
+		UE_LOG(LogZBetaNet, Log, TEXT("[GameMode] 对局随机种子：%u"), MatchSeed);
+	}
+}
@@ -0,0 +1,20 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Game/ZBGameState.h"
+
+#include "Net/UnrealNetwork.h"
+
+void AZBGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(AZBGameState, MatchSeed, COND_InitialOnly);
+}
+
+void AZBGameState::SetMatchSeed(uint32 InMatchSeed)
+{
+	if (!HasAuthority()) return;
+
+	MatchSeed = static_cast<int32>(InMatchSeed);
+}
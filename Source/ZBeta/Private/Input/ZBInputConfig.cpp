@@ -3,6 +3,7 @@
 
 #include "Input/ZBInputConfig.h"
 #include "InputAction.h"
+#include "ZBetaLog.h"
 
 const UInputAction* UZBInputConfig::FindAbilityInputActionForTag(const FGameplayTag& InputTag) const
 {
@@ -13,7 +14,7 @@ const UInputAction* UZBInputConfig::FindAbilityInputActionForTag(const FGameplay
 			return Action.InputAction;
 		}
 	}
-		UE_LOG(LogTemp, Error, TEXT("在输入配置[%s]中，找不到与输入标签[%s]对应的输入操作"), *GetNameSafe(this),*InputTag.ToString());
+		UE_LOG(LogZBetaInput, Error, TEXT("在输入配置[%s]中，找不到与输入标签[%s]对应的输入操作"), *GetNameSafe(this),*InputTag.ToString());
 		return nullptr;
 }
 
@@ -26,6 +27,6 @@ FGameplayTag UZBInputConfig::FindTagForInputAction(const UInputAction* InputActi
 			return Action.InputTag;
 		}
 	}
-	UE_LOG(LogTemp, Error, TEXT("在输入配置[%s]中，找不到与输入操作[%s]对应的输入标签"), *GetNameSafe(this),*GetNameSafe(InputAction));
+	UE_LOG(LogZBetaInput, Error, TEXT("在输入配置[%s]中，找不到与输入操作[%s]对应的输入标签"), *GetNameSafe(this),*GetNameSafe(InputAction));
 	return FGameplayTag();
 }
@@ -0,0 +1,177 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Input/ZBInputRecording.h"
+
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "ZBetaLog.h"
+
+void FZBInputRecording::Reset(int32 InRandomSeed)
+{
+	RandomSeed = InRandomSeed;
+	NumFrames = 0;
+	DurationSeconds = 0.f;
+	TagNames.Reset();
+	Tags.Reset();
+	Records.Reset();
+}
+
+void FZBInputRecording::Add(uint32 Frame, EZBRecordedInputType Type, const FVector2D& Axis, const FGameplayTag& InputTag)
+{
+	FZBRecordedInput& Record = Records.AddDefaulted_GetRef();
+	Record.Frame = Frame;
+	Record.Type = Type;
+	Record.Axis = FVector2f(Axis);
+	if (InputTag.IsValid())
+	{
+		Record.TagIndex = FindOrAddTag(InputTag);
+	}
+}
+
+FGameplayTag FZBInputRecording::GetTag(uint16 TagIndex) const
+{
+	return Tags.IsValidIndex(TagIndex) ? Tags[TagIndex] : FGameplayTag();
+}
+
+uint16 FZBInputRecording::FindOrAddTag(const FGameplayTag& InputTag)
+{
+	const int32 ExistingIndex = Tags.IndexOfByKey(InputTag);
+	if (ExistingIndex != INDEX_NONE)
+	{
+		return static_cast<uint16>(ExistingIndex);
+	}
+	TagNames.Add(InputTag.ToString());
+	return static_cast<uint16>(Tags.Add(InputTag));
+}
+
+/**
+ * @brief 读写共用的序列化
+ * @details 帧号按增量写成变长整数，连续帧的移动输入每条只占 1 + 1 + 8 字节。
+ */
+void FZBInputRecording::Serialize(FArchive& Ar)
+{
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	Ar << Magic << Version;
+	if (Ar.IsLoading() && (Magic != FileMagic || Version != FileVersion))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	Ar << RandomSeed << NumFrames << DurationSeconds;
+
+	// 与 Ar << TArray<FString> 同样的格式（int32 数量 + 逐个字符串），但读取时先校验数量再分配
+	int32 NumTagNames = TagNames.Num();
+	Ar << NumTagNames;
+	if (Ar.IsLoading())
+	{
+		const int64 RemainingBytes = Ar.TotalSize() - Ar.Tell();
+		if (Ar.IsError() || NumTagNames < 0 || NumTagNames > MaxTags || static_cast<int64>(NumTagNames) * MinTagNameBytes > RemainingBytes)
+		{
+			Ar.SetError();
+			return;
+		}
+		TagNames.SetNum(NumTagNames);
+	}
+	for (FString& TagName : TagNames)
+	{
+		if (Ar.IsError()) return;
+		Ar << TagName;
+	}
+
+	if (Ar.IsLoading())
+	{
+		Tags.Reset(TagNames.Num());
+		for (const FString& TagName : TagNames)
+		{
+			// 找不到的标签保留为空，回放时跳过对应记录
+			Tags.Add(FGameplayTag::RequestGameplayTag(FName(*TagName), false));
+		}
+	}
+
+	uint32 NumRecords = Records.Num();
+	Ar.SerializeIntPacked(NumRecords);
+	if (Ar.IsLoading())
+	{
+		// 每条记录至少 2 字节（帧增量 + 类型），损坏的记录数不能拿去分配内存
+		const int64 RemainingBytes = Ar.TotalSize() - Ar.Tell();
+		if (Ar.IsError() || static_cast<int64>(NumRecords) * MinRecordBytes > RemainingBytes)
+		{
+			Ar.SetError();
+			return;
+		}
+		Records.SetNum(NumRecords);
+	}
+
+	uint32 PreviousFrame = 0;
+	for (FZBRecordedInput& Record : Records)
+	{
+		if (Ar.IsError()) return;
+
+		uint32 FrameDelta = Record.Frame - PreviousFrame;
+		Ar.SerializeIntPacked(FrameDelta);
+		Record.Frame = PreviousFrame + FrameDelta;
+		PreviousFrame = Record.Frame;
+
+		uint8 Type = static_cast<uint8>(Record.Type);
+		Ar << Type;
+		Record.Type = static_cast<EZBRecordedInputType>(Type);
+
+		switch (Record.Type)
+		{
+		case EZBRecordedInputType::Move:
+		case EZBRecordedInputType::Look:
+			Ar << Record.Axis.X << Record.Axis.Y;
+			break;
+		case EZBRecordedInputType::AbilityPressed:
+		case EZBRecordedInputType::AbilityReleased:
+		case EZBRecordedInputType::AbilityHeld:
+			{
+				uint32 TagIndex = Record.TagIndex;
+				Ar.SerializeIntPacked(TagIndex);
+				Record.TagIndex = static_cast<uint16>(TagIndex);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+bool FZBInputRecording::SaveToFile(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	Serialize(Writer);
+
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Path))
+	{
+		UE_LOG(LogZBetaInput, Error, TEXT("输入录像保存失败：%s"), *Path);
+		return false;
+	}
+	UE_LOG(LogZBetaInput, Display, TEXT("输入录像已保存：%s（%u 帧，%d 条，%d 字节）"), *Path, NumFrames, Records.Num(), Bytes.Num());
+	return true;
+}
+
+bool FZBInputRecording::LoadFromFile(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+	{
+		UE_LOG(LogZBetaInput, Error, TEXT("输入录像读取失败：%s"), *Path);
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	Serialize(Reader);
+	if (Reader.IsError())
+	{
+		UE_LOG(LogZBetaInput, Error, TEXT("输入录像格式或版本不匹配，或文件已损坏：%s"), *Path);
+		Reset(0);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,147 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Interaction/ZBInteractableComponent.h"
+
+#include "GameFramework/Pawn.h"
+#include "Player/ZBInteractionComponent.h"
+#include "Player/ZBPlayerController.h"
+
+UZBInteractableComponent::UZBInteractableComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	InitSphereRadius(200.f);
+	SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	SetCollisionObjectType(ECC_WorldDynamic);
+	SetCollisionResponseToAllChannels(ECR_Ignore);
+	SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+	SetGenerateOverlapEvents(true);
+	SetCanEverAffectNavigation(false);
+}
+
+void UZBInteractableComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// 专用服务器只按距离校验交互请求，不维护候选
+	if (IsNetMode(NM_DedicatedServer))
+	{
+		SetGenerateOverlapEvents(false);
+		return;
+	}
+
+	OnComponentBeginOverlap.AddDynamic(this, &UZBInteractableComponent::OnPawnBeginOverlap);
+	OnComponentEndOverlap.AddDynamic(this, &UZBInteractableComponent::OnPawnEndOverlap);
+}
+
+void UZBInteractableComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// RemoveCandidate 不会回调本对象，可以直接遍历
+	for (const FWatcher& Watcher : Watchers)
+	{
+		if (UZBInteractionComponent* InteractionComponent = Watcher.InteractionComponent.Get())
+		{
+			InteractionComponent->RemoveCandidate(this);
+		}
+	}
+	Watchers.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+UZBInteractionComponent* UZBInteractableComponent::FindInteractionComponent(const AActor* Actor)
+{
+	const APawn* Pawn = Cast<APawn>(Actor);
+	if (!Pawn || !Pawn->IsLocallyControlled()) return nullptr;
+
+	const AZBPlayerController* PlayerController = Cast<AZBPlayerController>(Pawn->GetController());
+	return PlayerController ? PlayerController->GetInteractionComponent() : nullptr;
+}
+
+void UZBInteractableComponent::OnPawnBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (UZBInteractionComponent* InteractionComponent = FindInteractionComponent(OtherActor))
+	{
+		AddWatcher(InteractionComponent, CastChecked<APawn>(OtherActor));
+	}
+}
+
+void UZBInteractableComponent::OnPawnEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	// Pawn 有多个 Pawn 通道的形体时，全部离开才移除
+	if (!OtherActor || IsOverlappingActor(OtherActor)) return;
+
+	// 按登记时的 Pawn 匹配：离开时 Pawn 可能已经与控制器分离（死亡 / 销毁），不能再按本地控制查找
+	const TObjectKey<AActor> PawnKey(OtherActor);
+	for (int32 Index = Watchers.Num() - 1; Index >= 0; --Index)
+	{
+		if (Watchers[Index].Pawn != PawnKey) continue;
+
+		UZBInteractionComponent* InteractionComponent = Watchers[Index].InteractionComponent.Get();
+		Watchers.RemoveAtSwap(Index, EAllowShrinking::No);
+		if (InteractionComponent)
+		{
+			InteractionComponent->RemoveCandidate(this);
+		}
+	}
+}
+
+void UZBInteractableComponent::AddWatcher(UZBInteractionComponent* InteractionComponent, const APawn* Pawn)
+{
+	if (!InteractionComponent) return;
+
+	FWatcher* Existing = Watchers.FindByPredicate([InteractionComponent](const FWatcher& Watcher)
+	{
+		return Watcher.InteractionComponent == InteractionComponent;
+	});
+	if (Existing)
+	{
+		Existing->Pawn = TObjectKey<AActor>(Pawn);
+	}
+	else
+	{
+		Watchers.Add({ InteractionComponent, TObjectKey<AActor>(Pawn) });
+	}
+	InteractionComponent->AddCandidate(this);
+}
+
+void UZBInteractableComponent::RemoveWatcher(UZBInteractionComponent* InteractionComponent)
+{
+	Watchers.RemoveAllSwap([InteractionComponent](const FWatcher& Watcher)
+	{
+		return Watcher.InteractionComponent == InteractionComponent;
+	}, EAllowShrinking::No);
+}
+
+void UZBInteractableComponent::NotifyWatchers() const
+{
+	for (const FWatcher& Watcher : Watchers)
+	{
+		if (UZBInteractionComponent* InteractionComponent = Watcher.InteractionComponent.Get())
+		{
+			InteractionComponent->OnCandidateChanged();
+		}
+	}
+}
+
+void UZBInteractableComponent::SetPrompt(const FZBInteractionPrompt& NewPrompt)
+{
+	Prompt = NewPrompt;
+	NotifyWatchers();
+}
+
+void UZBInteractableComponent::SetInteractionEnabled(bool bEnabled)
+{
+	if (bInteractionEnabled == bEnabled) return;
+
+	bInteractionEnabled = bEnabled;
+	NotifyWatchers();
+}
+
+void UZBInteractableComponent::Interact(APawn* InstigatorPawn)
+{
+	if (!bInteractionEnabled || !GetOwner()->HasAuthority()) return;
+
+	OnInteract.Broadcast(InstigatorPawn);
+}
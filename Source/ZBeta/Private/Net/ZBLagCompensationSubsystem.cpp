@@ -0,0 +1,374 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/ZBLagCompensationSubsystem.h"
+
+#include "AbilitySystemGlobals.h"
+#include "AbilitySystem/ZBAbilitySystemComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "ZBetaLog.h"
+#include "ZBetaStats.h"
+
+bool UZBLagCompensationSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// 只有服务器需要历史
+	return Super::ShouldCreateSubsystem(Outer) && !IsRunningClientOnly();
+}
+
+bool UZBLagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UZBLagCompensationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	HistorySamples = FMath::Max(HistorySamples, 2);
+	ActivationCheckInterval = FMath::Max(ActivationCheckInterval, 0.f);
+	if (Hitboxes.Num() > MaxHitboxes)
+	{
+		UE_LOG(LogZBetaNet, Warning, TEXT("延迟补偿判定球配置了 %d 个，只使用前 %d 个"), Hitboxes.Num(), MaxHitboxes);
+		Hitboxes.SetNum(MaxHitboxes);
+	}
+}
+
+void UZBLagCompensationSubsystem::Deinitialize()
+{
+	Histories.Reset();
+	HistoryIndexByActor.Reset();
+	PlayerLocations.Reset();
+	PendingRequests.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UZBLagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UZBLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+/**
+ * @brief 注册角色并一次性分配它的环形历史
+ * @details 判定球骨骼下标在这里解析并缓存，之后每次采样直接按下标取骨骼变换。
+ *          注册后先不采样，下一次 UpdateActivation 按与玩家的距离决定。
+ */
+void UZBLagCompensationSubsystem::RegisterCharacter(ACharacter* Character)
+{
+	if (!Character || HistoryIndexByActor.Contains(Character)) return;
+
+	const int32 Index = Histories.AddDefaulted();
+	FHistory& History = Histories[Index];
+	History.Character = Character;
+	History.Key = Character;
+	History.Poses.Init(HistorySamples, Hitboxes.Num());
+
+	USkeletalMeshComponent* Mesh = Character->GetMesh();
+	for (const FZBHitboxDefinition& Hitbox : Hitboxes)
+	{
+		History.BoneIndices.Add(Mesh ? Mesh->GetBoneIndex(Hitbox.Bone) : INDEX_NONE);
+	}
+
+	HistoryIndexByActor.Add(Character, Index);
+
+	// 下一帧立即重新判定，不等满一个检查间隔
+	LastActivationCheckTime = -UE_BIG_NUMBER;
+}
+
+void UZBLagCompensationSubsystem::UnregisterCharacter(ACharacter* Character)
+{
+	if (const int32* Index = HistoryIndexByActor.Find(Character))
+	{
+		RemoveHistoryAt(*Index);
+	}
+}
+
+void UZBLagCompensationSubsystem::RemoveHistoryAt(int32 Index)
+{
+	SetHistoryActive(Histories[Index], false);
+	HistoryIndexByActor.Remove(Histories[Index].Key);
+
+	// 与末尾交换删除，修正被移动的那一项的下标
+	Histories.RemoveAtSwap(Index);
+	if (Histories.IsValidIndex(Index))
+	{
+		HistoryIndexByActor.Add(Histories[Index].Key, Index);
+	}
+}
+
+void UZBLagCompensationSubsystem::QueueValidation(FZBRewindRequest&& Request)
+{
+	INC_DWORD_STAT(STAT_ZBeta_LagCompRequests);
+	PendingRequests.Add(MoveTemp(Request));
+}
+
+bool UZBLagCompensationSubsystem::EstimateClientViewTime(const APlayerController* PlayerController, double ClientTime, double& OutViewTime) const
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (!PlayerController || PlayerController->IsLocalController() || !PlayerController->PlayerState)
+	{
+		OutViewTime = Now;
+		return true;
+	}
+
+	// Ping 是往返时间，客户端画面是它发请求时半个往返之前的服务器状态，再加上模拟端插值的显示延迟
+	const double OneWaySeconds = PlayerController->PlayerState->GetPingInMilliseconds() * 0.5 / 1000.0;
+	OutViewTime = FMath::Min(ClientTime - OneWaySeconds - SimulatedProxyDelaySeconds, Now);
+	if (!IsWithinRewindWindow(OutViewTime))
+	{
+		UE_LOG(LogZBetaNet, Verbose, TEXT("拒绝过旧的客户端时间戳：%s 回溯 %.3f 秒"), *GetNameSafe(PlayerController), Now - OutViewTime);
+		return false;
+	}
+	return true;
+}
+
+bool UZBLagCompensationSubsystem::IsWithinRewindWindow(double Time) const
+{
+	return Time >= GetWorld()->GetTimeSeconds() - MaxRewindSeconds;
+}
+
+SIZE_T UZBLagCompensationSubsystem::GetAllocatedSize() const
+{
+	SIZE_T Size = Histories.GetAllocatedSize() + HistoryIndexByActor.GetAllocatedSize() + PendingRequests.GetAllocatedSize();
+	for (const FHistory& History : Histories)
+	{
+		Size += History.Poses.GetAllocatedSize() + History.BoneIndices.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void UZBLagCompensationSubsystem::Tick(float DeltaTime)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	if (Now - LastActivationCheckTime >= ActivationCheckInterval)
+	{
+		UpdateActivation();
+		LastActivationCheckTime = Now;
+	}
+
+	// 可 Tick 对象在所有 Tick 组之后更新，采到的是本帧移动与动画的最终结果
+	if (Now - LastSampleTime >= MinSampleInterval)
+	{
+		RecordFrame(Now);
+		LastSampleTime = Now;
+	}
+
+	if (!PendingRequests.IsEmpty())
+	{
+		ProcessValidationRequests(Now);
+	}
+}
+
+void UZBLagCompensationSubsystem::RecordFrame(double Now)
+{
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_LagCompRecord);
+
+	for (int32 Index = Histories.Num() - 1; Index >= 0; --Index)
+	{
+		if (!Histories[Index].Character.IsValid())
+		{
+			// 没走 EndPlay 就被销毁的角色
+			RemoveHistoryAt(Index);
+			continue;
+		}
+		if (Histories[Index].bActive)
+		{
+			RecordCharacter(Histories[Index], Now);
+		}
+	}
+}
+
+/**
+ * @brief 只为玩家角色与玩家附近的角色采样
+ * @details 玩家角色始终采样（玩家之间的命中）；其余角色距最近的玩家角色不超过 ActivationRadius 才采样。
+ *          每次检查是 玩家数 x 角色数 次距离比较，按 ActivationCheckInterval 低频执行。
+ */
+void UZBLagCompensationSubsystem::UpdateActivation()
+{
+	PlayerLocations.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (const APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr)
+		{
+			PlayerLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	const double RadiusSquared = FMath::Square(static_cast<double>(ActivationRadius));
+	for (FHistory& History : Histories)
+	{
+		const ACharacter* Character = History.Character.Get();
+		if (!Character) continue;
+
+		bool bActive = Character->IsPlayerControlled();
+		if (!bActive)
+		{
+			const FVector Location = Character->GetActorLocation();
+			for (const FVector& PlayerLocation : PlayerLocations)
+			{
+				if (FVector::DistSquared(Location, PlayerLocation) <= RadiusSquared)
+				{
+					bActive = true;
+					break;
+				}
+			}
+		}
+		SetHistoryActive(History, bActive);
+	}
+}
+
+void UZBLagCompensationSubsystem::SetHistoryActive(FHistory& History, bool bActive) const
+{
+	if (History.bActive == bActive) return;
+	History.bActive = bActive;
+
+	// 停止采样的历史清空：再开始时不能和中断前的采样拼接插值
+	History.Poses.Reset();
+
+	USkeletalMeshComponent* Mesh = History.Character.IsValid() ? History.Character->GetMesh() : nullptr;
+	if (!Mesh || Hitboxes.IsEmpty()) return;
+
+	// 专用服务器没有渲染，默认的可见性动画选项不刷新骨骼，判定球会一直停在旧姿态；只在采样期间强制刷新
+	if (bActive)
+	{
+		History.SavedAnimTickOption = Mesh->VisibilityBasedAnimTickOption;
+		Mesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	}
+	else
+	{
+		Mesh->VisibilityBasedAnimTickOption = History.SavedAnimTickOption;
+	}
+}
+
+void UZBLagCompensationSubsystem::RecordCharacter(FHistory& History, double Now) const
+{
+	const ACharacter* Character = History.Character.Get();
+	const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+	const USkeletalMeshComponent* Mesh = Character->GetMesh();
+
+	FZBPoseHistory::FSample Sample;
+	Sample.Time = Now;
+	Sample.Location = Capsule->GetComponentLocation();
+	Sample.Rotation = Capsule->GetComponentQuat();
+	Sample.CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+	Sample.CapsuleHalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+
+	const UZBAbilitySystemComponent* ASC = Cast<UZBAbilitySystemComponent>(UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Character));
+	Sample.StateTagMask = ASC ? ASC->GetStateTagMask() : 0;
+
+	const TArrayView<FVector> HitboxLocations = History.Poses.AddSample(Sample);
+	for (int32 Hitbox = 0; Hitbox < HitboxLocations.Num(); ++Hitbox)
+	{
+		const int32 BoneIndex = History.BoneIndices[Hitbox];
+		HitboxLocations[Hitbox] = (Mesh && BoneIndex != INDEX_NONE) ? Mesh->GetBoneTransform(BoneIndex).GetLocation() : Sample.Location;
+	}
+}
+
+bool UZBLagCompensationSubsystem::RewindCharacter(const AActor* Character, double Time, FZBRewoundCharacter& OutPose) const
+{
+	const int32* Index = HistoryIndexByActor.Find(Character);
+	if (!Index || !IsWithinRewindWindow(Time)) return false;
+
+	return Histories[*Index].Poses.Rewind(FMath::Min(Time, GetWorld()->GetTimeSeconds()), OutPose);
+}
+
+/**
+ * @brief 批量处理本帧的校验请求
+ * @details 同一目标同一时刻只回溯一次（多名玩家对同一 Boss 的命中通常落在相近的几个时间戳上）；
+ *          早于 MaxRewindSeconds 的请求不回溯，以 bRewound = false 回调；
+ *          全部判定完成后才依次回调，回调里再入队的请求留到下一帧。
+ */
+void UZBLagCompensationSubsystem::ProcessValidationRequests(double Now)
+{
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_LagCompValidate);
+
+	TArray<FZBRewindRequest> Requests = MoveTemp(PendingRequests);
+	PendingRequests.Reset();
+
+	const double OldestAllowed = Now - MaxRewindSeconds;
+	TMap<TPair<int32, double>, FZBRewoundCharacter> RewindCache;
+	TArray<FZBRewindResult> Results;
+	Results.SetNum(Requests.Num());
+
+	for (int32 RequestIndex = 0; RequestIndex < Requests.Num(); ++RequestIndex)
+	{
+		const FZBRewindRequest& Request = Requests[RequestIndex];
+		const int32* HistoryIndex = HistoryIndexByActor.Find(Request.Target.Get());
+		if (!HistoryIndex) continue;
+
+		// 过旧的时间戳拒绝而不是夹取，bRewound 保持 false
+		if (Request.Time < OldestAllowed) continue;
+
+		const double Time = FMath::Min(Request.Time, Now);
+		const TPair<int32, double> Key(*HistoryIndex, Time);
+		FZBRewoundCharacter* Pose = RewindCache.Find(Key);
+		if (!Pose)
+		{
+			FZBRewoundCharacter NewPose;
+			if (!Histories[*HistoryIndex].Poses.Rewind(Time, NewPose)) continue;
+			Pose = &RewindCache.Add(Key, MoveTemp(NewPose));
+		}
+
+		EvaluateRequest(Request, *Pose, Results[RequestIndex]);
+	}
+
+	for (int32 RequestIndex = 0; RequestIndex < Requests.Num(); ++RequestIndex)
+	{
+		if (Requests[RequestIndex].OnValidated)
+		{
+			Requests[RequestIndex].OnValidated(Results[RequestIndex]);
+		}
+	}
+}
+
+/**
+ * @brief 用回溯姿态做几何判定
+ * @details 胶囊是粗判：扫掠线段到胶囊轴线的距离不超过两者半径之和（再加上最大判定球半径，手臂可能伸出胶囊）；
+ *          配置了判定球时以距离扫掠线段最近的相交判定球为准。
+ */
+void UZBLagCompensationSubsystem::EvaluateRequest(const FZBRewindRequest& Request, const FZBRewoundCharacter& Pose, FZBRewindResult& OutResult) const
+{
+	OutResult.bRewound = true;
+	OutResult.Pose = Pose;
+
+	float MaxHitboxRadius = 0.f;
+	for (const FZBHitboxDefinition& Hitbox : Hitboxes)
+	{
+		MaxHitboxRadius = FMath::Max(MaxHitboxRadius, Hitbox.Radius);
+	}
+
+	const FVector Axis = Pose.Rotation.GetUpVector() * FMath::Max(Pose.CapsuleHalfHeight - Pose.CapsuleRadius, 0.f);
+	FVector OnCapsule, OnTrace;
+	FMath::SegmentDistToSegmentSafe(Pose.Location - Axis, Pose.Location + Axis, Request.TraceStart, Request.TraceEnd, OnCapsule, OnTrace);
+	const float CapsuleDistance = FVector::Dist(OnCapsule, OnTrace);
+	if (CapsuleDistance > Pose.CapsuleRadius + Request.TraceRadius + MaxHitboxRadius)
+	{
+		return;
+	}
+
+	if (Pose.HitboxLocations.IsEmpty())
+	{
+		OutResult.bHit = CapsuleDistance <= Pose.CapsuleRadius + Request.TraceRadius;
+		return;
+	}
+
+	float BestPenetration = 0.f;
+	for (int32 Hitbox = 0; Hitbox < Pose.HitboxLocations.Num(); ++Hitbox)
+	{
+		const float Distance = FMath::PointDistToSegment(Pose.HitboxLocations[Hitbox], Request.TraceStart, Request.TraceEnd);
+		const float Penetration = Hitboxes[Hitbox].Radius + Request.TraceRadius - Distance;
+		if (Penetration >= 0.f && (!OutResult.bHit || Penetration > BestPenetration))
+		{
+			OutResult.bHit = true;
+			OutResult.HitboxIndex = Hitbox;
+			BestPenetration = Penetration;
+		}
+	}
+}
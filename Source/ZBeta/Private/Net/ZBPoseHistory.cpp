@@ -0,0 +1,103 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/ZBPoseHistory.h"
+
+#include "AbilitySystem/ZBStateTagIndex.h"
+
+bool FZBRewoundCharacter::HadStateTag(const FGameplayTag& Tag) const
+{
+	const int32 Index = FZBStateTagIndex::Get().IndexOf(Tag);
+	return Index != INDEX_NONE && (StateTagMask & (uint64(1) << Index)) != 0;
+}
+
+void FZBPoseHistory::Init(int32 NumSamples, int32 InNumHitboxes)
+{
+	NumHitboxes = FMath::Max(InNumHitboxes, 0);
+	Samples.SetNum(FMath::Max(NumSamples, 1));
+	HitboxLocations.SetNumZeroed(Samples.Num() * NumHitboxes);
+	Head = 0;
+	NumWritten = 0;
+}
+
+TArrayView<FVector> FZBPoseHistory::AddSample(const FSample& Sample)
+{
+	check(!Samples.IsEmpty());
+
+	const int32 Index = Head;
+	Samples[Index] = Sample;
+
+	Head = (Head + 1) % Samples.Num();
+	NumWritten = FMath::Min(NumWritten + 1, Samples.Num());
+
+	return TArrayView<FVector>(HitboxLocations.GetData() + Index * NumHitboxes, NumHitboxes);
+}
+
+/**
+ * @brief 在历史中回溯到 Time
+ *
+ * 详细流程：
+ *   1. 二分查找最后一个时间不晚于 Time 的采样（Older）；
+ *   2. 早于最老采样 / 晚于最新采样时直接取端点；
+ *   3. 否则与下一个采样（Newer）按时间比例插值：位置、胶囊尺寸、判定球线性插值，朝向球面插值；
+ *   4. 标签掩码取 Older：窗口在 Older 与 Newer 之间关闭的，回溯到这段时间仍视为打开，反之亦然。
+ */
+bool FZBPoseHistory::Rewind(double Time, FZBRewoundCharacter& OutPose) const
+{
+	if (NumWritten == 0) return false;
+
+	int32 Low = 0;
+	int32 High = NumWritten - 1;
+	if (Time <= Samples[ToPhysical(0)].Time)
+	{
+		High = 0;
+	}
+	else
+	{
+		// 循环不变量：Samples[Low].Time <= Time
+		while (Low < High)
+		{
+			const int32 Mid = (Low + High + 1) / 2;
+			if (Samples[ToPhysical(Mid)].Time <= Time)
+			{
+				Low = Mid;
+			}
+			else
+			{
+				High = Mid - 1;
+			}
+		}
+	}
+
+	const int32 OlderIndex = ToPhysical(Low);
+	const FSample& Older = Samples[OlderIndex];
+	const FVector* OlderHitboxes = HitboxLocations.GetData() + OlderIndex * NumHitboxes;
+
+	OutPose.StateTagMask = Older.StateTagMask;
+	OutPose.HitboxLocations.SetNumUninitialized(NumHitboxes);
+
+	if (Low + 1 >= NumWritten || Time <= Older.Time)
+	{
+		OutPose.Location = Older.Location;
+		OutPose.Rotation = Older.Rotation;
+		OutPose.CapsuleRadius = Older.CapsuleRadius;
+		OutPose.CapsuleHalfHeight = Older.CapsuleHalfHeight;
+		FMemory::Memcpy(OutPose.HitboxLocations.GetData(), OlderHitboxes, NumHitboxes * sizeof(FVector));
+		return true;
+	}
+
+	const int32 NewerIndex = ToPhysical(Low + 1);
+	const FSample& Newer = Samples[NewerIndex];
+	const FVector* NewerHitboxes = HitboxLocations.GetData() + NewerIndex * NumHitboxes;
+	const float Alpha = static_cast<float>((Time - Older.Time) / FMath::Max(Newer.Time - Older.Time, UE_DOUBLE_SMALL_NUMBER));
+
+	OutPose.Location = FMath::Lerp(Older.Location, Newer.Location, Alpha);
+	OutPose.Rotation = FQuat::Slerp(Older.Rotation, Newer.Rotation, Alpha);
+	OutPose.CapsuleRadius = FMath::Lerp(Older.CapsuleRadius, Newer.CapsuleRadius, Alpha);
+	OutPose.CapsuleHalfHeight = FMath::Lerp(Older.CapsuleHalfHeight, Newer.CapsuleHalfHeight, Alpha);
+	for (int32 Hitbox = 0; Hitbox < NumHitboxes; ++Hitbox)
+	{
+		OutPose.HitboxLocations[Hitbox] = FMath::Lerp(OlderHitboxes[Hitbox], NewerHitboxes[Hitbox], Alpha);
+	}
+	return true;
+}
@@ -0,0 +1,272 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/ZBReplicationGraph.h"
+
+#include "Characters/ZBEnemyCharacter.h"
+#include "Characters/ZBPlayerCharacter.h"
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "ReplicationGraphTypes.h"
+#include "UObject/UObjectIterator.h"
+
+
+// ==================== 每连接节点 ====================
+
+void UZBReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	// 找到这个连接自己的 PlayerState
+	AActor* CurrentPlayerState = nullptr;
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		if (const APlayerController* PC = Cast<APlayerController>(Viewer.InViewer))
+		{
+			CurrentPlayerState = PC->PlayerState;
+			break;
+		}
+	}
+
+	// PlayerState 变化（重连 / 切换 / 销毁）时更新列表
+	if (CurrentPlayerState != LastPlayerState || (LastPlayerState && !LastPlayerStateWeak.IsValid()))
+	{
+		if (LastPlayerState)
+		{
+			ReplicationActorList.RemoveFast(LastPlayerState);
+		}
+		if (CurrentPlayerState)
+		{
+			ReplicationActorList.Add(CurrentPlayerState);
+		}
+		LastPlayerState = CurrentPlayerState;
+		LastPlayerStateWeak = CurrentPlayerState;
+	}
+
+	// 基类会追加 PlayerController / ViewTarget 并把 ReplicationActorList 输出
+	Super::GatherActorListsForConnection(Params);
+}
+
+
+// ==================== 复制图 ====================
+
+UZBReplicationGraph::UZBReplicationGraph()
+{
+}
+
+/**
+ * @brief 初始化类路由表与每个可复制类的复制参数
+ *
+ * 详细流程：
+ *   1. 显式设置 ZBeta 关心的类的路由；
+ *   2. 遍历所有可复制 Actor 类，未显式设置的按 CDO 推导路由；
+ *   3. 为每个类写入 FClassReplicationInfo（复制周期帧数、裁剪距离），敌人及其子类使用 EnemyCullDistance。
+ *
+ * 注意事项：
+ *   - 此时还没加载的蓝图子类在首次查询时沿用最近的已设置父类的信息，AZBEnemyCharacter 本身总会设置。
+ */
+void UZBReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// 1. 显式路由
+	ClassRepNodePolicies.Set(AReplicationGraphDebugActor::StaticClass(), EZBClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EZBClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EZBClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EZBClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AInfo::StaticClass(), EZBClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(AZBPlayerCharacter::StaticClass(), EZBClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AZBEnemyCharacter::StaticClass(), EZBClassRepNodeMapping::Spatialize_Dormancy);
+
+	// 2. 遍历所有可复制类
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+		if (!ActorCDO || !ActorCDO->GetIsReplicated())
+		{
+			continue;
+		}
+
+		// 跳过蓝图编译的中间类
+		const FString ClassName = Class->GetName();
+		if (ClassName.StartsWith(TEXT("SKEL_")) || ClassName.StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		const EZBClassRepNodeMapping Policy = GetMappingPolicy(Class);
+		const bool bSpatialize = Policy == EZBClassRepNodeMapping::Spatialize_Static
+			|| Policy == EZBClassRepNodeMapping::Spatialize_Dynamic
+			|| Policy == EZBClassRepNodeMapping::Spatialize_Dormancy;
+
+		FClassReplicationInfo ClassInfo;
+		InitClassReplicationInfo(ClassInfo, Class, bSpatialize);
+
+		// 3. 敌人（含蓝图子类）使用单独的裁剪距离
+		if (Class->IsChildOf(AZBEnemyCharacter::StaticClass()))
+		{
+			ClassInfo.SetCullDistanceSquared(EnemyCullDistance * EnemyCullDistance);
+		}
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UZBReplicationGraph::InitGlobalGraphNodes()
+{
+	// 空间网格：敌人和玩家角色
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = SpatialBias;
+
+	if (bUseDynamicSpatialFrequency)
+	{
+		// 每个格子的动态节点改为按距离 / 视角分频：近处满频，远处降频
+		GridNode->CreateCellNodeOverride = [](UReplicationGraphNode_GridCell* NewCell)
+		{
+			NewCell->CreateDynamicNodeOverride = [](UReplicationGraphNode_GridCell* Parent) -> UReplicationGraphNode*
+			{
+				return Parent->CreateChildNode<UReplicationGraphNode_DynamicSpatialFrequency>();
+			};
+		};
+	}
+	AddGlobalGraphNode(GridNode);
+
+	// 全局总是相关
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	// PlayerState 对非拥有者分批低频复制
+	PlayerStateNode = CreateNewNode<UReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	AddGlobalGraphNode(PlayerStateNode);
+}
+
+void UZBReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	UZBReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnection = CreateNewNode<UZBReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(AlwaysRelevantForConnection, RepGraphConnection);
+}
+
+void UZBReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EZBClassRepNodeMapping::NotRouted:
+		break;
+	case EZBClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EZBClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EZBClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EZBClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	}
+}
+
+void UZBReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EZBClassRepNodeMapping::NotRouted:
+		break;
+	case EZBClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EZBClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EZBClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EZBClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	}
+}
+
+EZBClassRepNodeMapping UZBReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	// 显式设置（含父类）优先
+	if (const EZBClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class))
+	{
+		return *Policy;
+	}
+
+	const AActor* ActorCDO = Class ? Cast<AActor>(Class->GetDefaultObject()) : nullptr;
+	if (!ActorCDO)
+	{
+		return EZBClassRepNodeMapping::NotRouted;
+	}
+
+	EZBClassRepNodeMapping Policy;
+	if (ActorCDO->bOnlyRelevantToOwner)
+	{
+		// 只对拥有者相关的 Actor 由每连接节点处理
+		Policy = EZBClassRepNodeMapping::NotRouted;
+	}
+	else if (ActorCDO->bAlwaysRelevant)
+	{
+		Policy = EZBClassRepNodeMapping::RelevantAllConnections;
+	}
+	else if (ActorCDO->NetDormancy > DORM_Awake)
+	{
+		Policy = EZBClassRepNodeMapping::Spatialize_Dormancy;
+	}
+	else if (ActorCDO->GetRootComponent() && ActorCDO->GetRootComponent()->Mobility == EComponentMobility::Static)
+	{
+		Policy = EZBClassRepNodeMapping::Spatialize_Static;
+	}
+	else
+	{
+		Policy = EZBClassRepNodeMapping::Spatialize_Dynamic;
+	}
+
+	ClassRepNodePolicies.Set(Class, Policy);
+	return Policy;
+}
+
+void UZBReplicationGraph::InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const
+{
+	const AActor* ActorCDO = Class->GetDefaultObject<AActor>();
+	if (bSpatialize)
+	{
+		Info.SetCullDistanceSquared(ActorCDO->GetNetCullDistanceSquared());
+	}
+
+	Info.ReplicationPeriodFrame = GetReplicationPeriodFrame(ActorCDO->GetNetUpdateFrequency());
+}
+
+int32 UZBReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	const double StartSeconds = FPlatformTime::Seconds();
+	const int32 NumReplicated = Super::ServerReplicateActors(DeltaSeconds);
+	LastReplicateSeconds = FPlatformTime::Seconds() - StartSeconds;
+	return NumReplicated;
+}
+
+uint32 UZBReplicationGraph::GetReplicationPeriodFrame(float NetUpdateFrequency) const
+{
+	const float ServerTickRate = NetDriver ? NetDriver->GetNetServerMaxTickRate() : 30.f;
+	return FMath::Max<uint32>(FMath::RoundToInt(ServerTickRate / FMath::Max(NetUpdateFrequency, 1.f)), 1);
+}
+
+void UZBReplicationGraph::NotifyNetUpdateFrequencyChanged(AActor* Actor)
+{
+	const UNetDriver* ActorNetDriver = Actor ? Actor->GetNetDriver() : nullptr;
+	UZBReplicationGraph* Graph = ActorNetDriver ? Cast<UZBReplicationGraph>(ActorNetDriver->GetReplicationDriver()) : nullptr;
+	if (!Graph) return;
+
+	// 还没加入复制图的 Actor 在加入时按类信息初始化，BeginPlay 里的调用会再覆盖一次
+	if (FGlobalActorReplicationInfo* GlobalInfo = Graph->GlobalActorReplicationInfoMap.Find(Actor))
+	{
+		GlobalInfo->Settings.ReplicationPeriodFrame = Graph->GetReplicationPeriodFrame(Actor->GetNetUpdateFrequency());
+	}
+}
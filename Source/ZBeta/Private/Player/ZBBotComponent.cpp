@@ -0,0 +1,268 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Player/ZBBotComponent.h"
+
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "Engine/Engine.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Player/ZBPlayerController.h"
+#include "ZBetaLog.h"
+
+UZBBotComponent::UZBBotComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+AZBPlayerController* UZBBotComponent::GetZBController() const
+{
+	return GetOuterAZBPlayerController();
+}
+
+void UZBBotComponent::ParseCommandLine()
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	int32 Seed = static_cast<int32>(FPlatformProcess::GetCurrentProcessId());
+	FParse::Value(CommandLine, TEXT("ZBBotSeed="), Seed);
+	RandomStream.Initialize(Seed);
+
+	FParse::Value(CommandLine, TEXT("ZBBotDuration="), DurationSeconds);
+
+	// 机器人不需要高帧率，限帧让单机能跑更多进程
+	int32 MaxFPS = 30;
+	FParse::Value(CommandLine, TEXT("ZBBotFPS="), MaxFPS);
+	if (GEngine && MaxFPS > 0)
+	{
+		GEngine->SetMaxFPS(static_cast<float>(MaxFPS));
+	}
+
+	if (!FParse::Value(CommandLine, TEXT("ZBBotCsv="), CsvPath))
+	{
+		CsvPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("Bots") / FString::Printf(TEXT("ZBBot_%u.csv"), FPlatformProcess::GetCurrentProcessId());
+	}
+}
+
+void UZBBotComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ParseCommandLine();
+	StartTime = FPlatformTime::Seconds();
+	LastReportTime = StartTime;
+	CurrentStep = EZBBotStep::Rune;
+	AdvanceStep();
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(CsvPath), true);
+	FFileHelper::SaveStringToFile(TEXT("Seconds,PingMs,Corrections,InBytesPerSec,OutBytesPerSec\n"), *CsvPath);
+
+	UE_LOG(LogZBetaBenchmark, Display, TEXT("[ZBBot] 机器人模式启动，报告：%s"), *CsvPath);
+}
+
+void UZBBotComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (NumReports > 0)
+	{
+		UE_LOG(LogZBetaBenchmark, Display, TEXT("[ZBBot] 汇总：平均 RTT %.1fms，最大 RTT %.1fms，位置纠正 %d 次，平均下行 %.0f B/s，平均上行 %.0f B/s"),
+			PingSumMs / NumReports, PingMaxMs, CorrectionCount, InBytesPerSecondSum / NumReports, OutBytesPerSecondSum / NumReports);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void UZBBotComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	AZBPlayerController* Controller = GetZBController();
+	ACharacter* Character = Controller ? Controller->GetPawn<ACharacter>() : nullptr;
+	if (!Character) return;
+
+	UpdateMovementPrerequisite(Character);
+	SampleCorrections();
+	TickHeldAbility(DeltaTime);
+	TickStep(DeltaTime);
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastReportTime >= ReportInterval)
+	{
+		WriteReport(Now);
+	}
+
+	if (DurationSeconds > 0.f && Now - StartTime >= DurationSeconds)
+	{
+		SetComponentTickEnabled(false);
+		FPlatformMisc::RequestExit(false, TEXT("ZBBot"));
+	}
+}
+
+/**
+ * @brief 切换到脚本的下一步
+ * @details 移动 -> 冲刺 -> 连击 -> 闪避 -> 符文 -> 移动 ...，每轮重新随机方向与符文槽位。
+ */
+void UZBBotComponent::AdvanceStep()
+{
+	const FZBGameplayTags& GameplayTags = FZBGameplayTags::Get();
+
+	switch (CurrentStep)
+	{
+	case EZBBotStep::Move:
+		CurrentStep = EZBBotStep::Sprint;
+		StepTimeRemaining = SprintStepDuration;
+		PressAbility(GameplayTags.InputTag_Sprint, SprintStepDuration);
+		break;
+	case EZBBotStep::Sprint:
+		CurrentStep = EZBBotStep::Attack;
+		AttacksRemaining = AttackComboCount;
+		StepTimeRemaining = 0.f;
+		break;
+	case EZBBotStep::Attack:
+		CurrentStep = EZBBotStep::Dodge;
+		StepTimeRemaining = 0.6f;
+		PressAbility(GameplayTags.InputTag_Dodge, 0.1f);
+		break;
+	case EZBBotStep::Dodge:
+		{
+			CurrentStep = EZBBotStep::Rune;
+			StepTimeRemaining = 1.f;
+			const FGameplayTag RuneTags[] = {
+				GameplayTags.InputTag_Rune_1,
+				GameplayTags.InputTag_Rune_2,
+				GameplayTags.InputTag_Rune_3,
+				GameplayTags.InputTag_Rune_4,
+			};
+			PressAbility(RuneTags[RandomStream.RandHelper(UE_ARRAY_COUNT(RuneTags))], 0.1f);
+		}
+		break;
+	case EZBBotStep::Rune:
+		CurrentStep = EZBBotStep::Move;
+		StepTimeRemaining = MoveStepDuration;
+		MoveAxis = FVector2D(RandomStream.FRandRange(-1.f, 1.f), RandomStream.FRandRange(-1.f, 1.f)).GetSafeNormal();
+		if (MoveAxis.IsNearlyZero())
+		{
+			MoveAxis = FVector2D(0.f, 1.f);
+		}
+		break;
+	}
+}
+
+void UZBBotComponent::TickStep(float DeltaTime)
+{
+	AZBPlayerController* Controller = GetZBController();
+
+	// 移动与冲刺期间每帧注入移动输入
+	if (CurrentStep == EZBBotStep::Move || CurrentStep == EZBBotStep::Sprint)
+	{
+		Controller->InjectInput(EZBRecordedInputType::Move, MoveAxis, FGameplayTag());
+	}
+
+	StepTimeRemaining -= DeltaTime;
+	if (StepTimeRemaining > 0.f) return;
+
+	if (CurrentStep == EZBBotStep::Attack && AttacksRemaining > 0)
+	{
+		--AttacksRemaining;
+		StepTimeRemaining = AttackInterval;
+		PressAbility(FZBGameplayTags::Get().InputTag_Attack_Main, 0.1f);
+		return;
+	}
+
+	AdvanceStep();
+}
+
+void UZBBotComponent::PressAbility(const FGameplayTag& InputTag, float HoldTime)
+{
+	AZBPlayerController* Controller = GetZBController();
+
+	// 上一个还按着的输入先松开
+	if (HeldInputTag.IsValid())
+	{
+		Controller->InjectInput(EZBRecordedInputType::AbilityReleased, FVector2D::ZeroVector, HeldInputTag);
+	}
+
+	Controller->InjectInput(EZBRecordedInputType::AbilityPressed, FVector2D::ZeroVector, InputTag);
+	HeldInputTag = InputTag;
+	HeldTimeRemaining = HoldTime;
+}
+
+void UZBBotComponent::TickHeldAbility(float DeltaTime)
+{
+	if (!HeldInputTag.IsValid()) return;
+
+	AZBPlayerController* Controller = GetZBController();
+	Controller->InjectInput(EZBRecordedInputType::AbilityHeld, FVector2D::ZeroVector, HeldInputTag);
+
+	HeldTimeRemaining -= DeltaTime;
+	if (HeldTimeRemaining <= 0.f)
+	{
+		Controller->InjectInput(EZBRecordedInputType::AbilityReleased, FVector2D::ZeroVector, HeldInputTag);
+		HeldInputTag = FGameplayTag();
+	}
+}
+
+/**
+ * @brief 确保在 CharacterMovement 清掉纠正标记之前采样
+ * @details 新 Pawn 的第一帧本组件已经先于其移动组件 Tick 过了，注册从下一帧开始生效，只错过一帧的采样。
+ */
+void UZBBotComponent::UpdateMovementPrerequisite(ACharacter* Character)
+{
+	UCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement();
+	if (PrerequisiteMovement.Get() == MovementComponent) return;
+
+	if (UCharacterMovementComponent* PreviousMovement = PrerequisiteMovement.Get())
+	{
+		PreviousMovement->RemoveTickPrerequisiteComponent(this);
+	}
+	if (MovementComponent)
+	{
+		MovementComponent->AddTickPrerequisiteComponent(this);
+	}
+	PrerequisiteMovement = MovementComponent;
+	bWasUpdatingPosition = false;
+}
+
+void UZBBotComponent::SampleCorrections()
+{
+	const ACharacter* Character = GetZBController()->GetPawn<ACharacter>();
+	UCharacterMovementComponent* MovementComponent = Character ? Character->GetCharacterMovement() : nullptr;
+	if (!MovementComponent || !MovementComponent->HasPredictionData_Client()) return;
+
+	const FNetworkPredictionData_Client_Character* ClientData = MovementComponent->GetPredictionData_Client_Character();
+	const bool bUpdatingPosition = ClientData && ClientData->bUpdatePosition;
+	if (bUpdatingPosition && !bWasUpdatingPosition)
+	{
+		++CorrectionCount;
+	}
+	bWasUpdatingPosition = bUpdatingPosition;
+}
+
+void UZBBotComponent::WriteReport(double Now)
+{
+	LastReportTime = Now;
+
+	const AZBPlayerController* Controller = GetZBController();
+	const APlayerState* State = Controller->PlayerState;
+	const UNetConnection* Connection = Controller->GetNetConnection();
+
+	const float PingMs = State ? State->GetPingInMilliseconds() : 0.f;
+	const int32 InBytesPerSecond = Connection ? Connection->InBytesPerSecond : 0;
+	const int32 OutBytesPerSecond = Connection ? Connection->OutBytesPerSecond : 0;
+	const int32 NewCorrections = CorrectionCount - CorrectionCountAtLastReport;
+	CorrectionCountAtLastReport = CorrectionCount;
+
+	++NumReports;
+	PingSumMs += PingMs;
+	PingMaxMs = FMath::Max(PingMaxMs, PingMs);
+	InBytesPerSecondSum += InBytesPerSecond;
+	OutBytesPerSecondSum += OutBytesPerSecond;
+
+	const FString Line = FString::Printf(TEXT("%.1f,%.1f,%d,%d,%d\n"), Now - StartTime, PingMs, NewCorrections, InBytesPerSecond, OutBytesPerSecond);
+	FFileHelper::SaveStringToFile(Line, *CsvPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+}
@@ -0,0 +1,182 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Player/ZBInteractionComponent.h"
+
+#include "GameFramework/Pawn.h"
+#include "Player/ZBPlayerController.h"
+#include "ZBetaLog.h"
+#include "ZBetaStats.h"
+
+UZBInteractionComponent::UZBInteractionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	SetIsReplicatedByDefault(true);
+}
+
+void UZBInteractionComponent::AddCandidate(UZBInteractableComponent* Interactable)
+{
+	if (!Interactable) return;
+
+	Candidates.AddUnique(Interactable);
+	PrimaryComponentTick.TickInterval = CheckInterval;
+	SetComponentTickEnabled(true);
+	Evaluate();
+}
+
+void UZBInteractionComponent::RemoveCandidate(UZBInteractableComponent* Interactable)
+{
+	Candidates.RemoveSingleSwap(Interactable);
+	if (Candidates.IsEmpty())
+	{
+		SetComponentTickEnabled(false);
+	}
+	Evaluate();
+}
+
+void UZBInteractionComponent::OnCandidateChanged()
+{
+	Evaluate();
+}
+
+/**
+ * @brief 换 Pawn 时重建候选
+ * @details Pawn 在交互范围内出生 / 重生时，重叠发生在被控制之前，交互对象当时找不到本组件；
+ *          旧 Pawn 与控制器分离后，它的离开事件也可能来不及匹配。这里统一清空，再从新 Pawn 已有的重叠补登记。
+ */
+void UZBInteractionComponent::OnPawnChanged(APawn* NewPawn)
+{
+	for (const TWeakObjectPtr<UZBInteractableComponent>& Candidate : Candidates)
+	{
+		if (UZBInteractableComponent* Interactable = Candidate.Get())
+		{
+			Interactable->RemoveWatcher(this);
+		}
+	}
+	Candidates.Reset();
+
+	if (NewPawn && GetOuterAZBPlayerController()->IsLocalController())
+	{
+		TArray<UPrimitiveComponent*> OverlappingComponents;
+		NewPawn->GetOverlappingComponents(OverlappingComponents);
+		for (UPrimitiveComponent* Component : OverlappingComponents)
+		{
+			if (UZBInteractableComponent* Interactable = Cast<UZBInteractableComponent>(Component))
+			{
+				Interactable->AddWatcher(this, NewPawn);
+			}
+		}
+	}
+
+	// 没有候选时关闭 Tick 并清掉提示
+	Evaluate();
+}
+
+/**
+ * @brief 有候选时低频检查玩家是否移动 / 转向超过阈值，超过才重新评估
+ */
+void UZBInteractionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const AZBPlayerController* PlayerController = GetOuterAZBPlayerController();
+	const APawn* Pawn = PlayerController->GetPawn();
+	if (!Pawn) return;
+
+	const bool bMoved = FVector::DistSquared(Pawn->GetActorLocation(), EvaluatedLocation) > FMath::Square(ReevaluateDistance);
+	const bool bTurned = FMath::Abs(FMath::FindDeltaAngleDegrees(EvaluatedYaw, PlayerController->GetControlRotation().Yaw)) > ReevaluateYaw;
+	if (bMoved || bTurned)
+	{
+		Evaluate();
+	}
+}
+
+/**
+ * @brief 选出最佳候选并缓存提示
+ * @details 优先级高者优先；同优先级比较 距离 + 视角夹角 * FacingWeight。
+ *          目标或提示内容变化时才广播。
+ */
+void UZBInteractionComponent::Evaluate()
+{
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_InteractionEvaluate);
+	INC_DWORD_STAT(STAT_ZBeta_InteractionEvaluations);
+
+	const AZBPlayerController* PlayerController = GetOuterAZBPlayerController();
+	const APawn* Pawn = PlayerController->GetPawn();
+
+	UZBInteractableComponent* Best = nullptr;
+	if (Pawn)
+	{
+		const FVector PawnLocation = Pawn->GetActorLocation();
+		const FRotator ControlRotation = PlayerController->GetControlRotation();
+		const FVector ViewDirection = FRotator(0.f, ControlRotation.Yaw, 0.f).Vector();
+		EvaluatedLocation = PawnLocation;
+		EvaluatedYaw = ControlRotation.Yaw;
+
+		float BestScore = TNumericLimits<float>::Max();
+		int32 BestPriority = TNumericLimits<int32>::Lowest();
+		for (int32 Index = Candidates.Num() - 1; Index >= 0; --Index)
+		{
+			UZBInteractableComponent* Interactable = Candidates[Index].Get();
+			if (!Interactable)
+			{
+				Candidates.RemoveAtSwap(Index, EAllowShrinking::No);
+				continue;
+			}
+			if (!Interactable->IsInteractionEnabled() || Interactable->GetPriority() < BestPriority) continue;
+
+			const FVector ToInteractable = Interactable->GetComponentLocation() - PawnLocation;
+			const float Distance = ToInteractable.Size2D();
+			const float CosAngle = FVector::DotProduct(ViewDirection, ToInteractable.GetSafeNormal2D());
+			const float Angle = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(CosAngle, -1.f, 1.f)));
+			const float Score = Distance + Angle * FacingWeight;
+
+			if (Interactable->GetPriority() > BestPriority || Score < BestScore)
+			{
+				Best = Interactable;
+				BestScore = Score;
+				BestPriority = Interactable->GetPriority();
+			}
+		}
+	}
+
+	if (Candidates.IsEmpty())
+	{
+		SetComponentTickEnabled(false);
+	}
+
+	const bool bTargetChanged = BestInteractable.Get() != Best;
+	const bool bPromptChanged = Best
+		&& (!CachedPrompt.ActionText.EqualTo(Best->GetPrompt().ActionText) || !CachedPrompt.ObjectName.EqualTo(Best->GetPrompt().ObjectName));
+	if (!bTargetChanged && !bPromptChanged) return;
+
+	BestInteractable = Best;
+	CachedPrompt = Best ? Best->GetPrompt() : FZBInteractionPrompt();
+	OnInteractionPromptChanged.Broadcast(Best != nullptr, CachedPrompt);
+}
+
+bool UZBInteractionComponent::Interact()
+{
+	UZBInteractableComponent* Interactable = BestInteractable.Get();
+	if (!Interactable || !Interactable->IsInteractionEnabled()) return false;
+
+	ServerInteract(Interactable);
+	return true;
+}
+
+void UZBInteractionComponent::ServerInteract_Implementation(UZBInteractableComponent* Interactable)
+{
+	APawn* Pawn = GetOuterAZBPlayerController()->GetPawn();
+	if (!Pawn || !Interactable || !Interactable->IsInteractionEnabled()) return;
+
+	// 只做距离校验，不做视线检测
+	const float MaxDistance = Interactable->GetScaledSphereRadius() + ServerDistanceTolerance;
+	if (FVector::DistSquared(Pawn->GetActorLocation(), Interactable->GetComponentLocation()) > FMath::Square(MaxDistance))
+	{
+		UE_LOG(LogZBetaInput, Warning, TEXT("交互请求超出距离，已拒绝: %s"), *GetNameSafe(Interactable->GetOwner()));
+		return;
+	}
+
+	Interactable->Interact(Pawn);
+}
@@ -3,24 +3,55 @@
 
 #include "Player/ZBPlayerController.h"
 
-#include <rapidjson/internal/ieee754.h>
-
 #include "AbilitySystemBlueprintLibrary.h"
 #include "EnhancedInputSubsystems.h"
 #include "AbilitySystem/ZBAbilitySystemComponent.h"
 #include "AbilitySystem/ZBAttributeSet.h"
+#include "Combat/ZBMeleeHitSubsystem.h"
+#include "Combat/ZBMeleeWeaponComponent.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
 #include "Input/ZBEnhancedInputComponent.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "Player/ZBBotComponent.h"
+#include "Player/ZBInteractionComponent.h"
+#include "Player/ZBTargetLockComponent.h"
+#include "ZBetaLog.h"
 
 AZBPlayerController::AZBPlayerController()
 {
 	bReplicates = true;
+
+	TargetLockComponent = CreateDefaultSubobject<UZBTargetLockComponent>(TEXT("TargetLockComponent"));
+	InteractionComponent = CreateDefaultSubobject<UZBInteractionComponent>(TEXT("InteractionComponent"));
 }
 
 void AZBPlayerController::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// 服务器上的远端玩家控制器没有 LocalPlayer，输入映射和鼠标设置只在本地控制器上做
+	if (!IsLocalController()) return;
+
+	// 命令行自动录制 / 回放（无头 A/B 性能采集）
+	FString InputFileName;
+	if (FParse::Value(FCommandLine::Get(), TEXT("ZBReplayInput="), InputFileName))
+	{
+		ZBReplayInput(InputFileName);
+	}
+	else if (FParse::Value(FCommandLine::Get(), TEXT("ZBRecordInput="), InputFileName))
+	{
+		ZBRecordInput(InputFileName);
+	}
+
+	// 无头机器人客户端（-nullrhi -ZBBot 连接专用服务器做压测）
+	if (FParse::Param(FCommandLine::Get(), TEXT("ZBBot")))
+	{
+		BotComponent = NewObject<UZBBotComponent>(this, TEXT("BotComponent"));
+		BotComponent->RegisterComponent();
+	}
 	
 	// 不崩溃，只警告
 	ensureMsgf(DefaultInputMappingContext, TEXT("DefaultInputMappingContext 没有设置！"));
@@ -30,11 +61,11 @@ void AZBPlayerController::BeginPlay()
 	if (Subsystem)
 	{
 		Subsystem->AddMappingContext(DefaultInputMappingContext, 0);
-		UE_LOG(LogTemp, Warning, TEXT("EnhancedInput Subsystem 获取成功!!!"));
+		UE_LOG(LogZBetaInput, Verbose, TEXT("EnhancedInput Subsystem 获取成功"));
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("EnhancedInput Subsystem 获取失败!!!"));
+		UE_LOG(LogZBetaInput, Warning, TEXT("EnhancedInput Subsystem 获取失败，默认输入映射没有添加"));
 	}
 	
 	// 设置鼠标/输入模式
@@ -68,41 +99,314 @@ void AZBPlayerController::SetupInputComponent()
 
 void AZBPlayerController::AbilityInputPressed(FGameplayTag InputTag)
 {
-	if (GetASC())
+	OnLocalInput(EZBRecordedInputType::AbilityPressed, FVector2D::ZeroVector, InputTag);
+}
+
+void AZBPlayerController::AbilityInputReleased(FGameplayTag InputTag)
+{
+	OnLocalInput(EZBRecordedInputType::AbilityReleased, FVector2D::ZeroVector, InputTag);
+}
+
+void AZBPlayerController::AbilityInputHeld(FGameplayTag InputTag)
+{
+	OnLocalInput(EZBRecordedInputType::AbilityHeld, FVector2D::ZeroVector, InputTag);
+}
+
+void AZBPlayerController::HandleInput(EZBRecordedInputType Type, const FVector2D& Axis, const FGameplayTag& InputTag)
+{
+	switch (Type)
 	{
-		GetASC()->AbilityInputForTagPressed(InputTag);
+	case EZBRecordedInputType::Move:
+		HandleMoveInput(Axis);
+		break;
+	case EZBRecordedInputType::Look:
+		HandleLookInput(Axis);
+		break;
+	case EZBRecordedInputType::AbilityPressed:
+		if (GetASC())
+		{
+			GetASC()->AbilityInputForTagPressed(InputTag);
+		}
+		ZB_LOG_HOT(LogZBetaInput, Log, TEXT("输入按下: {0}"), InputTag);
+		break;
+	case EZBRecordedInputType::AbilityReleased:
+		if (GetASC())
+		{
+			GetASC()->AbilityInputForTagReleased(InputTag);
+		}
+		ZB_LOG_HOT(LogZBetaInput, Log, TEXT("输入释放: {0}"), InputTag);
+		break;
+	case EZBRecordedInputType::AbilityHeld:
+		if (GetASC())
+		{
+			GetASC()->AbilityInputForTagHeld(InputTag);
+		}
+		ZB_LOG_HOT(LogZBetaInput, Log, TEXT("输入长按: {0}"), InputTag);
+		break;
+	case EZBRecordedInputType::Interaction:
+		InteractionComponent->Interact();
+		ZB_LOG_HOT(LogZBetaInput, Log, TEXT("按下交互键按键"));
+		break;
+	case EZBRecordedInputType::TargetLock:
+		TargetLockComponent->ToggleLock();
+		ZB_LOG_HOT(LogZBetaInput, Log, TEXT("按下锁定目标按键"));
+		break;
+	case EZBRecordedInputType::Menu:
+		ZB_LOG_HOT(LogZBetaInput, Log, TEXT("按下菜单按键"));
+		break;
 	}
-	UE_LOG(LogTemp, Log, TEXT("输入按下: %s"), *InputTag.ToString());
 }
 
-void AZBPlayerController::AbilityInputReleased(FGameplayTag InputTag)
+void AZBPlayerController::OnLocalInput(EZBRecordedInputType Type, const FVector2D& Axis, const FGameplayTag& InputTag)
 {
-	if (GetASC())
+	if (bReplayingInput) return;
+
+	if (bRecordingInput && GetPawn())
 	{
-		GetASC()->AbilityInputForTagReleased(InputTag);
+		InputRecording.Add(InputFrame, Type, Axis, InputTag);
 	}
-	UE_LOG(LogTemp, Log, TEXT("输入释放: %s"), *InputTag.ToString());
-	
+	HandleInput(Type, Axis, InputTag);
 }
 
-void AZBPlayerController::AbilityInputHeld(FGameplayTag InputTag)
+void AZBPlayerController::InjectInput(EZBRecordedInputType Type, const FVector2D& Axis, const FGameplayTag& InputTag)
+{
+	if (bRecordingInput && GetPawn())
+	{
+		InputRecording.Add(InputFrame, Type, Axis, InputTag);
+	}
+	HandleInput(Type, Axis, InputTag);
+}
+
+/**
+ * @brief 每帧：回放中先派发本帧的录像输入，再走引擎的输入处理；录制 / 回放的帧序号在末尾递增
+ * @details 录制时的输入是在 Super::PlayerTick 的输入处理里记录的，回放放在它之前派发，
+ *          两者都早于 Pawn 的 Tick，移动组件消费输入的时机一致。
+ *          录制与回放都只在 Pawn 就位时计帧（没有 Pawn 时的输入也不录制），帧序号才能一一对应。
+ */
+void AZBPlayerController::PlayerTick(float DeltaTime)
+{
+	if (bReplayingInput && GetPawn())
+	{
+		const TArray<FZBRecordedInput>& Records = InputRecording.GetRecords();
+		while (ReplayCursor < Records.Num() && Records[ReplayCursor].Frame <= InputFrame)
+		{
+			const FZBRecordedInput& Record = Records[ReplayCursor++];
+			const FGameplayTag InputTag = InputRecording.GetTag(Record.TagIndex);
+			const bool bIsAbilityInput = Record.Type == EZBRecordedInputType::AbilityPressed
+				|| Record.Type == EZBRecordedInputType::AbilityReleased
+				|| Record.Type == EZBRecordedInputType::AbilityHeld;
+			if (bIsAbilityInput && !InputTag.IsValid()) continue;
+
+			HandleInput(Record.Type, FVector2D(Record.Axis), InputTag);
+		}
+	}
+
+	Super::PlayerTick(DeltaTime);
+
+	TargetLockComponent->UpdateControlRotation(DeltaTime);
+
+	// 录制与回放用同一个计帧条件：Pawn 就位后才计帧
+	if ((bRecordingInput || bReplayingInput) && GetPawn())
+	{
+		++InputFrame;
+	}
+
+	if (bReplayingInput && InputFrame >= InputRecording.NumFrames)
+	{
+		FinishInputReplay();
+	}
+}
+
+void AZBPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bRecordingInput)
+	{
+		ZBStopRecordInput();
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+FString AZBPlayerController::ResolveInputRecordingPath(const FString& FileName)
+{
+	FString Path = FileName.IsEmpty()
+		? FString::Printf(TEXT("Input_%s"), *FDateTime::Now().ToString())
+		: FileName;
+	if (FPaths::GetExtension(Path).IsEmpty())
+	{
+		Path += TEXT(".zbinput");
+	}
+	if (FPaths::IsRelative(Path))
+	{
+		Path = FPaths::ProjectSavedDir() / TEXT("InputRecordings") / Path;
+	}
+	return Path;
+}
+
+/**
+ * @brief 开始录制
+ * @details 种子取命令行 -ZBInputSeed=，否则随机生成；写进 FMath 的全局随机数，回放时恢复同一个种子。
+ */
+void AZBPlayerController::ZBRecordInput(const FString& FileName)
+{
+	if (!IsLocalController() || bReplayingInput) return;
+
+	int32 RandomSeed = 0;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("ZBInputSeed="), RandomSeed))
+	{
+		RandomSeed = static_cast<int32>(FPlatformTime::Cycles());
+	}
+	FMath::RandInit(RandomSeed);
+	FMath::SRandInit(RandomSeed);
+
+	InputRecording.Reset(RandomSeed);
+	InputRecordingPath = ResolveInputRecordingPath(FileName);
+	InputFrame = 0;
+	InputStartTime = FPlatformTime::Seconds();
+	bRecordingInput = true;
+
+	UE_LOG(LogZBetaInput, Display, TEXT("开始录制输入：%s（种子 %d）"), *InputRecordingPath, RandomSeed);
+}
+
+void AZBPlayerController::ZBStopRecordInput()
+{
+	if (!bRecordingInput) return;
+
+	bRecordingInput = false;
+	InputRecording.NumFrames = InputFrame;
+	InputRecording.DurationSeconds = static_cast<float>(FPlatformTime::Seconds() - InputStartTime);
+	InputRecording.SaveToFile(InputRecordingPath);
+}
+
+void AZBPlayerController::ZBReplayInput(const FString& FileName)
+{
+	if (!IsLocalController()) return;
+	if (bRecordingInput)
+	{
+		ZBStopRecordInput();
+	}
+
+	InputRecordingPath = ResolveInputRecordingPath(FileName);
+	if (!InputRecording.LoadFromFile(InputRecordingPath)) return;
+
+	FMath::RandInit(InputRecording.GetRandomSeed());
+	FMath::SRandInit(InputRecording.GetRandomSeed());
+
+	InputFrame = 0;
+	ReplayCursor = 0;
+	InputStartTime = FPlatformTime::Seconds();
+	bReplayingInput = true;
+
+	UE_LOG(LogZBetaInput, Display, TEXT("开始回放输入：%s（%u 帧，录制时长 %.1fs，种子 %d）"),
+		*InputRecordingPath, InputRecording.NumFrames, InputRecording.DurationSeconds, InputRecording.GetRandomSeed());
+}
+
+void AZBPlayerController::FinishInputReplay()
+{
+	bReplayingInput = false;
+
+	const double ReplaySeconds = FPlatformTime::Seconds() - InputStartTime;
+	UE_LOG(LogZBetaInput, Display, TEXT("输入回放结束：%u 帧，用时 %.2fs（录制 %.2fs）"),
+		InputFrame, ReplaySeconds, InputRecording.DurationSeconds);
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("ZBReplayExit")))
+	{
+		FPlatformMisc::RequestExit(false, TEXT("ZBReplayInput"));
+	}
+}
+
+void AZBPlayerController::SetPawn(APawn* InPawn)
 {
-	if (GetASC())
+	Super::SetPawn(InPawn);
+
+	// 控制器销毁过程中也会清空 Pawn
+	if (IsValid(InteractionComponent))
 	{
-		GetASC()->AbilityInputForTagHeld(InputTag);
+		InteractionComponent->OnPawnChanged(InPawn);
 	}
-	UE_LOG(LogTemp, Log, TEXT("输入长按: %s"), *InputTag.ToString());
 }
 
+double AZBPlayerController::GetServerWorldTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+void AZBPlayerController::ReportMeleeHit(UZBMeleeWeaponComponent* Weapon, AActor* Victim, const FVector& TraceStart, const FVector& TraceEnd)
+{
+	if (!Weapon || !Victim) return;
+
+	ServerReportMeleeHit(Weapon, Victim, GetServerWorldTime(), TraceStart, TraceEnd);
+}
+
+/**
+ * @brief 令牌桶限流：按 CombatReportsPerSecond 恢复额度，最多攒 CombatReportBurst
+ * @details 用服务器自己的时间计算，与客户端上报的时间戳无关。
+ */
+bool AZBPlayerController::ConsumeCombatReportBudget()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	CombatReportBudget = FMath::Min(CombatReportBudget + static_cast<float>((Now - CombatReportBudgetTime) * CombatReportsPerSecond), CombatReportBurst);
+	CombatReportBudgetTime = Now;
+
+	if (CombatReportBudget < 1.f)
+	{
+		ZB_LOG_HOT(LogZBetaNet, Warning, TEXT("战斗上报过于频繁，已丢弃：{0}"), this);
+		return false;
+	}
+	CombatReportBudget -= 1.f;
+	return true;
+}
+
+void AZBPlayerController::ServerReportMeleeHit_Implementation(UZBMeleeWeaponComponent* Weapon, AActor* Victim, double ClientTime, FVector_NetQuantize TraceStart, FVector_NetQuantize TraceEnd)
+{
+	if (!ConsumeCombatReportBudget()) return;
+
+	if (UZBMeleeHitSubsystem* Subsystem = UWorld::GetSubsystem<UZBMeleeHitSubsystem>(GetWorld()))
+	{
+		Subsystem->ValidateClientHit(this, Weapon, Victim, ClientTime, TraceStart, TraceEnd);
+	}
+}
+
+void AZBPlayerController::ReportParry(AActor* Attacker)
+{
+	if (!Attacker) return;
+
+	ServerReportParry(Attacker, GetServerWorldTime());
+}
+
+void AZBPlayerController::ServerReportParry_Implementation(AActor* Attacker, double ClientTime)
+{
+	if (!ConsumeCombatReportBudget()) return;
+
+	if (UZBMeleeHitSubsystem* Subsystem = UWorld::GetSubsystem<UZBMeleeHitSubsystem>(GetWorld()))
+	{
+		Subsystem->ValidateClientParry(this, Attacker, ClientTime);
+	}
+}
+
+void AZBPlayerController::ClientFireProjectiles_Implementation(const FZBProjectileParams& Params, AActor* Instigator)
+{
+	if (UZBProjectileSubsystem* Projectiles = UWorld::GetSubsystem<UZBProjectileSubsystem>(GetWorld()))
+	{
+		Projectiles->FireProjectiles(Params, FGameplayEffectSpecHandle(), Instigator);
+	}
+}
 
 UZBAbilitySystemComponent* AZBPlayerController::GetASC()
 {
+	// 只在缓存为空时查找并记录一次，命中缓存的正常路径不打日志
 	if (ZBAbilitySystemComponent == nullptr)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("未找到 ASC 组件，开始获取 ASC 组件"));  
 		ZBAbilitySystemComponent = Cast<UZBAbilitySystemComponent>(UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(GetPawn<APawn>()));
+		if (ZBAbilitySystemComponent == nullptr)
+		{
+			ZB_LOG_HOT(LogZBetaInput, Warning, TEXT("未找到 ASC 组件，Pawn：{0}"), GetPawn());
+		}
+		else
+		{
+			ZB_LOG_HOT(LogZBetaInput, Verbose, TEXT("✓ 找到 ASC 组件：{0}"), ZBAbilitySystemComponent.Get());
+		}
 	}
-	UE_LOG(LogTemp, Warning, TEXT("✓ 找到 ASC 组件：%s"),*ZBAbilitySystemComponent->GetName());
 	return ZBAbilitySystemComponent;
 }
 
@@ -113,13 +417,17 @@ UZBAbilitySystemComponent* AZBPlayerController::GetASC()
  * * @param InputActionValue 增强输入传入的 2D 向量 (X=Right, Y=Forward)
  */
 void AZBPlayerController::Input_Move(const FInputActionValue& InputActionValue)
+{
+	OnLocalInput(EZBRecordedInputType::Move, InputActionValue.Get<FVector2D>(), FGameplayTag());
+}
+
+void AZBPlayerController::HandleMoveInput(const FVector2D& InputAxisVector)
 {
 	// 1. 安全检查：确保 ASC 存在
 	// (通常移动不强依赖 GAS，但加上这个检查可以防止在初始化未完成时操作)
 	if (!GetASC())return;
 
-	// 2. 获取输入的 2D 向量
-	FVector2D InputAxisVector = InputActionValue.Get<FVector2D>();
+	// 2. 输入的 2D 向量由 Input_Move / 回放 / 机器人传入
 	// 3. 计算基于视角的移动方向
 	// 获取控制器的旋转（通常等同于摄像机朝向）
 	const FRotator Rotation = GetControlRotation();
@@ -148,7 +456,18 @@ void AZBPlayerController::Input_Move(const FInputActionValue& InputActionValue)
  */
 void AZBPlayerController::Input_Look(const FInputActionValue& InputActionValue)
 {
-	FVector2D LookVector  = InputActionValue.Get<FVector2D>();
+	OnLocalInput(EZBRecordedInputType::Look, InputActionValue.Get<FVector2D>(), FGameplayTag());
+}
+
+void AZBPlayerController::HandleLookInput(const FVector2D& LookVector)
+{
+	// 锁定期间视角由锁定组件接管，横向拨动用于切换目标
+	if (TargetLockComponent->IsLocked())
+	{
+		TargetLockComponent->HandleLookInput(LookVector);
+		return;
+	}
+
 	// 应用 Yaw (Z轴旋转) -> 左右看
 	AddYawInput(LookVector.X);
 	// 应用 Pitch (Y轴旋转) -> 上下看
@@ -158,15 +477,15 @@ void AZBPlayerController::Input_Look(const FInputActionValue& InputActionValue)
 
 void AZBPlayerController::Input_Interaction()
 {
-	UE_LOG(LogTemp, Log, TEXT("按下交互键按键"));
+	OnLocalInput(EZBRecordedInputType::Interaction, FVector2D::ZeroVector, FGameplayTag());
 }
 
 void AZBPlayerController::Input_TargetLock()
 {
-	UE_LOG(LogTemp, Log, TEXT("按下锁定目标按键"));
+	OnLocalInput(EZBRecordedInputType::TargetLock, FVector2D::ZeroVector, FGameplayTag());
 }
 
 void AZBPlayerController::Input_Menu()
 {
-	UE_LOG(LogTemp, Log, TEXT("按下菜单按键"));
+	OnLocalInput(EZBRecordedInputType::Menu, FVector2D::ZeroVector, FGameplayTag());
 }
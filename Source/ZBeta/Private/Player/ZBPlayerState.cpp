@@ -3,21 +3,128 @@
 
 #include "Player/ZBPlayerState.h"
 
+#include "TimerManager.h"
 #include "AbilitySystem/ZBAbilitySystemComponent.h"
 #include "AbilitySystem/ZBAttributeSet.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "Net/ZBReplicationGraph.h"
 
 AZBPlayerState::AZBPlayerState()
 {
-	//网络更新频率
-	SetNetUpdateFrequency(100.f);
+	//网络更新频率：默认低频，活动时由 RequestNetUpdateBoost 提升
+	SetNetUpdateFrequency(IdleNetUpdateFrequency);
+	SetMinNetUpdateFrequency(IdleNetUpdateFrequency);
 	AbilitySystemComponent = CreateDefaultSubobject<UZBAbilitySystemComponent>("AbilitySystemComponent");
 	AbilitySystemComponent->SetIsReplicated(true);
 	AbilitySystemComponent->SetReplicationMode(EGameplayEffectReplicationMode::Mixed);
 	AttributeSet = CreateDefaultSubobject<UZBAttributeSet>("AttributeSet");
-	
+
 }
 
 UAbilitySystemComponent* AZBPlayerState::GetAbilitySystemComponent() const
 {
 	return AbilitySystemComponent;
 }
+
+/**
+ * @brief 服务器端绑定 ASC 的活动事件，驱动自适应网络更新频率
+ *
+ * 详细流程：
+ *   1. 仅服务器执行（频率只影响服务器的复制调度）；
+ *   2. 监听 State_InCombat：战斗期间保持 ActiveNetUpdateFrequency；
+ *   3. 监听任意 Tag 变化 / GE 添加与移除：触发一次提升，随后衰减；
+ *
+ * 注意事项：
+ *   - 蓝图子类可能覆盖了频率配置，这里以配置值重新设置一次空闲频率。
+ */
+void AZBPlayerState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!HasAuthority() || !AbilitySystemComponent) return;
+
+	ApplyNetUpdateFrequency(IdleNetUpdateFrequency);
+	SetMinNetUpdateFrequency(IdleNetUpdateFrequency);
+
+	AbilitySystemComponent->RegisterGameplayTagEvent(FZBGameplayTags::Get().State_InCombat, EGameplayTagEventType::NewOrRemoved)
+		.AddUObject(this, &AZBPlayerState::OnInCombatTagChanged);
+	AbilitySystemComponent->RegisterGenericGameplayTagEvent().AddUObject(this, &AZBPlayerState::OnAnyTagChanged);
+	AbilitySystemComponent->OnActiveGameplayEffectAddedDelegateToSelf.AddUObject(this, &AZBPlayerState::OnGameplayEffectAdded);
+	AbilitySystemComponent->OnAnyGameplayEffectRemovedDelegate().AddUObject(this, &AZBPlayerState::OnGameplayEffectRemoved);
+}
+
+void AZBPlayerState::RequestNetUpdateBoost()
+{
+	if (!HasAuthority()) return;
+
+	if (GetNetUpdateFrequency() < ActiveNetUpdateFrequency)
+	{
+		ApplyNetUpdateFrequency(ActiveNetUpdateFrequency);
+	}
+	ForceNetUpdate();
+
+	// 战斗中不衰减，等离开战斗再重新计时
+	if (bInCombat)
+	{
+		GetWorldTimerManager().ClearTimer(NetDecayTimerHandle);
+		return;
+	}
+
+	// 每次活动都重新计时：保持 NetBoostHoldTime 后开始每 NetDecayInterval 衰减一步
+	GetWorldTimerManager().SetTimer(NetDecayTimerHandle, this, &AZBPlayerState::DecayNetUpdateFrequency, NetDecayInterval, true, NetBoostHoldTime);
+}
+
+void AZBPlayerState::OnInCombatTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	bInCombat = NewCount > 0;
+	RequestNetUpdateBoost();
+}
+
+void AZBPlayerState::OnAnyTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	// 移动状态 Tag 是 Character::Tick 里加的 Loose Tag，不参与复制，不需要提升频率。
+	// 通用事件对父标签也会触发（State.Movement.Moving 变化时 State.Movement、State 的计数也变），
+	// 所以反过来判断：Tag 是这两个叶子标签本身或它们的父标签时忽略；真正的其它状态变化会由它自己的叶子标签触发提升
+	const FZBGameplayTags& Tags = FZBGameplayTags::Get();
+	if (Tags.State_Movement_Idle.MatchesTag(Tag) || Tags.State_Movement_Moving.MatchesTag(Tag))
+	{
+		return;
+	}
+	RequestNetUpdateBoost();
+}
+
+void AZBPlayerState::OnGameplayEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle)
+{
+	RequestNetUpdateBoost();
+}
+
+void AZBPlayerState::OnGameplayEffectRemoved(const FActiveGameplayEffect& Effect)
+{
+	RequestNetUpdateBoost();
+}
+
+void AZBPlayerState::DecayNetUpdateFrequency()
+{
+	if (bInCombat)
+	{
+		GetWorldTimerManager().ClearTimer(NetDecayTimerHandle);
+		return;
+	}
+
+	// 每步减半，直到空闲频率
+	const float NewFrequency = FMath::Max(IdleNetUpdateFrequency, GetNetUpdateFrequency() * 0.5f);
+	ApplyNetUpdateFrequency(NewFrequency);
+
+	if (NewFrequency <= IdleNetUpdateFrequency)
+	{
+		GetWorldTimerManager().ClearTimer(NetDecayTimerHandle);
+	}
+}
+
+void AZBPlayerState::ApplyNetUpdateFrequency(float NewFrequency)
+{
+	SetNetUpdateFrequency(NewFrequency);
+
+	// 复制图按周期帧数调度，不读 NetUpdateFrequency
+	UZBReplicationGraph::NotifyNetUpdateFrequencyChanged(this);
+}
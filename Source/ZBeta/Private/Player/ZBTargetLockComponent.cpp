@@ -0,0 +1,242 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Player/ZBTargetLockComponent.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "Characters/ZBCharacterBase.h"
+#include "Combat/ZBTargetLockSubsystem.h"
+#include "Engine/World.h"
+#include "Player/ZBPlayerController.h"
+#include "ZBetaStats.h"
+
+UZBTargetLockComponent::UZBTargetLockComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UZBTargetLockComponent::ToggleLock()
+{
+	if (IsLocked())
+	{
+		ClearLock();
+		return;
+	}
+
+	RefreshCandidates();
+	for (const FCandidate& Candidate : Candidates)
+	{
+		AZBCharacterBase* Character = Candidate.Character.Get();
+		if (Character && IsVisible(Character))
+		{
+			SetLockedTarget(Character);
+			return;
+		}
+	}
+}
+
+void UZBTargetLockComponent::ClearLock()
+{
+	SetLockedTarget(nullptr);
+}
+
+void UZBTargetLockComponent::SetLockedTarget(AZBCharacterBase* NewTarget)
+{
+	if (LockedTarget.Get() == NewTarget) return;
+
+	LockedTarget = NewTarget;
+	LastVisibleTime = GetWorld()->GetTimeSeconds();
+
+	// 只有锁定期间才需要低频打分 / 校验
+	PrimaryComponentTick.TickInterval = ScoreInterval;
+	SetComponentTickEnabled(NewTarget != nullptr);
+	if (!NewTarget)
+	{
+		Candidates.Reset();
+		VisibilityCache.Reset();
+	}
+
+	OnTargetLockChanged.Broadcast(NewTarget);
+}
+
+/**
+ * @brief 锁定期间的低频更新
+ * @details 校验当前目标（存活、距离、视线容忍时间），再刷新候选供切换使用。
+ */
+void UZBTargetLockComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_TargetLockScore);
+
+	const APawn* Pawn = GetOuterAZBPlayerController()->GetPawn();
+	AZBCharacterBase* Target = LockedTarget.Get();
+	if (!Pawn || !IsTargetValid(Target, Pawn->GetActorLocation(), BreakDistance))
+	{
+		ClearLock();
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (IsVisible(Target))
+	{
+		LastVisibleTime = Now;
+	}
+	else if (Now - LastVisibleTime > LineOfSightGraceTime)
+	{
+		ClearLock();
+		return;
+	}
+
+	RefreshCandidates();
+}
+
+bool UZBTargetLockComponent::IsTargetValid(const AZBCharacterBase* Target, const FVector& PawnLocation, float MaxDistance) const
+{
+	if (!Target || Target->IsActorBeingDestroyed()) return false;
+
+	const UAbilitySystemComponent* AbilitySystemComponent = Target->GetAbilitySystemComponent();
+	if (AbilitySystemComponent && AbilitySystemComponent->HasMatchingGameplayTag(FZBGameplayTags::Get().State_Dead)) return false;
+
+	return FVector::DistSquared(Target->GetActorLocation(), PawnLocation) <= FMath::Square(MaxDistance);
+}
+
+/**
+ * @brief 从网格取附近角色，按夹角与距离打分后升序排列
+ * @details 这里不做视线检测：获取锁定时按分数从优到劣逐个检测，找到第一个可见的就停。
+ */
+void UZBTargetLockComponent::RefreshCandidates()
+{
+	Candidates.Reset();
+
+	const AZBPlayerController* PlayerController = GetOuterAZBPlayerController();
+	const APawn* Pawn = PlayerController->GetPawn();
+	const UZBTargetLockSubsystem* TargetLock = UWorld::GetSubsystem<UZBTargetLockSubsystem>(GetWorld());
+	if (!Pawn || !TargetLock) return;
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	const FVector ViewDirection = ViewRotation.Vector();
+	const FVector PawnLocation = Pawn->GetActorLocation();
+
+	TArray<AZBCharacterBase*> Nearby;
+	TargetLock->QueryCandidates(PawnLocation, MaxLockDistance, Nearby);
+
+	const float CosMaxAngle = FMath::Cos(FMath::DegreesToRadians(MaxLockAngle));
+	for (AZBCharacterBase* Character : Nearby)
+	{
+		if (Character == Pawn || !IsTargetValid(Character, PawnLocation, MaxLockDistance)) continue;
+
+		const FVector Direction = (Character->GetActorLocation() - ViewLocation).GetSafeNormal();
+		const float CosAngle = FVector::DotProduct(ViewDirection, Direction);
+		if (CosAngle < CosMaxAngle) continue;
+
+		const float Angle = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(CosAngle, -1.f, 1.f)));
+		const float Distance = FVector::Dist(Character->GetActorLocation(), PawnLocation);
+
+		FCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+		Candidate.Character = Character;
+		Candidate.Score = AngleWeight * Angle / MaxLockAngle + DistanceWeight * Distance / MaxLockDistance;
+		Candidate.Yaw = Direction.Rotation().Yaw;
+	}
+
+	Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.Score < B.Score; });
+
+	// 顺带丢掉过期很久的视线缓存
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (auto It = VisibilityCache.CreateIterator(); It; ++It)
+	{
+		if (Now - It.Value().Time > VisibilityCacheTime * 4.f)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UZBTargetLockComponent::IsVisible(const AZBCharacterBase* Target)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	FVisibilitySample& Sample = VisibilityCache.FindOrAdd(Target);
+	if (Sample.Time > 0.0 && Now - Sample.Time <= VisibilityCacheTime)
+	{
+		return Sample.bVisible;
+	}
+
+	const AZBPlayerController* PlayerController = GetOuterAZBPlayerController();
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(ZBTargetLockVisibility), false);
+	Params.AddIgnoredActor(PlayerController->GetPawn());
+	Params.AddIgnoredActor(Target);
+
+	INC_DWORD_STAT(STAT_ZBeta_TargetLockTraces);
+	Sample.bVisible = !GetWorld()->LineTraceTestByChannel(ViewLocation, Target->GetActorLocation(), ECC_Visibility, Params);
+	Sample.Time = Now;
+	return Sample.bVisible;
+}
+
+bool UZBTargetLockComponent::SwitchTarget(float Direction)
+{
+	const AZBCharacterBase* Current = LockedTarget.Get();
+	if (!Current || FMath::IsNearlyZero(Direction)) return false;
+
+	// 当前目标可能已不在候选里（超出夹角），朝向直接现算
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	GetOuterAZBPlayerController()->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	const float CurrentYaw = (Current->GetActorLocation() - ViewLocation).Rotation().Yaw;
+
+	// 同侧偏角最小的候选，按偏角从近到远逐个检查视线（多半命中缓存）
+	TArray<TPair<float, AZBCharacterBase*>, TInlineAllocator<8>> Neighbours;
+	for (const FCandidate& Candidate : Candidates)
+	{
+		AZBCharacterBase* Character = Candidate.Character.Get();
+		if (!Character || Character == Current) continue;
+
+		const float DeltaYaw = FMath::FindDeltaAngleDegrees(CurrentYaw, Candidate.Yaw);
+		if (DeltaYaw * Direction > 0.f)
+		{
+			Neighbours.Emplace(FMath::Abs(DeltaYaw), Character);
+		}
+	}
+	Neighbours.Sort([](const TPair<float, AZBCharacterBase*>& A, const TPair<float, AZBCharacterBase*>& B) { return A.Key < B.Key; });
+
+	for (const TPair<float, AZBCharacterBase*>& Neighbour : Neighbours)
+	{
+		if (IsVisible(Neighbour.Value))
+		{
+			SetLockedTarget(Neighbour.Value);
+			LastSwitchTime = GetWorld()->GetTimeSeconds();
+			return true;
+		}
+	}
+	return false;
+}
+
+void UZBTargetLockComponent::HandleLookInput(const FVector2D& LookVector)
+{
+	if (FMath::Abs(LookVector.X) < SwitchFlickThreshold) return;
+	if (GetWorld()->GetTimeSeconds() - LastSwitchTime < SwitchCooldown) return;
+
+	SwitchTarget(LookVector.X);
+}
+
+void UZBTargetLockComponent::UpdateControlRotation(float DeltaTime)
+{
+	const AZBCharacterBase* Target = LockedTarget.Get();
+	if (!Target) return;
+
+	AZBPlayerController* PlayerController = GetOuterAZBPlayerController();
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	FRotator Desired = (Target->GetActorLocation() - ViewLocation).Rotation();
+	Desired.Roll = 0.f;
+	PlayerController->SetControlRotation(FMath::RInterpTo(PlayerController->GetControlRotation(), Desired, DeltaTime, RotationInterpSpeed));
+}
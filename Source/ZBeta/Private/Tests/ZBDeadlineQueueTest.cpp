@@ -0,0 +1,93 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Combat/ZBDeadlineQueue.h"
+
+namespace ZBDeadlineQueueTest
+{
+	// 弹出 Now 之前全部到期的槽位
+	TArray<int32> PopAllDue(FZBDeadlineQueue& Queue, double Now)
+	{
+		TArray<int32> Slots;
+		int32 Slot = INDEX_NONE;
+		while (Queue.PopDue(Now, Slot))
+		{
+			Slots.Add(Slot);
+		}
+		return Slots;
+	}
+}
+
+/**
+ * @brief 到期顺序与边界：最早的先出，Time == Now 算到期，未到期的留在队列里
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBDeadlineQueueOrderTest, "ZBeta.Combat.DeadlineQueue.Order", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBDeadlineQueueOrderTest::RunTest(const FString& Parameters)
+{
+	FZBDeadlineQueue Queue;
+	Queue.Schedule(2, 3.0);
+	Queue.Schedule(0, 1.0);
+	Queue.Schedule(1, 2.0);
+	Queue.Schedule(3, 10.0);
+	TestEqual(TEXT("调度后的事件数"), Queue.Num(), 4);
+
+	double NextTime = 0.0;
+	TestTrue(TEXT("有待处理事件"), Queue.GetNextTime(NextTime));
+	TestEqual(TEXT("最早事件时间"), NextTime, 1.0);
+
+	const TArray<int32> Due = ZBDeadlineQueueTest::PopAllDue(Queue, 3.0);
+	TestTrue(TEXT("到期的槽位按时间顺序弹出"), Due == TArray<int32>({ 0, 1, 2 }));
+	TestEqual(TEXT("未到期的事件留在队列里"), Queue.Num(), 1);
+	TestTrue(TEXT("槽位 3 仍待处理"), Queue.IsPending(3));
+	TestFalse(TEXT("已弹出的槽位不再待处理"), Queue.IsPending(0));
+
+	TestTrue(TEXT("剩余事件"), Queue.GetNextTime(NextTime));
+	TestEqual(TEXT("剩余事件时间"), NextTime, 10.0);
+	return true;
+}
+
+/**
+ * @brief 重新调度与取消：旧条目作废，不会提前或重复到期；槽位复用后残留的旧条目依然作废
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBDeadlineQueueStaleTest, "ZBeta.Combat.DeadlineQueue.StaleEntries", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBDeadlineQueueStaleTest::RunTest(const FString& Parameters)
+{
+	FZBDeadlineQueue Queue;
+
+	// 推迟：1.0 的旧条目作废，5.0 才到期
+	Queue.Schedule(0, 1.0);
+	Queue.Schedule(0, 5.0);
+	TestEqual(TEXT("同一槽位只算一个事件"), Queue.Num(), 1);
+	TestTrue(TEXT("推迟后旧时间不到期"), ZBDeadlineQueueTest::PopAllDue(Queue, 2.0).IsEmpty());
+
+	double NextTime = 0.0;
+	TestTrue(TEXT("推迟后仍有事件"), Queue.GetNextTime(NextTime));
+	TestEqual(TEXT("堆顶的作废条目被跳过"), NextTime, 5.0);
+
+	// 提前：旧的 5.0 作废，只在 1.5 到期一次
+	Queue.Schedule(0, 1.5);
+	TestTrue(TEXT("提前后只到期一次"), ZBDeadlineQueueTest::PopAllDue(Queue, 6.0) == TArray<int32>({ 0 }));
+	TestEqual(TEXT("全部到期后为空"), Queue.Num(), 0);
+
+	// 取消后槽位复用：取消前的条目不会以新身份到期
+	Queue.Schedule(1, 1.0);
+	Queue.Cancel(1);
+	TestEqual(TEXT("取消后为空"), Queue.Num(), 0);
+	TestFalse(TEXT("取消后没有有效事件"), Queue.GetNextTime(NextTime));
+	Queue.Cancel(1);
+	TestEqual(TEXT("重复取消不影响计数"), Queue.Num(), 0);
+
+	Queue.Schedule(1, 4.0);
+	TestTrue(TEXT("复用槽位后旧时间不到期"), ZBDeadlineQueueTest::PopAllDue(Queue, 2.0).IsEmpty());
+	TestTrue(TEXT("复用槽位在新时间到期"), ZBDeadlineQueueTest::PopAllDue(Queue, 4.0) == TArray<int32>({ 1 }));
+	TestEqual(TEXT("最终为空"), Queue.Num(), 0);
+	return true;
+}
+
+#endif // WITH_AUTOMATION_TESTS
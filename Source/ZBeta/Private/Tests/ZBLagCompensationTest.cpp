@@ -0,0 +1,138 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Net/ZBPoseHistory.h"
+
+namespace ZBLagCompensationTest
+{
+	// 位置 / 判定球沿 X 轴以 100cm/s 匀速移动，绕 Z 轴以 90°/s 转动，胶囊半径随时间变化
+	FZBPoseHistory::FSample MakeSample(double Time, uint64 StateTagMask = 0)
+	{
+		FZBPoseHistory::FSample Sample;
+		Sample.Time = Time;
+		Sample.Location = FVector(100.0 * Time, 0.0, 0.0);
+		Sample.Rotation = FQuat(FVector::UpVector, UE_HALF_PI * Time);
+		Sample.CapsuleRadius = 30.f + 10.f * static_cast<float>(Time);
+		Sample.CapsuleHalfHeight = 90.f;
+		Sample.StateTagMask = StateTagMask;
+		return Sample;
+	}
+
+	void AddSample(FZBPoseHistory& History, double Time, uint64 StateTagMask = 0)
+	{
+		const TArrayView<FVector> Hitboxes = History.AddSample(MakeSample(Time, StateTagMask));
+		for (int32 Hitbox = 0; Hitbox < Hitboxes.Num(); ++Hitbox)
+		{
+			Hitboxes[Hitbox] = FVector(100.0 * Time, 0.0, 50.0 * (Hitbox + 1));
+		}
+	}
+}
+
+/**
+ * @brief 相邻采样之间插值：位置 / 胶囊 / 判定球线性插值，朝向球面插值，标签取较早的采样
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBLagCompensationInterpolateTest, "ZBeta.Net.LagCompensation.Interpolate", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBLagCompensationInterpolateTest::RunTest(const FString& Parameters)
+{
+	using namespace ZBLagCompensationTest;
+
+	FZBPoseHistory History;
+	History.Init(8, 2);
+	AddSample(History, 1.0, 0b01);
+	AddSample(History, 2.0, 0b10);
+
+	FZBRewoundCharacter Pose;
+	TestTrue(TEXT("有采样时回溯成功"), History.Rewind(1.25, Pose));
+	TestTrue(TEXT("位置按时间比例插值"), Pose.Location.Equals(FVector(125.0, 0.0, 0.0), KINDA_SMALL_NUMBER));
+	TestTrue(TEXT("朝向球面插值"), Pose.Rotation.Equals(FQuat(FVector::UpVector, UE_HALF_PI * 1.25), KINDA_SMALL_NUMBER));
+	TestEqual(TEXT("胶囊半径线性插值"), Pose.CapsuleRadius, 42.5f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("胶囊半高不变"), Pose.CapsuleHalfHeight, 90.f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("判定球数量与配置一致"), Pose.HitboxLocations.Num(), 2);
+	TestTrue(TEXT("判定球 0 插值"), Pose.HitboxLocations[0].Equals(FVector(125.0, 0.0, 50.0), KINDA_SMALL_NUMBER));
+	TestTrue(TEXT("判定球 1 插值"), Pose.HitboxLocations[1].Equals(FVector(125.0, 0.0, 100.0), KINDA_SMALL_NUMBER));
+	TestEqual(TEXT("标签取较早的采样，不插值"), Pose.StateTagMask, uint64(0b01));
+
+	History.Rewind(2.0, Pose);
+	TestTrue(TEXT("正好落在采样上取该采样的位置"), Pose.Location.Equals(FVector(200.0, 0.0, 0.0), KINDA_SMALL_NUMBER));
+	TestEqual(TEXT("正好落在采样上取该采样的标签"), Pose.StateTagMask, uint64(0b10));
+
+	return true;
+}
+
+/**
+ * @brief 早于最老 / 晚于最新采样取端点，空历史回溯失败
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBLagCompensationClampTest, "ZBeta.Net.LagCompensation.Clamp", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBLagCompensationClampTest::RunTest(const FString& Parameters)
+{
+	using namespace ZBLagCompensationTest;
+
+	FZBPoseHistory History;
+	History.Init(8, 1);
+
+	FZBRewoundCharacter Pose;
+	TestFalse(TEXT("没有采样时回溯失败"), History.Rewind(1.0, Pose));
+
+	AddSample(History, 1.0, 0b01);
+	TestTrue(TEXT("只有一个采样时任何时间都取该采样"), History.Rewind(5.0, Pose) && Pose.Location.Equals(FVector(100.0, 0.0, 0.0), KINDA_SMALL_NUMBER));
+
+	AddSample(History, 2.0, 0b10);
+	AddSample(History, 3.0, 0b100);
+
+	History.Rewind(0.5, Pose);
+	TestTrue(TEXT("早于最老采样取最老采样"), Pose.Location.Equals(FVector(100.0, 0.0, 0.0), KINDA_SMALL_NUMBER));
+	TestEqual(TEXT("早于最老采样取最老采样的标签"), Pose.StateTagMask, uint64(0b01));
+
+	History.Rewind(10.0, Pose);
+	TestTrue(TEXT("晚于最新采样取最新采样"), Pose.Location.Equals(FVector(300.0, 0.0, 0.0), KINDA_SMALL_NUMBER));
+	TestTrue(TEXT("晚于最新采样取最新采样的判定球"), Pose.HitboxLocations[0].Equals(FVector(300.0, 0.0, 50.0), KINDA_SMALL_NUMBER));
+	TestEqual(TEXT("晚于最新采样取最新采样的标签"), Pose.StateTagMask, uint64(0b100));
+
+	return true;
+}
+
+/**
+ * @brief 写满后覆盖最老的采样，回绕后的逻辑顺序与插值仍然正确
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBLagCompensationWrapAroundTest, "ZBeta.Net.LagCompensation.WrapAround", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBLagCompensationWrapAroundTest::RunTest(const FString& Parameters)
+{
+	using namespace ZBLagCompensationTest;
+
+	constexpr int32 Capacity = 4;
+	FZBPoseHistory History;
+	History.Init(Capacity, 1);
+
+	// 写入 t = 0..9，只保留最后 4 个（6, 7, 8, 9），头部回绕两圈多
+	for (int32 Step = 0; Step < 10; ++Step)
+	{
+		AddSample(History, Step, uint64(1) << Step);
+	}
+	TestEqual(TEXT("采样数不超过容量"), History.Num(), Capacity);
+
+	FZBRewoundCharacter Pose;
+	History.Rewind(2.0, Pose);
+	TestTrue(TEXT("被覆盖的时间取最老的留存采样"), Pose.Location.Equals(FVector(600.0, 0.0, 0.0), KINDA_SMALL_NUMBER));
+	TestEqual(TEXT("最老的留存采样标签"), Pose.StateTagMask, uint64(1) << 6);
+
+	// 逐个跨越物理下标的回绕点，每一段都应在正确的两次采样之间插值
+	for (int32 Step = 6; Step < 9; ++Step)
+	{
+		const double Time = Step + 0.75;
+		History.Rewind(Time, Pose);
+		TestTrue(FString::Printf(TEXT("t = %.2f 位置插值"), Time), Pose.Location.Equals(FVector(100.0 * Time, 0.0, 0.0), KINDA_SMALL_NUMBER));
+		TestTrue(FString::Printf(TEXT("t = %.2f 判定球插值"), Time), Pose.HitboxLocations[0].Equals(FVector(100.0 * Time, 0.0, 50.0), KINDA_SMALL_NUMBER));
+		TestEqual(FString::Printf(TEXT("t = %.2f 标签取较早的采样"), Time), Pose.StateTagMask, uint64(1) << Step);
+	}
+
+	return true;
+}
+
+#endif // WITH_AUTOMATION_TESTS
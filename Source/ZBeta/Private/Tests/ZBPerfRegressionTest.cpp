@@ -0,0 +1,67 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Benchmark/ZBPerfRegression.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+namespace ZBPerfRegressionTest
+{
+	// 已开始游戏的世界（专用服务器 / -game / PIE），基准需要在其中生成角色
+	UWorld* FindGameWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if (World && (Context.WorldType == EWorldType::Game || Context.WorldType == EWorldType::PIE) && World->HasBegunPlay())
+			{
+				return World;
+			}
+		}
+		return nullptr;
+	}
+}
+
+/**
+ * @brief 性能回归套件的自动化测试入口：每个基准分组一项 ZBeta.Perf.<分组>
+ * @details 与基线比较超出容差或基准未能运行即失败；结果文件与基线更新仍走 ZB.Perf.Run。
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FZBPerfRegressionTest, "ZBeta.Perf", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FZBPerfRegressionTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const FString& Group : FZBPerfRegression::GetBenchmarkGroups())
+	{
+		OutBeautifiedNames.Add(Group);
+		OutTestCommands.Add(Group);
+	}
+}
+
+bool FZBPerfRegressionTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = ZBPerfRegressionTest::FindGameWorld();
+	if (!World)
+	{
+		AddError(TEXT("没有已开始游戏的世界，请随地图启动后再运行 Automation RunTests ZBeta.Perf"));
+		return false;
+	}
+
+	TArray<FZBPerfResult> Results;
+	const bool bPassed = FZBPerfRegression::RunGroup(*World, Parameters, Results);
+	for (const FZBPerfResult& Result : Results)
+	{
+		if (!Result.bFailed)
+		{
+			AddInfo(FString::Printf(TEXT("%s: %.1f ns/op"), *Result.Name, Result.NanosecondsPerOp));
+		}
+	}
+
+	TestTrue(TEXT("没有超出基线容差的回归，且全部基准都已运行"), bPassed);
+	return bPassed;
+}
+
+#endif // WITH_AUTOMATION_TESTS
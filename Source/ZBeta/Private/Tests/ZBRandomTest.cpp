@@ -0,0 +1,85 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AbilitySystem/ZBRandom.h"
+
+namespace ZBRandomTest
+{
+	FZBRandomStreamKey MakeKey(uint32 MatchSeed, uint32 AttackerId, uint32 ActivationId, uint32 HitIndex)
+	{
+		FZBRandomStreamKey Key;
+		Key.MatchSeed = MatchSeed;
+		Key.AttackerId = AttackerId;
+		Key.ActivationId = ActivationId;
+		Key.HitIndex = HitIndex;
+		return Key;
+	}
+}
+
+/**
+ * @brief 随机数是键的纯函数：固定输入的输出钉死（改动混合函数会让旧录像与跨版本预测失配，必须有意识地更新这里）
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBRandomDeterminismTest, "ZBeta.Ability.Random.Determinism", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBRandomDeterminismTest::RunTest(const FString& Parameters)
+{
+	const FZBRandomStreamKey Key = ZBRandomTest::MakeKey(12345, 0x80000001u, 7, 3);
+
+	TestEqual(TEXT("暴击通道第 0 个数"), FZBRandom::GetUInt32(Key, EZBRandomChannel::CriticalHit), 3515767619u);
+	TestEqual(TEXT("状态触发通道第 0 个数"), FZBRandom::GetUInt32(Key, EZBRandomChannel::StatusProc), 17650244u);
+	TestEqual(TEXT("暴击通道第 1 个数"), FZBRandom::GetUInt32(Key, EZBRandomChannel::CriticalHit, 1), 2921377820u);
+
+	TestEqual(TEXT("同一键重复调用结果相同"),
+		FZBRandom::GetUInt32(Key, EZBRandomChannel::CriticalHit, 5), FZBRandom::GetUInt32(Key, EZBRandomChannel::CriticalHit, 5));
+
+	// 键的每一段都参与混合
+	const uint32 Base = FZBRandom::GetUInt32(Key, EZBRandomChannel::CriticalHit);
+	TestNotEqual(TEXT("对局种子不同"), FZBRandom::GetUInt32(ZBRandomTest::MakeKey(12346, 0x80000001u, 7, 3), EZBRandomChannel::CriticalHit), Base);
+	TestNotEqual(TEXT("攻击者不同"), FZBRandom::GetUInt32(ZBRandomTest::MakeKey(12345, 0x80000002u, 7, 3), EZBRandomChannel::CriticalHit), Base);
+	TestNotEqual(TEXT("激活不同"), FZBRandom::GetUInt32(ZBRandomTest::MakeKey(12345, 0x80000001u, 8, 3), EZBRandomChannel::CriticalHit), Base);
+	TestNotEqual(TEXT("命中序号不同"), FZBRandom::GetUInt32(ZBRandomTest::MakeKey(12345, 0x80000001u, 7, 4), EZBRandomChannel::CriticalHit), Base);
+
+	TestEqual(TEXT("空 Actor 的稳定标识为 0"), FZBRandom::GetStableActorId(nullptr), 0u);
+	return true;
+}
+
+/**
+ * @brief 分布：GetFraction 落在 [0, 1)，按命中序号变化的 RollPercent 命中率接近给定概率
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBRandomDistributionTest, "ZBeta.Ability.Random.Distribution", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBRandomDistributionTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumSamples = 100000;
+	constexpr float ChancePercent = 25.f;
+
+	int32 NumOutOfRange = 0;
+	int32 NumSucceeded = 0;
+	double FractionSum = 0.0;
+	for (int32 HitIndex = 0; HitIndex < NumSamples; ++HitIndex)
+	{
+		const FZBRandomStreamKey Key = ZBRandomTest::MakeKey(777, 42, 9, HitIndex);
+		const float Fraction = FZBRandom::GetFraction(Key, EZBRandomChannel::StatusProc);
+		if (Fraction < 0.f || Fraction >= 1.f)
+		{
+			++NumOutOfRange;
+		}
+		FractionSum += Fraction;
+		NumSucceeded += FZBRandom::RollPercent(Key, EZBRandomChannel::StatusProc, ChancePercent) ? 1 : 0;
+	}
+
+	TestEqual(TEXT("超出 [0, 1) 的 GetFraction 个数"), NumOutOfRange, 0);
+	TestEqual(TEXT("GetFraction 均值接近 0.5"), FractionSum / NumSamples, 0.5, 0.01);
+	TestEqual(TEXT("RollPercent(25) 的命中率"), 100.0 * NumSucceeded / NumSamples, static_cast<double>(ChancePercent), 1.0);
+
+	const FZBRandomStreamKey Key = ZBRandomTest::MakeKey(777, 42, 9, 0);
+	TestFalse(TEXT("0% 必定不触发"), FZBRandom::RollPercent(Key, EZBRandomChannel::StatusProc, 0.f));
+	TestTrue(TEXT("100% 必定触发"), FZBRandom::RollPercent(Key, EZBRandomChannel::StatusProc, 100.f));
+	return true;
+}
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,136 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "GameplayTagsManager.h"
+#include "AbilitySystem/ZBAbilitySystemComponent.h"
+#include "AbilitySystem/ZBGameplayTags.h"
+#include "AbilitySystem/ZBStateTagIndex.h"
+#include "Math/RandomStream.h"
+#include "UObject/Package.h"
+
+namespace ZBStateTagMaskTest
+{
+	// 进了索引的全部 State 标签（根标签与子孙标签）
+	TArray<FGameplayTag> GetIndexedStateTags()
+	{
+		const FGameplayTag& StateRoot = FZBGameplayTags::Get().State;
+		TArray<FGameplayTag> Tags;
+		UGameplayTagsManager::Get().RequestGameplayTagChildren(StateRoot).GetGameplayTagArray(Tags);
+		Tags.Insert(StateRoot, 0);
+		Tags.RemoveAll([](const FGameplayTag& Tag) { return FZBStateTagIndex::Get().IndexOf(Tag) == INDEX_NONE; });
+		return Tags;
+	}
+
+	// 按 HasMatchingGameplayTag 逐个标签算出的期望掩码
+	uint64 MakeExpectedMask(const UAbilitySystemComponent& ASC, const TArray<FGameplayTag>& IndexedTags)
+	{
+		uint64 Mask = 0;
+		for (const FGameplayTag& Tag : IndexedTags)
+		{
+			if (ASC.HasMatchingGameplayTag(Tag))
+			{
+				Mask |= uint64(1) << FZBStateTagIndex::Get().IndexOf(Tag);
+			}
+		}
+		return Mask;
+	}
+
+	FGameplayTagContainer PickTags(FRandomStream& Random, const TArray<FGameplayTag>& IndexedTags, int32 MaxCount)
+	{
+		FGameplayTagContainer Tags;
+		const int32 Count = Random.RandRange(0, MaxCount);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Tags.AddTag(IndexedTags[Random.RandHelper(IndexedTags.Num())]);
+		}
+		return Tags;
+	}
+}
+
+/**
+ * @brief 状态标签掩码与通用标签检查一致
+ *
+ * 详细流程（固定种子的随机用例）：
+ *   1. 给 ASC 加随机的 Loose State 标签（含叶子标签，父标签由计数容器隐式拥有），
+ *      GetStateTagMask 必须与逐个 HasMatchingGameplayTag 的结果相同；
+ *   2. 随机的需求 / 阻止标签编译成掩码，位运算结果必须与拥有标签容器的 HasAll / HasAny 相同；
+ *   3. 移除部分标签后重复检查，全部移除后掩码归零。
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBStateTagMaskParityTest, "ZBeta.Ability.StateTagMask.Parity", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBStateTagMaskParityTest::RunTest(const FString& Parameters)
+{
+	const TArray<FGameplayTag> IndexedTags = ZBStateTagMaskTest::GetIndexedStateTags();
+	if (!TestTrue(TEXT("状态标签索引非空（原生 Tag 已注册）"), IndexedTags.Num() > 1))
+	{
+		return false;
+	}
+
+	UZBAbilitySystemComponent* ASC = NewObject<UZBAbilitySystemComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+	FRandomStream Random(4242);
+
+	int32 NumMaskMismatches = 0;
+	int32 NumRequirementMismatches = 0;
+	auto CheckParity = [&]()
+	{
+		if (ASC->GetStateTagMask() != ZBStateTagMaskTest::MakeExpectedMask(*ASC, IndexedTags))
+		{
+			++NumMaskMismatches;
+		}
+
+		FGameplayTagContainer OwnedTags;
+		ASC->GetOwnedGameplayTags(OwnedTags);
+		for (int32 Query = 0; Query < 8; ++Query)
+		{
+			const FGameplayTagContainer RequiredTags = ZBStateTagMaskTest::PickTags(Random, IndexedTags, 2);
+			const FGameplayTagContainer BlockedTags = ZBStateTagMaskTest::PickTags(Random, IndexedTags, 3);
+			uint64 RequiredMask = 0;
+			uint64 BlockedMask = 0;
+			FZBStateTagIndex::Get().CompileMask(RequiredTags, RequiredMask);
+			FZBStateTagIndex::Get().CompileMask(BlockedTags, BlockedMask);
+
+			const uint64 OwnedMask = ASC->GetStateTagMask();
+			const bool bMasked = (OwnedMask & BlockedMask) == 0 && (OwnedMask & RequiredMask) == RequiredMask;
+			const bool bGeneric = OwnedTags.HasAll(RequiredTags) && !OwnedTags.HasAny(BlockedTags);
+			if (bMasked != bGeneric)
+			{
+				++NumRequirementMismatches;
+			}
+		}
+	};
+
+	for (int32 Iteration = 0; Iteration < 200; ++Iteration)
+	{
+		const FGameplayTagContainer Added = ZBStateTagMaskTest::PickTags(Random, IndexedTags, 6);
+		ASC->AddLooseGameplayTags(Added);
+		CheckParity();
+
+		// 移除一半，计数归零的位要清掉，父标签在还有其它子标签时保留
+		TArray<FGameplayTag> AddedTags;
+		Added.GetGameplayTagArray(AddedTags);
+		for (int32 Index = 0; Index < AddedTags.Num(); Index += 2)
+		{
+			ASC->RemoveLooseGameplayTag(AddedTags[Index]);
+		}
+		CheckParity();
+
+		for (int32 Index = 1; Index < AddedTags.Num(); Index += 2)
+		{
+			ASC->RemoveLooseGameplayTag(AddedTags[Index]);
+		}
+		if (ASC->GetStateTagMask() != 0)
+		{
+			++NumMaskMismatches;
+		}
+	}
+
+	TestEqual(TEXT("GetStateTagMask 与 HasMatchingGameplayTag 不一致的次数"), NumMaskMismatches, 0);
+	TestEqual(TEXT("掩码检查与 HasAll / HasAny 不一致的次数"), NumRequirementMismatches, 0);
+	return true;
+}
+
+#endif // WITH_AUTOMATION_TESTS
@@ -0,0 +1,142 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "Combat/ZBTimingWheel.h"
+#include "Math/RandomStream.h"
+
+namespace ZBTimingWheelTest
+{
+	/**
+	 * @brief 逐 Tick 推进，记录每个条目实际到期的 Tick
+	 * @return 全部到期（或到达 LastTick）后的到期记录，下标为条目 Id
+	 */
+	TArray<uint64> AdvanceTickByTick(FZBTimingWheel& Wheel, int32 NumIds, uint64 LastTick)
+	{
+		TArray<uint64> ExpiredAt;
+		ExpiredAt.Init(0, NumIds);
+
+		TArray<FZBTimingWheel::FEntry> Expired;
+		while (Wheel.Num() > 0 && Wheel.GetCurrentTick() < LastTick)
+		{
+			Expired.Reset();
+			Wheel.Advance(Wheel.GetCurrentTick() + 1, Expired);
+			for (const FZBTimingWheel::FEntry& Entry : Expired)
+			{
+				ExpiredAt[Entry.Id] = Wheel.GetCurrentTick();
+			}
+		}
+		return ExpiredAt;
+	}
+}
+
+/**
+ * @brief 每层边界上的延迟都恰好在到期 Tick 触发：同层、跨层下放、超出第 2 层范围的远期条目
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBTimingWheelLevelBoundaryTest, "ZBeta.Combat.TimingWheel.LevelBoundaries", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBTimingWheelLevelBoundaryTest::RunTest(const FString& Parameters)
+{
+	constexpr uint64 Level1Span = uint64(1) << FZBTimingWheel::SlotBits;
+	constexpr uint64 Level2Span = uint64(1) << (FZBTimingWheel::SlotBits * 2);
+	constexpr uint64 WheelSpan = uint64(1) << (FZBTimingWheel::SlotBits * FZBTimingWheel::NumLevels);
+	const uint64 Delays[] = {
+		1, 2, Level1Span - 1, Level1Span, Level1Span + 1,
+		Level2Span - 1, Level2Span, Level2Span + 1,
+		WheelSpan - 1, WheelSpan, WheelSpan * 2 + 17,
+	};
+
+	FZBTimingWheel Wheel;
+	// 先走一段，让当前 Tick 不在槽位边界上
+	TArray<FZBTimingWheel::FEntry> Expired;
+	Wheel.Advance(37, Expired);
+
+	const uint64 StartTick = Wheel.GetCurrentTick();
+	for (int32 Id = 0; Id < UE_ARRAY_COUNT(Delays); ++Id)
+	{
+		Wheel.Schedule(Id, StartTick + Delays[Id]);
+	}
+	TestEqual(TEXT("调度后的条目数"), Wheel.Num(), static_cast<int32>(UE_ARRAY_COUNT(Delays)));
+
+	const TArray<uint64> ExpiredAt = ZBTimingWheelTest::AdvanceTickByTick(Wheel, UE_ARRAY_COUNT(Delays), StartTick + WheelSpan * 3);
+	for (int32 Id = 0; Id < UE_ARRAY_COUNT(Delays); ++Id)
+	{
+		TestEqual(*FString::Printf(TEXT("延迟 %llu 的到期 Tick"), Delays[Id]), ExpiredAt[Id], StartTick + Delays[Id]);
+	}
+	TestEqual(TEXT("全部到期后为空"), Wheel.Num(), 0);
+	return true;
+}
+
+/**
+ * @brief 调度到过去或当前 Tick 的条目在下一 Tick 触发；空时间轮直接跳到目标 Tick
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBTimingWheelPastDueTest, "ZBeta.Combat.TimingWheel.PastDue", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBTimingWheelPastDueTest::RunTest(const FString& Parameters)
+{
+	FZBTimingWheel Wheel;
+	TArray<FZBTimingWheel::FEntry> Expired;
+
+	Wheel.Advance(1000, Expired);
+	TestEqual(TEXT("空时间轮直接推进到目标 Tick"), Wheel.GetCurrentTick(), uint64(1000));
+	TestTrue(TEXT("空时间轮没有到期条目"), Expired.IsEmpty());
+
+	Wheel.Schedule(0, 10);
+	Wheel.Schedule(1, 1000);
+	Wheel.Advance(1001, Expired);
+	TestEqual(TEXT("过去与当前 Tick 的条目都在下一 Tick 到期"), Expired.Num(), 2);
+	TestEqual(TEXT("到期后为空"), Wheel.Num(), 0);
+	return true;
+}
+
+/**
+ * @brief 随机延迟与随机步长：每个条目都在 (上一次推进的 Tick, 本次推进的 Tick] 之间到期，不早不漏
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FZBTimingWheelRandomTest, "ZBeta.Combat.TimingWheel.Randomized", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FZBTimingWheelRandomTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumEntries = 4000;
+	constexpr int32 MaxDelay = 1 << 19;
+
+	FRandomStream Random(20240611);
+	FZBTimingWheel Wheel;
+	TArray<uint64> DueTicks;
+	DueTicks.Reserve(NumEntries);
+	for (int32 Id = 0; Id < NumEntries; ++Id)
+	{
+		DueTicks.Add(1 + Random.RandHelper(MaxDelay));
+		Wheel.Schedule(Id, DueTicks.Last());
+	}
+
+	TBitArray<> Seen(false, NumEntries);
+	int32 NumSeen = 0;
+	int32 NumWrong = 0;
+	TArray<FZBTimingWheel::FEntry> Expired;
+	while (Wheel.Num() > 0)
+	{
+		const uint64 PreviousTick = Wheel.GetCurrentTick();
+		Expired.Reset();
+		Wheel.Advance(PreviousTick + 1 + Random.RandHelper(300), Expired);
+
+		for (const FZBTimingWheel::FEntry& Entry : Expired)
+		{
+			const uint64 DueTick = DueTicks[Entry.Id];
+			if (Seen[Entry.Id] || DueTick <= PreviousTick || DueTick > Wheel.GetCurrentTick())
+			{
+				++NumWrong;
+			}
+			Seen[Entry.Id] = true;
+			++NumSeen;
+		}
+	}
+
+	TestEqual(TEXT("到期 Tick 不在本次推进区间内或重复到期的条目数"), NumWrong, 0);
+	TestEqual(TEXT("全部条目都到期"), NumSeen, NumEntries);
+	return true;
+}
+
+#endif // WITH_AUTOMATION_TESTS
@@ -18,11 +18,53 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Input", meta = (DisplayName = "启动输入标签", Categories = "InputTag"))
 	FGameplayTag StartupInputTag;
 
+	/**
+	 * @brief 激活标签需求检查（掩码快速路径）
+	 *
+	 * 功能说明：
+	 *   - ActivationRequiredTags / ActivationBlockedTags 全部是 State.* 索引标签、且没有 Source / Target 需求时，
+	 *     按类编译成一次掩码，与 UZBAbilitySystemComponent::GetStateTagMask 做位运算，不再遍历拥有标签容器；
+	 *   - 其余情况（非索引标签、非 ZB 的 ASC）走引擎的通用检查。
+	 *
+	 * 注意事项：
+	 *   - 检查失败且调用方需要 OptionalRelevantTags 时，仍交给通用检查填充失败原因；
+	 *   - 掩码取自类默认对象，运行时修改实例上的需求标签不会生效；
+	 *   - 非 Shipping 下 zb.Ability.ValidateTagMasks 1 会同时跑通用检查并比对结果。
+	 */
+	virtual bool DoesAbilitySatisfyTagRequirements(const UAbilitySystemComponent& AbilitySystemComponent, const FGameplayTagContainer* SourceTags = nullptr, const FGameplayTagContainer* TargetTags = nullptr, OUT FGameplayTagContainer* OptionalRelevantTags = nullptr) const override;
 
+	// 本次激活的随机流标识（FZBRandom 键的 ActivationId）
+	uint32 GetRandomActivationId() const { return RandomActivationId; }
+
+	/**
+	 * @brief 激活前记录随机流标识
+	 * @details 预测激活取预测键（客户端与服务器相同）；服务器发起的激活没有预测键，
+	 *          取 ASC 上递增的激活序号并置最高位，与预测键区分。
+	 */
+	virtual void PreActivate(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, FOnGameplayAbilityEnded::FDelegate* OnGameplayAbilityEndedDelegate, const FGameplayEventData* TriggerEventData = nullptr) override;
 
 protected:
 
 	float GetManaCost(float InLevel = 1.f) const;
 	float GetCooldown(float InLevel = 1.f) const;
 
+private:
+	// 编译后的激活需求
+	struct FZBTagRequirementMasks
+	{
+		uint64 Required = 0;
+		uint64 Blocked = 0;
+		bool bCompiled = false;
+		// 需求能完全用掩码表达
+		bool bUseMasks = false;
+	};
+
+	// 本类的编译结果（实例统一取类默认对象上的，每个类只编译一次）
+	const FZBTagRequirementMasks& GetTagRequirementMasks() const;
+	void CompileTagRequirementMasks() const;
+
+	mutable FZBTagRequirementMasks TagRequirementMasks;
+
+	uint32 RandomActivationId = 0;
+
 };
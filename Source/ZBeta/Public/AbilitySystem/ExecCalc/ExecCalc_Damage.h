@@ -0,0 +1,40 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayEffectExecutionCalculation.h"
+#include "ExecCalc_Damage.generated.h"
+
+/**
+ * @brief 单次结算的伤害执行计算
+ *
+ * 功能说明：
+ *   - 伤害 GE 用 SetByCaller 按伤害类型传入原始伤害（Damage.Type.Physical / Magical / Fire / Ice），
+ *     削韧值用 Damage.Toughness 传入；
+ *   - 源与目标属性各捕获一次，一次遍历完成：分类型抗性减免 -> 暴击 -> 削韧 -> 吸取返还；
+ *   - 最终伤害输出到目标的 IncomingDamage，暴击 / 削韧 / 返还写进 FZBGameplayEffectContext，
+ *     由 UZBAttributeSet::PostGameplayEffectExecute 统一落地；
+ *   - 带 DOT 参数（Debuff.Data.*）的 GE 按触发概率登记到 UZBDotSubsystem。
+ *
+ * 公式：
+ *   - 减免：物理伤害对应 PhysicalResistance，魔法 / 火焰 / 冰冻对应 MagicResistance，
+ *     实际伤害 = 原始伤害 * K / (K + 抗性)，K = ResistanceConstant，抗性小于 0 按 0 处理；
+ *   - 暴击：CriticalChance 为百分比，暴击时伤害 * (1 + CriticalDamage / 100)，暴击与 DOT 触发的随机数取自 FZBRandom；
+ *   - 吸取：返还 = 最终伤害 * 对应吸取率 / 100。
+ */
+UCLASS()
+class ZBETA_API UExecCalc_Damage : public UGameplayEffectExecutionCalculation
+{
+	GENERATED_BODY()
+
+public:
+	UExecCalc_Damage();
+
+	virtual void Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const override;
+
+protected:
+	// 抗性曲线常数：抗性等于该值时减免 50%
+	UPROPERTY(EditDefaultsOnly, Category = "Damage", meta = (DisplayName = "抗性常数", ClampMin = "1"))
+	float ResistanceConstant = 100.f;
+};
@@ -15,6 +15,8 @@ class ZBETA_API UZBAbilitySystemComponent : public UAbilitySystemComponent
 	GENERATED_BODY()
 
 public:
+	UZBAbilitySystemComponent();
+
 	void AbilityInputForTagPressed(const FGameplayTag& InputTag);
 	void AbilityInputForTagReleased(const FGameplayTag& InputTag);
 	void AbilityInputForTagHeld(const FGameplayTag& InputTag);
@@ -26,5 +28,37 @@ public:
 	bool bStartupAbilitiesGiven = false;
 	void AddCharacterAbilities(const TArray<TSubclassOf<UGameplayAbility>> & StartUpAbilities);
 	void AddCharacterPassiveAbilities(const TArray<TSubclassOf<UGameplayAbility>> & StartUpPassiveAbilities);
+
+	// 统计：GE 应用次数 / 耗时
+	virtual FActiveGameplayEffectHandle ApplyGameplayEffectSpecToSelf(const FGameplayEffectSpec& GameplayEffect, FPredictionKey PredictionKey = FPredictionKey()) override;
+
+	// 统计：技能激活次数
+	virtual void NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability) override;
+
+	// State 标签位掩码（位定义见 FZBStateTagIndex），位为 1 表示 HasMatchingGameplayTag 为真
+	uint64 GetStateTagMask() const { return StateTagMask; }
+
+	// 服务器发起（无预测键）的激活序号，用作确定性随机流的 ActivationId
+	uint32 AllocateActivationSerial() { return ++ActivationSerial & 0x7FFFFFFFu; }
+
+	// 是否复制标签计数表（MinimalReplicationTags / ReplicatedLooseTags），默认复制。
+	// Minimal 模式的敌人关闭它，可见标签改由 CombatProxy 的 VisibleTagMask 同步，避免同一份状态发两遍
+	void SetReplicateTagMap(bool bInReplicateTagMap) { bReplicateTagMap = bInReplicateTagMap; }
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+protected:
+	// 统计：Tag 增删次数（计数在 0 与非 0 之间切换时调用）
+	virtual void OnTagUpdated(const FGameplayTag& Tag, bool TagExists) override;
+
+private:
+	// 任意 Tag（含父标签）的计数在 0 与非 0 之间切换时调用，维护 StateTagMask
+	void OnAnyTagCountChanged(const FGameplayTag Tag, int32 NewCount);
+
+	uint64 StateTagMask = 0;
+
+	uint32 ActivationSerial = 0;
+
+	bool bReplicateTagMap = true;
 	
 };
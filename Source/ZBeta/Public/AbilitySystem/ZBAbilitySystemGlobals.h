@@ -0,0 +1,20 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AbilitySystemGlobals.h"
+#include "ZBAbilitySystemGlobals.generated.h"
+
+/**
+ * @brief 项目的 AbilitySystemGlobals，让所有 EffectContext 都是 FZBGameplayEffectContext
+ * @note  DefaultGame.ini: [/Script/GameplayAbilities.GameplayAbilitiesDeveloperSettings] AbilitySystemGlobalsClassName
+ */
+UCLASS()
+class ZBETA_API UZBAbilitySystemGlobals : public UAbilitySystemGlobals
+{
+	GENERATED_BODY()
+
+public:
+	virtual FGameplayEffectContext* AllocGameplayEffectContext() const override;
+};
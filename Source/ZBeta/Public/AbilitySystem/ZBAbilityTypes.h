@@ -0,0 +1,66 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayEffectTypes.h"
+#include "ZBAbilityTypes.generated.h"
+
+/**
+ * @brief ZBeta 的 GameplayEffect 上下文
+ *
+ * 功能说明：
+ *   - UExecCalc_Damage 一次结算后把附带结果写进来：是否暴击、削韧值、攻击者的吸取返还；
+ *   - 目标 AttributeSet 在处理 IncomingDamage 时读取，不用再为削韧 / 吸取各走一条 GE。
+ *
+ * 注意事项：
+ *   - 由 UZBAbilitySystemGlobals::AllocGameplayEffectContext 分配，需在 DefaultGame.ini 中指定全局类；
+ *   - 只复制 bCriticalHit（客户端伤害数字 / Cue 用），削韧与返还只在服务器使用；
+ *   - HitIndex 由发起命中的一方写入，客户端预测时按相同规则自行填写。
+ */
+USTRUCT(BlueprintType)
+struct ZBETA_API FZBGameplayEffectContext : public FGameplayEffectContext
+{
+	GENERATED_BODY()
+
+public:
+	// 本次伤害是否暴击
+	UPROPERTY()
+	bool bCriticalHit = false;
+
+	// 对目标韧性的削减
+	UPROPERTY()
+	float ToughnessDamage = 0.f;
+
+	// 返还给攻击者的生命 / 法力 / 体力
+	UPROPERTY()
+	float HealthReturn = 0.f;
+
+	UPROPERTY()
+	float ManaReturn = 0.f;
+
+	UPROPERTY()
+	float StaminaReturn = 0.f;
+
+	// 同一次激活内的命中序号（近战为挥砍序号），参与 FZBRandom 的键；两端各自填写，不复制
+	UPROPERTY()
+	uint32 HitIndex = 0;
+
+	// 句柄里是 FZBGameplayEffectContext 时返回它，否则返回 nullptr
+	static FZBGameplayEffectContext* Get(FGameplayEffectContextHandle& Handle);
+	static const FZBGameplayEffectContext* Get(const FGameplayEffectContextHandle& Handle);
+
+	virtual UScriptStruct* GetScriptStruct() const override { return StaticStruct(); }
+	virtual FZBGameplayEffectContext* Duplicate() const override;
+	virtual bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FZBGameplayEffectContext> : public TStructOpsTypeTraitsBase2<FZBGameplayEffectContext>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithCopy = true,
+	};
+};
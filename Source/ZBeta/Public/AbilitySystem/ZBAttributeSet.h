@@ -303,6 +303,8 @@ public:
 
 
 private:
+	// 处理 IncomingDamage：扣血、削韧、吸取返还入队
+	void HandleIncomingDamage(const struct FGameplayEffectModCallbackData& Data);
 	
 };
 
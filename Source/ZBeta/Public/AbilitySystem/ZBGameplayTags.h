@@ -121,6 +121,9 @@ struct FZBGameplayTags
 	 */
 	static void InitializeNativeTags();
 
+	// 已注册的原生 Tag 数量（启动报告用）
+	static int32 GetNumNativeTags() { return NumNativeTags; }
+
 	// ========================================
 	// 第一部分：属性相关 Tags（Attributes）
 	// ========================================
@@ -749,6 +752,17 @@ struct FZBGameplayTags
 	 */
 	FGameplayTag Damage_Type_Ice;
 
+	/**
+	 * @section 削韧
+	 */
+
+	/** 
+	 * 削韧值（SetByCaller 键）
+	 * 含义：本次攻击对目标韧性造成的削减，不受抗性减免
+	 * 应用：UExecCalc_Damage 读取后写入 EffectContext，由目标 AttributeSet 在结算 IncomingDamage 时扣除韧性
+	 */
+	FGameplayTag Damage_Toughness;
+
 
 	// ========================================
 	// 第六部分：受击反应 Tags（HitReact）
@@ -1072,6 +1086,9 @@ private:
 	 */
 	static FZBGameplayTags GameplayTags;
 
+	// InitializeNativeTags() 中成功注册的 Tag 计数
+	static int32 NumNativeTags;
+
 	// ==================== 辅助方法 ====================
 
 	/**
@@ -0,0 +1,65 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UAbilitySystemComponent;
+struct FGameplayEffectSpec;
+
+// 同一次命中上的不同判定各用一个通道，互不相关
+enum class EZBRandomChannel : uint8
+{
+	CriticalHit,
+	StatusProc,
+};
+
+/**
+ * @brief 一条随机流的键：（对局种子，攻击者，技能激活，命中序号）
+ */
+struct FZBRandomStreamKey
+{
+	uint32 MatchSeed = 0;
+	uint32 AttackerId = 0;
+	uint32 ActivationId = 0;
+	uint32 HitIndex = 0;
+};
+
+/**
+ * @brief 基于计数器的确定性随机数
+ *
+ * 功能说明：
+ *   - 随机数是键的纯函数（SplitMix64 逐段混合），没有任何内部状态，不依赖调用顺序；
+ *   - 同一对局里同一攻击者、同一次激活、对同一目标的同一次命中，在服务器、预测客户端与回放中掷出相同结果；
+ *   - 用于暴击（CriticalChance）与状态触发（Effect.Data.Chance）。
+ *
+ * 键的来源（MakeEffectKey）：
+ *   - MatchSeed：AZBGameState::MatchSeed（服务器生成并复制，可用 ?Seed= 指定以便回放 / 基准复现）；
+ *   - AttackerId：玩家取 PlayerId，其它取 Actor 名字的 CRC；
+ *   - ActivationId：UZBGameplayAbility 在激活时记录（预测激活用预测键，双方一致）；
+ *   - HitIndex：FZBGameplayEffectContext::HitIndex（近战为挥砍序号）与目标 Id 组合。
+ *
+ * 注意事项：
+ *   - 运行时生成的非玩家 Actor 在客户端与服务器的名字不同，它们之间的结果只在服务器上可复现（这类攻击本来也不做客户端预测）；
+ *   - 不要用于需要保密的随机（键对客户端是公开的）。
+ */
+struct ZBETA_API FZBRandom
+{
+	// 指定通道上的第 Counter 个 32 位随机数
+	static uint32 GetUInt32(const FZBRandomStreamKey& Key, EZBRandomChannel Channel, uint32 Counter = 0);
+
+	// [0, 1) 的浮点数（24 位精度）
+	static float GetFraction(const FZBRandomStreamKey& Key, EZBRandomChannel Channel, uint32 Counter = 0);
+
+	// ChancePercent 为百分比（0 - 100）
+	static bool RollPercent(const FZBRandomStreamKey& Key, EZBRandomChannel Channel, float ChancePercent);
+
+	// 由 GE 规格（源 / 技能 / 上下文）与目标生成键
+	static FZBRandomStreamKey MakeEffectKey(const FGameplayEffectSpec& Spec, const UAbilitySystemComponent* Target);
+
+	// 跨端一致的 Actor 标识
+	static uint32 GetStableActorId(const AActor* Actor);
+
+	static uint32 GetMatchSeed(const UObject* WorldContextObject);
+};
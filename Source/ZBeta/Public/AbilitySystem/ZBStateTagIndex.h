@@ -0,0 +1,45 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * @brief State.* 标签的位索引
+ *
+ * 功能说明：
+ *   - 把 State 根标签及其所有子标签（最多 64 个）映射到 uint64 的位上；
+ *   - 某一位为 1 表示 ASC 拥有该标签或它的子标签（即 HasMatchingGameplayTag 为真），
+ *     与 FGameplayTagContainer::HasAny / HasAll 对拥有标签的匹配语义一致；
+ *   - UZBAbilitySystemComponent 在 Tag 计数变化时维护位掩码，UZBGameplayAbility 把激活需求编译成掩码比较。
+ *
+ * 注意事项：
+ *   - 第一次 Get() 时按当时已注册的 Tag 建表，必须在原生 Tag 注册之后（UZBAssetManager 启动阶段）；
+ *   - 超过 64 个的 State 标签与非 State 标签不进索引，用到它们的能力走引擎的通用检查；
+ *   - 只在游戏线程使用。
+ */
+class ZBETA_API FZBStateTagIndex
+{
+public:
+	static constexpr int32 MaxIndexedTags = 64;
+
+	static const FZBStateTagIndex& Get();
+
+	// 标签自身的位，不在索引里返回 INDEX_NONE
+	int32 IndexOf(const FGameplayTag& Tag) const;
+
+	/**
+	 * @brief 把一组需求标签编译成掩码
+	 * @return 所有标签都在索引里时返回 true；否则 OutMask 无意义，调用方应走通用检查
+	 */
+	bool CompileMask(const FGameplayTagContainer& Tags, uint64& OutMask) const;
+
+	int32 Num() const { return IndexedTags.Num(); }
+
+private:
+	FZBStateTagIndex();
+
+	TArray<FGameplayTag> IndexedTags;
+	TMap<FGameplayTag, int32> TagToIndex;
+};
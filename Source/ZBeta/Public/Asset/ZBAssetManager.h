@@ -4,13 +4,34 @@
 
 #include "CoreMinimal.h"
 #include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/ObjectKey.h"
 #include "ZBAssetManager.generated.h"
 
+class AZBCharacterBase;
+class UWorld;
+
 /**
  * 游戏的资源管理器
  * 负责在引擎启动时加载全局数据（如 Native GameplayTags）
+ *
+ * 启动分阶段计时（写入 Saved/Benchmarks/ZBStartupReport.json，专用服务器冷启动看这里）：
+ *   NativeTags           -> 注册原生 GameplayTags（后续加载的蓝图要解析这些 Tag，必须最先做）
+ *   PrimaryAssetScan     -> Super::StartInitialLoading（主资源扫描，CharacterLoadout 要在这之后才能按 ID 加载）
+ *   PreloadCharacters    -> 异步预载配置的角色 Loadout（类 + 能力 / GE Bundle），与下一个阶段并行
+ *   AbilitySystemGlobals -> UAbilitySystemGlobals::InitGlobalData
+ *
+ * CharacterLoadout：
+ *   角色蓝图类本身就是主资源（见 AZBCharacterBase::GetPrimaryAssetId），能力与 GE 是软引用，
+ *   分在 Abilities / Attributes 两个 Bundle 里；生成角色前调用 LoadCharacterLoadout 异步流送。
+ *
+ * Loadout 的释放（按主资源 ID 计数）：
+ *   - 角色 BeginPlay / EndPlay 登记存活实例（AddLoadoutUser / RemoveLoadoutUser）；
+ *   - GameMode 预流送的 Loadout 钉在当前世界上（PinCharacterLoadout），世界清理（换图）时解除；
+ *   - PreloadCharacterClasses 常驻，不释放；
+ *   - 三者都不再持有时 UnloadPrimaryAsset，能力与 GE 可被 GC 回收。
  */
-UCLASS()
+UCLASS(Config = Game)
 class ZBETA_API UZBAssetManager : public UAssetManager
 {
 	GENERATED_BODY()
@@ -18,9 +39,85 @@ class ZBETA_API UZBAssetManager : public UAssetManager
 public:
 	// 获取单例的静态方法
 	static UZBAssetManager& Get();
-	
+
+	// 角色蓝图类的主资源类型与 Bundle 名
+	static const FPrimaryAssetType CharacterLoadoutType;
+	static const FName AbilitiesBundle;
+	static const FName AttributesBundle;
+
+	// 角色类对应的 CharacterLoadout 主资源 ID（不需要先加载类）
+	static FPrimaryAssetId GetCharacterLoadoutId(const TSoftClassPtr<AZBCharacterBase>& CharacterClass);
+
+	/**
+	 * @brief 异步流送角色类及其能力 / GE
+	 * @param CharacterClass 角色蓝图类
+	 * @param OnLoaded       全部加载完成后回调（已加载时也会回调）
+	 * @return 流送句柄；类没有注册为 CharacterLoadout 时只加载类本身，能力与 GE 在使用处同步加载兜底
+	 *
+	 * 注意事项：
+	 *   - 通过主资源加载的 Loadout 由 AssetManager 持有，直到没有存活实例且没有被钉住（见类注释）。
+	 */
+	TSharedPtr<FStreamableHandle> LoadCharacterLoadout(const TSoftClassPtr<AZBCharacterBase>& CharacterClass, FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+	// 强制释放 Loadout，不检查存活实例与钉住状态
+	void UnloadCharacterLoadout(const TSoftClassPtr<AZBCharacterBase>& CharacterClass);
+
+	// 把 Loadout 钉在世界上，该世界清理前不释放（关卡预流送的角色类，实例还没生成）
+	void PinCharacterLoadout(const UWorld* World, const TSoftClassPtr<AZBCharacterBase>& CharacterClass);
+
+	// 角色实例登记 / 注销（AZBCharacterBase::BeginPlay / EndPlay）；最后一个实例结束时尝试释放
+	void AddLoadoutUser(const AZBCharacterBase& Character);
+	void RemoveLoadoutUser(const AZBCharacterBase& Character);
+
 private:
 	/** 引擎初始化加载数据时会调用此函数 */
 	virtual void StartInitialLoading() override;
-	
+
+	// 启动阶段计时
+	struct FStartupPhase
+	{
+		FString Name;
+		double StartSeconds = 0.0;
+		double Milliseconds = 0.0;
+	};
+
+	void AddStartupPhase(const TCHAR* Name, double StartSeconds, double EndSeconds);
+
+	// 发起角色 Loadout 的异步预载，完成回调里记录阶段耗时
+	void StartPreloadCharacterClasses();
+	void OnPreloadCharacterClassesComplete();
+
+	// 同步阶段与异步预载都结束后写启动报告
+	void TryWriteStartupReport();
+
+	// 实例的 Loadout ID（原生类没有，返回无效 ID）
+	static FPrimaryAssetId GetLoadoutIdOf(const AZBCharacterBase& Character);
+
+	// 没有存活实例、没有被任何世界钉住、也不是常驻时释放
+	void TryUnloadLoadout(const FPrimaryAssetId& LoadoutId);
+
+	// 世界清理：解除该世界钉住的 Loadout 并尝试释放
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	// 启动时异步预载 Loadout 的角色类（DefaultGame.ini 配置）
+	UPROPERTY(Config)
+	TArray<TSoftClassPtr<AZBCharacterBase>> PreloadCharacterClasses;
+
+	// 预载句柄（合并句柄，只用于等待完成；常驻由 AssetManager 的主资源加载状态保证）
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+
+	// PreloadCharacterClasses 对应的 ID，常驻
+	TSet<FPrimaryAssetId> ResidentLoadouts;
+
+	// 各 Loadout 的存活实例数（PIE 多个世界共用一份计数）
+	TMap<FPrimaryAssetId, int32> LoadoutUserCounts;
+
+	// 各世界钉住的 Loadout
+	TMap<TObjectKey<UWorld>, TSet<FPrimaryAssetId>> WorldPinnedLoadouts;
+
+	TArray<FStartupPhase> StartupPhases;
+	double StartupBeginSeconds = 0.0;
+	double PreloadStartSeconds = 0.0;
+	bool bSyncPhasesDone = false;
+	bool bPreloadDone = false;
 };
@@ -0,0 +1,197 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "GameplayTagContainer.h"
+#include "GameplayAbilitySpecHandle.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ZBCombatSoakSubsystem.generated.h"
+
+class AZBEnemyCharacter;
+class AZBPlayerCharacter;
+class UAbilitySystemComponent;
+class UGameplayAbility;
+class UGameplayEffect;
+struct FActiveGameplayEffectHandle;
+struct FGameplayEffectSpec;
+
+/**
+ * @brief 压测用的 AI 玩家控制器
+ * @details 需要 PlayerState（玩家 ASC 挂在 PlayerState 上），GameMode 的 PlayerStateClass 不是 AZBPlayerState 时自己补一个。
+ */
+UCLASS(NotBlueprintable, Transient)
+class ZBETA_API AZBSoakBotController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+	AZBSoakBotController();
+
+	virtual void InitPlayerState() override;
+};
+
+/**
+ * @brief 无头战斗压测（Soak Benchmark）
+ *
+ * 功能说明：
+ *   - 命令行带 -ZBSoak 时才会创建，在专用服务器上加载地图后生成 N 个敌人、M 个 AI 玩家；
+ *   - 按固定频率驱动脚本化战斗：技能激活（玩家走输入标签路径）、GE 应用、Tag 增删、移动；
+ *   - 跑满指定时长后把帧时间分位数、GE/秒、内存写进 CSV，然后退出进程；
+ *   - 复制压测：指定 -ZBSoakConnections=N 时，预热结束后等到 N 个客户端连接（无头机器人，见 UZBBotComponent）
+ *     才开始统计，并额外记录复制图每帧耗时（UZBReplicationGraph::ServerReplicateActors）与服务器发送带宽。
+ *
+ * 用法：
+ *   ZBetaServer /Game/Map/DemonstrationmMap -nullrhi -log -ZBSoak
+ *       -ZBSoakEnemies=500 -ZBSoakPlayers=16 -ZBSoakDuration=120 -ZBSoakCsv=D:/Soak.csv
+ *
+ *   复制图基准（64 个连接 x 1000 个敌人）：
+ *   ZBetaServer /Game/Map/DemonstrationmMap -nullrhi -log -ZBSoak
+ *       -ZBSoakEnemies=1000 -ZBSoakPlayers=0 -ZBSoakConnections=64 -ZBSoakDuration=120 -ZBSoakCsv=D:/SoakRepGraph.csv
+ *   然后启动 64 个机器人进程：ZBeta 127.0.0.1 -nullrhi -nosound -ZBBot -ZBBotDuration=600 -ZBBotFPS=30
+ *   对比默认相关性遍历：服务器加 -ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:ReplicationDriverClassName= 再跑一次
+ *
+ * 注意事项：
+ *   - 帧时间取 DeltaTime - IdleTime，即扣掉 NetServerMaxTickRate 限帧休眠后的真实工作时间；
+ *   - CSV 采用追加写入，同一个文件可以累积多次运行作为对比基线（表头只在新文件写入，列变化后请换新文件）；
+ *   - 等待连接超过 ConnectTimeoutSeconds 仍不足 N 个时照常开始统计并警告，CSV 的 Connections 列记录实际连接数；
+ *   - 没有使用复制图时复制耗时列为 0。
+ */
+UCLASS(Config = Game)
+class ZBETA_API UZBCombatSoakSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// ========== 配置（DefaultGame.ini，命令行同名参数可覆盖数量与时长） ==========
+
+	// 敌人类（为空时使用 AZBEnemyCharacter）
+	UPROPERTY(Config)
+	TSoftClassPtr<AZBEnemyCharacter> EnemyClass;
+
+	// 玩家类（必须配置了默认属性 GE 的蓝图子类）
+	UPROPERTY(Config)
+	TSoftClassPtr<AZBPlayerCharacter> PlayerClass;
+
+	// 战斗中施加的 GE（为空时使用一个临时的瞬时扣血 GE）
+	UPROPERTY(Config)
+	TSoftClassPtr<UGameplayEffect> CombatEffectClass;
+
+	UPROPERTY(Config)
+	int32 NumEnemies = 100;
+
+	UPROPERTY(Config)
+	int32 NumPlayers = 8;
+
+	// 统计时长（秒，不含预热）
+	UPROPERTY(Config)
+	float DurationSeconds = 60.f;
+
+	// 预热时长（秒），期间的帧不计入统计
+	UPROPERTY(Config)
+	float WarmupSeconds = 5.f;
+
+	// 每个角色每秒执行的战斗动作数
+	UPROPERTY(Config)
+	float ActionsPerActorPerSecond = 2.f;
+
+	// 生成范围半径
+	UPROPERTY(Config)
+	float SpawnRadius = 5000.f;
+
+	UPROPERTY(Config)
+	int32 RandomSeed = 20251018;
+
+	// 开始统计前需要的客户端连接数（-ZBSoakConnections=），0 表示不等待
+	UPROPERTY(Config)
+	int32 NumConnections = 0;
+
+	// 预热结束后等待连接的最长时间（秒）
+	UPROPERTY(Config)
+	float ConnectTimeoutSeconds = 180.f;
+
+private:
+	// 一个被压测驱动的角色
+	struct FSoakActor
+	{
+		TWeakObjectPtr<APawn> Pawn;
+		TWeakObjectPtr<UAbilitySystemComponent> ASC;
+		// 是否是玩家（玩家走输入标签路径，敌人直接 TryActivateAbility）
+		bool bIsPlayer = false;
+		// 动作累积器，>= 1 时执行一次动作
+		float ActionAccumulator = 0.f;
+		// 当前移动方向（仅玩家）
+		FVector MoveDirection = FVector::ForwardVector;
+	};
+
+	void ParseCommandLine();
+	void SpawnSoakActors(UWorld& InWorld);
+	void RegisterSoakActor(APawn* Pawn, UAbilitySystemComponent* ASC, bool bIsPlayer);
+	FVector GetRandomSpawnLocation(const FVector& Origin);
+
+	// 执行一次随机战斗动作
+	void PerformCombatAction(FSoakActor& Actor);
+	void ActivateRandomAbility(FSoakActor& Actor);
+	void ApplyCombatEffect(FSoakActor& Actor);
+	void ChurnTag(FSoakActor& Actor);
+
+	// ASC 计数回调
+	void OnGameplayEffectApplied(UAbilitySystemComponent* Target, const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle);
+	void OnAbilityActivated(UGameplayAbility* Ability);
+	void OnAnyTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	// 统计结束：写 CSV 并退出（CSV 写入失败时退出码为 1）
+	void FinishSoak();
+	// 返回 CSV 是否写入成功
+	bool WriteCsv() const;
+
+	// 当前的客户端连接数与服务器累计发送字节数（没有 NetDriver 时为 0）
+	int32 GetNumClientConnections() const;
+	uint64 GetOutTotalBytes() const;
+	// 上一帧复制图的耗时（毫秒），没有使用 UZBReplicationGraph 时返回 false
+	bool GetReplicationMs(float& OutMs) const;
+
+	TArray<FSoakActor> SoakActors;
+
+	// 战斗中参与 Tag 翻转的标签
+	TArray<FGameplayTag> ChurnTags;
+
+	// 输入标签根节点，用于从 AbilitySpec 的动态标签里找出 InputTag
+	FGameplayTag InputTagRoot;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UGameplayEffect> CombatEffect;
+
+	FRandomStream RandomStream;
+	FString CsvPath;
+	FString MapName;
+
+	bool bRunning = false;
+	bool bMeasuring = false;
+	double StartTime = 0.0;
+	double MeasureStartTime = 0.0;
+	double MeasureEndTime = 0.0;
+
+	// 统计数据（仅统计阶段累加）
+	TArray<float> FrameTimesMs;
+	TArray<float> ReplicationTimesMs;
+	uint64 StartOutBytes = 0;
+	uint64 EndOutBytes = 0;
+	int32 EndConnections = 0;
+	int64 NumEffectsApplied = 0;
+	int64 NumAbilitiesActivated = 0;
+	int64 NumTagChanges = 0;
+	uint64 PeakUsedPhysical = 0;
+	uint64 StartUsedPhysical = 0;
+	int32 LastMemorySampleSecond = INDEX_NONE;
+};
@@ -0,0 +1,85 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AZBCharacterBase;
+class UAbilitySystemComponent;
+class UWorld;
+
+/**
+ * @brief 单个角色的内存占用（字节）
+ *
+ * 合计 = Actor + Components + ASC + AttributeSets + AbilityInstances + Replication，
+ * 这几列是互不重叠的对象；ActiveGEs / AbilitySpecs / Tags 是 ASC 列内部容器的细分，不重复计入合计。
+ */
+struct FZBCharacterMemory
+{
+	FString Name;
+	FString ClassName;
+	bool bIsPlayer = false;
+
+	// 角色 Actor 本身（玩家还包括 PlayerState Actor）
+	SIZE_T ActorBytes = 0;
+	// 除 ASC 外的所有组件（CharacterMovement、Mesh、SpringArm、Camera 等）
+	SIZE_T ComponentBytes = 0;
+	SIZE_T ASCBytes = 0;
+	SIZE_T ActiveEffectBytes = 0;
+	SIZE_T AbilitySpecBytes = 0;
+	SIZE_T AbilityInstanceBytes = 0;
+	SIZE_T AttributeSetBytes = 0;
+	SIZE_T TagBytes = 0;
+	// 服务器上各连接的 ActorChannel 复制器（影子状态等）
+	SIZE_T ReplicationBytes = 0;
+
+	int32 NumActiveEffects = 0;
+	int32 NumAbilitySpecs = 0;
+	int32 NumAbilityInstances = 0;
+
+	SIZE_T GetTotalBytes() const
+	{
+		return ActorBytes + ComponentBytes + ASCBytes + AttributeSetBytes + AbilityInstanceBytes + ReplicationBytes;
+	}
+};
+
+/**
+ * @brief 角色内存占用报告
+ *
+ * 功能说明：
+ *   - 遍历世界里所有 AZBCharacterBase，按子系统统计字节数，输出汇总表并导出 CSV；
+ *   - UObject 的大小取 GetResourceSizeBytes(Exclusive)（对象本身 + 反射容器的分配），
+ *     GE、AbilitySpec、Tag 等非 UObject 数据按容器分配大小估算。
+ *
+ * 用法：
+ *   ZB.MemReport [CsvPath]                                   （控制台，统计当前世界）
+ *   UnrealEditor-Cmd ZBeta -run=ZBMemoryReport -Enemies=100    （Commandlet，见 UZBMemoryReportCommandlet）
+ *
+ * 注意事项：
+ *   - 估算值只用于同一构建下的横向对比（新功能加了多少），不等同于 memreport 的实际分配；
+ *   - 复制状态只在服务器（有客户端连接时）才有数据。
+ */
+class ZBETA_API FZBMemoryReport
+{
+public:
+	/**
+	 * @brief 统计世界中所有角色
+	 * @param World 要统计的世界
+	 * @return 每个角色一条
+	 */
+	static TArray<FZBCharacterMemory> Collect(UWorld* World);
+
+	static FZBCharacterMemory MeasureCharacter(AZBCharacterBase* Character);
+
+	/**
+	 * @brief 输出按类汇总的平均值，并写 CSV（每个角色一行）
+	 * @param Entries Collect 的结果
+	 * @param CsvPath CSV 路径，为空时写到 Saved/Benchmarks/ZBMemReport_<时间>.csv
+	 * @param Ar      汇总表的输出设备
+	 */
+	static void Report(const TArray<FZBCharacterMemory>& Entries, const FString& CsvPath, FOutputDevice& Ar);
+
+private:
+	static void MeasureAbilitySystem(const UAbilitySystemComponent* ASC, FZBCharacterMemory& OutEntry);
+	static SIZE_T MeasureReplication(const AActor* Actor);
+};
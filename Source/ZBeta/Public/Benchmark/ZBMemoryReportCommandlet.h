@@ -0,0 +1,33 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ZBMemoryReportCommandlet.generated.h"
+
+/**
+ * @brief 角色内存报告 Commandlet
+ *
+ * 功能说明：
+ *   - 在一个空的临时游戏世界里生成指定数量的敌人与玩家（玩家由 AZBSoakBotController 控制，带 PlayerState），
+ *     跑若干帧让 BeginPlay / 默认 GE / 初始能力都就位后，用 FZBMemoryReport 统计并导出 CSV；
+ *   - 角色类默认取压测配置 [/Script/ZBeta.ZBCombatSoakSubsystem] 的 EnemyClass / PlayerClass。
+ *
+ * 用法：
+ *   UnrealEditor-Cmd ZBeta -run=ZBMemoryReport [-Enemies=100] [-Players=4]
+ *       [-EnemyClass=/Game/...] [-PlayerClass=/Game/...] [-Csv=D:/Mem.csv]
+ *
+ * 注意事项：
+ *   - 空世界里没有网络连接，复制状态列为 0；要看复制状态请在带客户端的服务器上用 ZB.MemReport。
+ */
+UCLASS()
+class ZBETA_API UZBMemoryReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UZBMemoryReportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,25 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AbilitySystem/Abilitys/ZBGameplayAbility.h"
+#include "ZBPerfAbility.generated.h"
+
+/**
+ * @brief 性能回归与自动化测试用的技能
+ * @details 激活需求写在类默认对象上，授予后走与正式技能相同的路径（实例取类默认对象编译的掩码）。
+ *          原生 Tag 在类默认对象构造之后才注册，所以需求不能写在构造函数里，由 SetDefaultTagRequirements 在使用前配置。
+ */
+UCLASS(NotBlueprintable, Transient)
+class ZBETA_API UZBPerfAbility : public UZBGameplayAbility
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief 配置类默认对象的激活需求
+	 * @details 掩码在第一次检查时按类编译一次，之后再改不会生效；重复配置同样的需求是安全的。
+	 */
+	static void SetDefaultTagRequirements(const FGameplayTagContainer& RequiredTags, const FGameplayTagContainer& BlockedTags);
+};
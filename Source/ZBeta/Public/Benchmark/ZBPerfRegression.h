@@ -0,0 +1,107 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AZBEnemyCharacter;
+class FJsonObject;
+class UWorld;
+
+/**
+ * @brief 单项微基准结果
+ */
+struct FZBPerfResult
+{
+	FString Name;
+	// 每次操作的中位耗时（纳秒）
+	double NanosecondsPerOp = 0.0;
+	int32 Iterations = 0;
+	// 基准没能运行（测试角色生成失败等），计为失败且不写入结果
+	bool bFailed = false;
+};
+
+/**
+ * @brief 性能回归套件
+ *
+ * 功能说明：
+ *   - 在当前世界里跑一组微基准：输入分发、Tag 查询、技能激活检查、GE 应用、属性复制序列化、角色生成；
+ *   - 与仓库中的基线 JSON 比较（每项可单独配置容差），超出即判定回归；
+ *   - 结果写到 Saved/Benchmarks/ZBPerfResults.json，便于 CI 归档。
+ *
+ * 用法（无头服务器）：
+ *   自动化测试（每个基准分组一项 ZBeta.Perf.<分组>，回归或失败即测试失败）：
+ *     ZBetaServer /Game/Map/DemonstrationmMap -nullrhi -ExecCmds="Automation RunTests ZBeta.Perf; Quit"
+ *   控制台命令（额外写结果文件、可更新基线）：
+ *     ZB.Perf.Run [UpdateBaseline] [Exit]
+ *     - UpdateBaseline：用本次结果覆盖基线文件（换机器或确认的性能变化后使用）；
+ *     - Exit：跑完退出进程，有回归时退出码为 1。
+ *
+ * 注意事项：
+ *   - 基线与机器强相关，只在同一台 CI 机器上比较；仓库里提交的基线是宽松的预算上限，只拦截数量级的回归，
+ *     CI 机器上第一次运行后请用 UpdateBaseline 换成实测值；
+ *   - 基线里没有的项只记录不判定；有基准失败时不会更新基线。
+ */
+class ZBETA_API FZBPerfRegression
+{
+public:
+	/**
+	 * @brief 运行全部基准并与基线比较
+	 * @param World           用于生成测试角色的世界（需要已 BeginPlay）
+	 * @param bUpdateBaseline 为 true 时用本次结果覆盖基线
+	 * @return 没有回归时返回 true
+	 */
+	static bool Run(UWorld* World, bool bUpdateBaseline);
+
+	// 基准分组名，自动化测试为每个分组注册一项
+	static TArray<FString> GetBenchmarkGroups();
+
+	/**
+	 * @brief 运行单个分组并与基线比较（自动化测试用），不写结果文件
+	 * @return 没有回归且没有失败时返回 true
+	 */
+	static bool RunGroup(UWorld& World, const FString& Group, TArray<FZBPerfResult>& OutResults);
+
+	// 基线文件路径（命令行 -ZBPerfBaseline= 可覆盖）
+	static FString GetBaselinePath();
+
+	// 本次结果输出路径
+	static FString GetResultsPath();
+
+private:
+	using FBenchmarkFunction = void (*)(UWorld& World, TArray<FZBPerfResult>& OutResults);
+
+	struct FBenchmarkGroup
+	{
+		const TCHAR* Name;
+		FBenchmarkFunction Function;
+	};
+
+	static TConstArrayView<FBenchmarkGroup> GetGroupTable();
+
+	// 生成测试角色，失败时记一条失败结果并返回空；调用方负责销毁
+	static AZBEnemyCharacter* SpawnCharacter(UWorld& World, const TCHAR* BenchmarkName, TArray<FZBPerfResult>& OutResults);
+	static void AddFailure(TArray<FZBPerfResult>& OutResults, const TCHAR* BenchmarkName, const TCHAR* Reason);
+
+	/**
+	 * @brief 测量 Body 的单次耗时
+	 * @details 先预热一轮，再跑 Samples 轮、每轮 Iterations 次，取每轮均值的中位数，抗抖动。
+	 */
+	template <typename FuncType>
+	static double MeasureNanosecondsPerOp(int32 Iterations, int32 Samples, FuncType&& Body);
+
+	static void BenchmarkInputDispatch(UWorld& World, TArray<FZBPerfResult>& OutResults);
+	static void BenchmarkTagQueries(UWorld& World, TArray<FZBPerfResult>& OutResults);
+	static void BenchmarkCanActivate(UWorld& World, TArray<FZBPerfResult>& OutResults);
+	static void BenchmarkApplyEffect(UWorld& World, TArray<FZBPerfResult>& OutResults);
+	static void BenchmarkAttributeSerialization(UWorld& World, TArray<FZBPerfResult>& OutResults);
+	static void BenchmarkCharacterSpawn(UWorld& World, TArray<FZBPerfResult>& OutResults);
+
+	static TSharedPtr<FJsonObject> LoadBaseline();
+
+	// 与基线比较，返回是否通过
+	static bool CompareWithBaseline(const TArray<FZBPerfResult>& Results, const TSharedPtr<FJsonObject>& Baseline);
+
+	// 写结果 JSON；写基线时保留原有的容差配置。返回是否写入成功
+	static bool WriteResults(const FString& Path, const TArray<FZBPerfResult>& Results, const TSharedPtr<FJsonObject>& Baseline);
+};
@@ -27,6 +27,7 @@
 
 #include "CoreMinimal.h"
 #include "AbilitySystemInterface.h"
+#include "AssetRegistry/AssetBundleData.h"
 #include "GameplayTagContainer.h"
 #include "GameFramework/Character.h"
 #include "ZBCharacterBase.generated.h"
@@ -38,6 +39,7 @@ class UAbilitySystemComponent;
 class UAttributeSet;
 struct FOnAttributeChangeData;
 class UGameplayAbility;
+class FObjectPreSaveContext;
 
 // 标记为抽象类,防止在编辑器中直接实例化
 UCLASS(Abstract)
@@ -56,9 +58,21 @@ public:
 	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
 	UAttributeSet* GetAttribute() const { return AttributeSet; }
 
+	/**
+	 * @brief 角色蓝图类作为 "CharacterLoadout" 主资源
+	 * @details 只有蓝图类的 CDO 返回有效 ID（名字取蓝图包的短名），Abilities / Attributes 两个 Bundle
+	 *          对应下面的软引用，由 UZBAssetManager::LoadCharacterLoadout 在生成前异步流送。
+	 */
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+#endif
+
 protected:
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	/**
 	 * @brief 初始化 GAS 的 ActorInfo
@@ -90,19 +104,28 @@ protected:
 	TObjectPtr<UAttributeSet> AttributeSet;
 
 	
-	UPROPERTY(EditAnywhere,BlueprintReadOnly,Category = "Attributes", meta=(DisplayName = "默认主要属性"))
-	TSubclassOf<UGameplayEffect> DefaultPrimaryAttributes;
+	// 以下能力 / GE 均为软引用：加载角色蓝图不再连带加载整张能力与 GE 图，
+	// 由 CharacterLoadout 的 Bundle 在生成前流送，没来得及流送时在使用处同步加载兜底
+	UPROPERTY(EditAnywhere,BlueprintReadOnly,Category = "Attributes", meta=(DisplayName = "默认主要属性", AssetBundles = "Attributes"))
+	TSoftClassPtr<UGameplayEffect> DefaultPrimaryAttributes;
 	
-	UPROPERTY(EditAnywhere,BlueprintReadOnly,Category = "Attributes", meta=(DisplayName = "默认衍生属性"))
-	TSubclassOf<UGameplayEffect> DefaultDerivedAttributes;
+	UPROPERTY(EditAnywhere,BlueprintReadOnly,Category = "Attributes", meta=(DisplayName = "默认衍生属性", AssetBundles = "Attributes"))
+	TSoftClassPtr<UGameplayEffect> DefaultDerivedAttributes;
 
-	UPROPERTY(EditAnywhere,BlueprintReadOnly,Category = "Attributes", meta=(DisplayName = "属性效果"))
-	TArray<TSubclassOf<UGameplayEffect>> AttributesEffects;
+	UPROPERTY(EditAnywhere,BlueprintReadOnly,Category = "Attributes", meta=(DisplayName = "属性效果", AssetBundles = "Attributes"))
+	TArray<TSoftClassPtr<UGameplayEffect>> AttributesEffects;
 	
 	
 
 	void AddCharacterAbilities();
 
+	// 可被玩家锁定（BeginPlay 时登记到 UZBTargetLockSubsystem）
+	UPROPERTY(EditDefaultsOnly, Category = "Combat", meta = (DisplayName = "可被锁定"))
+	bool bTargetLockable = false;
+
+	// 把角色上的近战武器绑定到 ASC 的 State.HitWindowActive（服务器与拥有者客户端），在 InitAbilityActorInfo 之后调用
+	void BindMeleeWeapons();
+
 
 
 
@@ -110,10 +133,16 @@ protected:
 private:
 
 	
-	UPROPERTY(EditAnywhere, Category="Abilities", meta =(DisPlayName = "初始主动技能数组"))
-	TArray<TSubclassOf<UGameplayAbility>> StartupAbilities;
+	UPROPERTY(EditAnywhere, Category="Abilities", meta =(DisPlayName = "初始主动技能数组", AssetBundles = "Abilities"))
+	TArray<TSoftClassPtr<UGameplayAbility>> StartupAbilities;
+
+	UPROPERTY(EditAnywhere, Category="Abilities", meta =(DisPlayName = "初始被动技能数组", AssetBundles = "Abilities"))
+	TArray<TSoftClassPtr<UGameplayAbility>> StartupPassiveAbilities;
 
-	UPROPERTY(EditAnywhere, Category="Abilities", meta =(DisPlayName = "初始被动技能数组"))
-	TArray<TSubclassOf<UGameplayAbility>> StartupPassiveAbilities;
+#if WITH_EDITORONLY_DATA
+	// 保存时由上面的 AssetBundles 元数据生成，写入资产注册表供 AssetManager 按 Bundle 加载
+	UPROPERTY(AssetRegistrySearchable)
+	FAssetBundleData AssetBundleData;
+#endif
 	
 };
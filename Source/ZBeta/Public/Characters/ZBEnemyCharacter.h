@@ -4,8 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "ZBCharacterBase.h"
+#include "ZBEnemyCombatProxy.h"
 #include "ZBEnemyCharacter.generated.h"
 
+struct FOnAttributeChangeData;
+
+// 战斗代理变化（服务器本地修改与客户端 OnRep 都会广播）
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FZBOnCombatProxyChanged, const FZBEnemyCombatProxy&, NewProxy, const FZBEnemyCombatProxy&, OldProxy);
+
 UCLASS()
 class ZBETA_API AZBEnemyCharacter : public AZBCharacterBase
 {
@@ -21,15 +27,94 @@ public:
 
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	/**
+	 * @brief 立即唤醒网络休眠并刷新活动时间（仅服务器）
+	 * @details 受到伤害、Tag / 属性变化、玩家靠近时调用。
+	 */
+	void WakeFromNetDormancy();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// 当前战斗代理（模拟端的血条、受击、动画都读这里，而不是 ASC）
+	UFUNCTION(BlueprintPure, Category = "CombatProxy")
+	const FZBEnemyCombatProxy& GetCombatProxy() const { return CombatProxy; }
+
+	// 战斗代理变化事件，驱动血条 / 受击反应 / 动画
+	UPROPERTY(BlueprintAssignable, Category = "CombatProxy")
+	FZBOnCombatProxyChanged OnCombatProxyChanged;
+
 protected:
 
 	virtual void BeginPlay() override;
 
 	virtual void InitAbilityActorInfo() override;
 
+	// ========== 网络休眠 ==========
+	// 不在战斗、不移动、一段时间内无 Tag / 属性变化的敌人进入 DORM_DormantAll，
+	// 休眠期间 Actor 与其 ASC、AttributeSet 都不参与属性比较
+
+	// 是否启用自动网络休眠
+	UPROPERTY(EditDefaultsOnly, Category = "Network|Dormancy", meta = (DisplayName = "启用自动网络休眠"))
+	bool bAutoNetDormancy = true;
+
+	// 最后一次活动后多少秒进入休眠
+	UPROPERTY(EditDefaultsOnly, Category = "Network|Dormancy", meta = (DisplayName = "空闲休眠延迟", ClampMin = "0.0", EditCondition = "bAutoNetDormancy"))
+	float DormancyIdleDelay = 5.f;
+
+	// 玩家进入该半径时保持唤醒
+	UPROPERTY(EditDefaultsOnly, Category = "Network|Dormancy", meta = (DisplayName = "玩家唤醒半径", ClampMin = "0.0", EditCondition = "bAutoNetDormancy"))
+	float DormancyWakeRadius = 3000.f;
+
+	// 休眠检查间隔（秒）
+	UPROPERTY(EditDefaultsOnly, Category = "Network|Dormancy", meta = (DisplayName = "休眠检查间隔", ClampMin = "0.1", EditCondition = "bAutoNetDormancy"))
+	float DormancyCheckInterval = 1.f;
+
+
+	// ========== 战斗代理 ==========
+
+	// 是否仍然把完整 AttributeSet 复制给客户端（调试用，默认只复制 CombatProxy）
+	UPROPERTY(EditDefaultsOnly, Category = "Network|CombatProxy", meta = (DisplayName = "复制完整属性集"))
+	bool bReplicateFullAttributeSet = false;
+
+	UPROPERTY(ReplicatedUsing = OnRep_CombatProxy)
+	FZBEnemyCombatProxy CombatProxy;
+
+	UFUNCTION()
+	void OnRep_CombatProxy(const FZBEnemyCombatProxy& OldProxy);
 
 
 private:
+
+	// 服务器：绑定属性 / 标签 / 技能激活，驱动战斗代理更新
+	void BindCombatProxyDelegates();
+
+	void OnCombatProxyAttributeChanged(const FOnAttributeChangeData& Data);
+	void RefreshCombatProxyRatios();
+	void OnCombatProxyTagChanged(const FGameplayTag Tag, int32 NewCount);
+	void OnCombatProxyAbilityActivated(UGameplayAbility* Ability);
+	void OnCombatProxyAbilityEnded(UGameplayAbility* Ability);
+
+	// 技能在技能提示表中的 ID（下标 + 1），不在表中返回 0
+	static uint8 FindAbilityCueId(const UGameplayAbility* Ability);
+
+	// 服务器：写入新的代理值，发生变化时广播
+	void SetCombatProxy(const FZBEnemyCombatProxy& NewProxy);
+
+	// 绑定 ASC 的 Tag / 属性变化，任何变化都视为一次活动
+	void BindNetDormancyDelegates();
+
+	void OnDormancyTagChanged(const FGameplayTag Tag, int32 NewCount);
+	void OnDormancyAttributeChanged(const FOnAttributeChangeData& Data);
+
+	// 定时器回调：判断进入休眠或保持唤醒
+	void UpdateNetDormancy();
+
+	// 是否有玩家 Pawn 在唤醒半径内
+	bool IsAnyPlayerWithinWakeRadius() const;
+
+	double LastNetActivityTime = 0.0;
+
+	FTimerHandle NetDormancyTimerHandle;
 	
 };
 
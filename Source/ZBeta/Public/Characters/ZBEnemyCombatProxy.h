@@ -0,0 +1,97 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "ZBEnemyCombatProxy.generated.h"
+
+/**
+ * @brief 敌人的紧凑战斗代理（复制给模拟端）
+ *
+ * 功能说明：
+ *   Minimal 模式的敌人 ASC 完整状态只保留在服务器，客户端的血条、受击反应、动画只需要：
+ *   - 生命 / 韧性比例（量化为 0~255）
+ *   - 可见的 State.* 与 HitReact.* 标签（位掩码）
+ *   - 当前技能提示 ID（用于播放对应动画 / 特效）
+ *
+ * 网络格式（NetSerialize）：
+ *   8 bit 生命 + 8 bit 韧性 + N bit 标签掩码（N = 可见标签表长度）+ 打包的技能 ID + 4 bit 序号，
+ *   通常 5 字节左右。
+ *
+ * 注意事项：
+ *   - 可见标签表的顺序即位顺序，服务器和客户端必须一致，只能在末尾追加；
+ *   - 技能提示序号用于同一技能连续释放时仍能触发 OnRep；
+ *   - 敌人 ASC 的标签计数表不复制，客户端在 OnRep 中把 VisibleTagMask 镜像为本地 Loose Tag。
+ */
+USTRUCT(BlueprintType)
+struct ZBETA_API FZBEnemyCombatProxy
+{
+	GENERATED_BODY()
+
+	// 生命比例 Health / MaxHealth，量化到 0~255
+	UPROPERTY(BlueprintReadOnly, Category = "CombatProxy")
+	uint8 HealthRatio = 255;
+
+	// 韧性比例 Toughness / MaxToughness，量化到 0~255
+	UPROPERTY(BlueprintReadOnly, Category = "CombatProxy")
+	uint8 ToughnessRatio = 255;
+
+	// 可见标签位掩码，位顺序见 GetVisibleTagTable()
+	UPROPERTY()
+	uint32 VisibleTagMask = 0;
+
+	// 当前技能提示 ID，0 表示无（技能结束后清零），1.. 对应 GetAbilityCueTable() 下标 + 1
+	UPROPERTY(BlueprintReadOnly, Category = "CombatProxy")
+	uint8 AbilityCueId = 0;
+
+	// 技能提示序号（4 bit 循环），同一技能再次释放时递增
+	UPROPERTY()
+	uint8 AbilityCueSequence = 0;
+
+	float GetHealthRatio() const { return HealthRatio / 255.f; }
+	float GetToughnessRatio() const { return ToughnessRatio / 255.f; }
+
+	// 把 [0,1] 的比例量化为一个字节
+	static uint8 QuantizeRatio(float Ratio);
+
+	// 是否带有某个可见标签（精确匹配表中的标签）
+	bool HasVisibleTag(const FGameplayTag& Tag) const;
+
+	// 展开为标签容器（供动画蓝图 / UI 使用）
+	FGameplayTagContainer GetVisibleTags() const;
+
+	// 当前技能提示对应的技能标签，无则返回空标签
+	FGameplayTag GetAbilityCueTag() const;
+
+	// 可见标签表：位下标 -> 标签
+	static const TArray<FGameplayTag>& GetVisibleTagTable();
+
+	// 技能提示表：ID - 1 -> 技能标签
+	static const TArray<FGameplayTag>& GetAbilityCueTable();
+
+	// 标签在可见标签表中的位下标，不在表中返回 INDEX_NONE
+	static int32 GetVisibleTagBit(const FGameplayTag& Tag);
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FZBEnemyCombatProxy& Other) const
+	{
+		return HealthRatio == Other.HealthRatio
+			&& ToughnessRatio == Other.ToughnessRatio
+			&& VisibleTagMask == Other.VisibleTagMask
+			&& AbilityCueId == Other.AbilityCueId
+			&& AbilityCueSequence == Other.AbilityCueSequence;
+	}
+	bool operator!=(const FZBEnemyCombatProxy& Other) const { return !(*this == Other); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FZBEnemyCombatProxy> : public TStructOpsTypeTraitsBase2<FZBEnemyCombatProxy>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
@@ -0,0 +1,72 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ZBCombatResolutionSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+class UGameplayEffect;
+
+/**
+ * @brief 每帧一次的命中后结算队列
+ *
+ * 功能说明：
+ *   - 攻击者侧的吸取返还（生命 / 法力 / 体力）按攻击者累加，帧末用一个瞬时 GE（三个 SetByCaller 修饰符）一次施加；
+ *   - 横扫十个敌人时，攻击者每帧只收到一次属性修改，而不是十个 GE。
+ *
+ * 详细流程：
+ *   1. 伤害落地时（UZBAttributeSet::HandleIncomingDamage）调用 QueueReturns 入队；
+ *   2. 世界所有 Actor 与可 Tick 对象更新完之后（OnWorldPostActorTick）调用 Flush；
+ *   3. Flush 按攻击者名字排序后依次施加，同一攻击者的返还按入队顺序累加，回放时结果逐位一致。
+ *
+ * 注意事项：
+ *   - 只在服务器创建，客户端直接由属性复制得到结果；
+ *   - Flush 中施加的 GE 如果再次入队（例如返还触发了新的被动），会留到下一帧处理。
+ */
+UCLASS()
+class ZBETA_API UZBCombatResolutionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// 累加一次返还给攻击者的资源
+	void QueueReturns(UAbilitySystemComponent* Attacker, float Health, float Mana, float Stamina);
+
+	// 立即施加并清空队列（正常情况下由帧末回调调用）
+	void Flush();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FPendingReturn
+	{
+		TWeakObjectPtr<UAbilitySystemComponent> Attacker;
+		FString OrderKey;
+		float Health = 0.f;
+		float Mana = 0.f;
+		float Stamina = 0.f;
+	};
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void ApplyReturns(TArray<FPendingReturn>& Returns) const;
+
+	// 回放确定的排序键：ASC 的 Avatar（没有时 Owner）的名字
+	static FString GetOrderKey(const UAbilitySystemComponent* AbilitySystemComponent);
+
+	// 每个攻击者一项，入队时就地累加
+	TArray<FPendingReturn> PendingReturns;
+	TMap<TObjectKey<UAbilitySystemComponent>, int32> ReturnIndexByAttacker;
+
+	// 三个 SetByCaller 修饰符（Attributes.Vital.Health / Mana / Stamina）的瞬时 GE
+	UPROPERTY(Transient)
+	TObjectPtr<UGameplayEffect> ReturnsEffect;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,62 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief 按槽位去重的截止时间队列
+ *
+ * 功能说明：
+ *   - 每个槽位（调用方自己的数据下标）同时最多一个待处理事件，重新调度即替换；
+ *   - 事件放在按时间排序的最小堆里，替换 / 取消不去堆里查找，而是递增槽位的序号，让旧条目作废（惰性删除）；
+ *   - 作废条目在到达堆顶时丢弃，PopDue / GetNextTime 只返回有效事件。
+ *
+ * 注意事项：
+ *   - 槽位复用前应 Cancel，序号不清零，残留的旧条目在复用后依然作废；
+ *   - 非线程安全，只在游戏线程使用。
+ */
+class ZBETA_API FZBDeadlineQueue
+{
+public:
+	// 替换槽位的待处理事件
+	void Schedule(int32 Slot, double Time);
+
+	// 取消槽位的待处理事件（没有时什么都不做）
+	void Cancel(int32 Slot);
+
+	bool IsPending(int32 Slot) const { return Pending.IsValidIndex(Slot) && Pending[Slot]; }
+
+	// 弹出一个 Time <= Now 的有效事件（最早的先出），没有时返回 false
+	bool PopDue(double Now, int32& OutSlot);
+
+	// 最早的有效事件时间，没有时返回 false
+	bool GetNextTime(double& OutTime);
+
+	// 有效的待处理事件数
+	int32 Num() const { return NumPending; }
+
+	void Reset();
+
+private:
+	struct FEntry
+	{
+		double Time = 0.0;
+		int32 Slot = INDEX_NONE;
+		uint32 Serial = 0;
+
+		bool operator<(const FEntry& Other) const { return Time < Other.Time; }
+	};
+
+	bool IsStale(const FEntry& Entry) const { return !Pending[Entry.Slot] || Serials[Entry.Slot] != Entry.Serial; }
+
+	// 丢掉堆顶的作废条目
+	void DiscardStaleTop();
+
+	// 最小堆（含作废条目）
+	TArray<FEntry> Heap;
+	// 每个槽位的当前序号
+	TArray<uint32> Serials;
+	TBitArray<> Pending;
+	int32 NumPending = 0;
+};
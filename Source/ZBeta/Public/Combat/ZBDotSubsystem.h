@@ -0,0 +1,161 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ActiveGameplayEffectHandle.h"
+#include "GameplayTagContainer.h"
+#include "Combat/ZBTimingWheel.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ZBDotSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+class UGameplayEffect;
+struct FGameplayEffectSpec;
+
+/**
+ * @brief 集中调度的持续伤害（DOT）
+ *
+ * 功能说明：
+ *   - 燃烧 / 冰冻 / 流血等 DOT 不再各自作为周期 GE 运行，而是作为一条记录放进分层时间轮（FZBTimingWheel）；
+ *   - 每个目标的每种 DOT 只挂一个状态 GE（无限时长，负责授予 DOT 标签与 GameplayCue），层数与计时都在本系统内；
+ *   - 同一帧到期的所有跳伤作为一批处理，按目标累加，每个目标每帧只施加一次伤害 GE。
+ *
+ * 详细流程：
+ *   1. ApplyDot / ApplyDotFromSpec：找到目标的状态记录，首层时施加状态 GE，新建一条 DOT 并在第一跳的 Tick 上调度；
+ *   2. Tick：把时间轮推进到当前 Tick，取出到期的 DOT，伤害累加到目标，还有剩余跳数的按周期重新调度；
+ *   3. 按目标名字排序后，每个目标用一个瞬时 GE（IncomingDamage，SetByCaller Debuff.Data.Damage）结算本帧总伤害；
+ *   4. 跳数用完的 DOT 释放，某种 DOT 最后一层结束时移除对应的状态 GE。
+ *
+ * 用法：
+ *   伤害 GE 带上具体 DOT 标签（Effect.DOT.*）以及 SetByCaller Debuff.Data.Damage / Frequency / Duration，
+ *   UExecCalc_Damage 按 Effect.Data.Chance 判定后调用 ApplyDotFromSpec；技能也可直接调用 ApplyDot。
+ *
+ * 注意事项：
+ *   - 只在服务器创建，客户端通过状态 GE 的复制得到标签与特效，因此每个具体的 DOT（Effect.DOT.* 的叶子标签）
+ *     应在 StatusEffects 中配置一个资产 GE（运行时生成的 GE 无法复制到客户端）；没有配置的 DOT 改用复制的松散标签，
+ *     客户端能看到标签但没有特效，Initialize 时警告一次；配置了但无效的项报错；
+ *   - Effect.DOT.Fire 这类中间层标签不是具体的 DOT，施加时拒绝；
+ *   - 跳伤直接写入 IncomingDamage，不经过 UExecCalc_Damage：没有抗性减免、暴击与吸取，
+ *     Debuff.Data.Damage 即为最终的每跳伤害；
+ *   - 时间精度为 TickResolution，周期会取整到它的整数倍（至少 1 个 Tick）；
+ *   - 驱散请调用 RemoveDots，直接移除状态 GE 不会停止跳伤。
+ */
+UCLASS(Config = Game)
+class ZBETA_API UZBDotSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * @brief 施加一层 DOT
+	 * @param DotTag 具体 DOT 标签（Effect.DOT.* 的叶子标签，中间层标签会被拒绝）
+	 * @param DamagePerTick 每跳伤害（可以为 0，例如只减速的冰冻）
+	 * @param Frequency 跳伤间隔（秒）
+	 * @param Duration 总持续时间（秒），跳数 = Duration / Frequency（至少 1 跳）
+	 */
+	void ApplyDot(UAbilitySystemComponent* Source, UAbilitySystemComponent* Target, FGameplayTag DotTag, float DamagePerTick, float Frequency, float Duration);
+
+	// 从伤害 GE 的 DOT 标签与 Debuff.Data.* 读取参数后施加，GE 不带 DOT 时返回 false
+	bool ApplyDotFromSpec(const FGameplayEffectSpec& Spec, UAbilitySystemComponent* Target);
+
+	// 移除目标身上某种（标签无效时为全部）DOT，并立即移除对应状态 GE
+	void RemoveDots(UAbilitySystemComponent* Target, FGameplayTag DotTag = FGameplayTag());
+
+	int32 GetNumActiveDots() const { return Dots.Num() - FreeDots.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// ========== 配置（DefaultGame.ini） ==========
+
+	// 时间轮精度（秒）
+	UPROPERTY(Config)
+	float TickResolution = 0.05f;
+
+	// 同一目标同一种 DOT 的最大层数，满层后新施加的刷新剩余跳数最少的一层
+	UPROPERTY(Config)
+	int32 MaxStacksPerStatus = 5;
+
+	// DOT 标签对应的状态 GE（必须为无限时长并授予该标签，可带 GameplayCue），每个具体的 Effect.DOT.* 标签一项
+	UPROPERTY(Config)
+	TMap<FGameplayTag, TSoftClassPtr<UGameplayEffect>> StatusEffects;
+
+private:
+	// 一层 DOT，同时只在时间轮上有一个条目
+	struct FDot
+	{
+		TWeakObjectPtr<UAbilitySystemComponent> Source;
+		int32 TargetIndex = INDEX_NONE;
+		FGameplayTag Tag;
+		float DamagePerTick = 0.f;
+		uint32 PeriodTicks = 1;
+		int32 RemainingTicks = 0;
+		// 已被移除 / 刷新覆盖，等时间轮条目到期时回收
+		bool bCancelled = false;
+	};
+
+	// 目标身上某种 DOT 的全部层与它的状态 GE
+	struct FStatus
+	{
+		FGameplayTag Tag;
+		TArray<int32, TInlineAllocator<4>> DotIds;
+		FActiveGameplayEffectHandle StatusHandle;
+		// 没有状态 GE，改用复制的松散标签
+		bool bLooseTag = false;
+	};
+
+	struct FTarget
+	{
+		TWeakObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
+		TObjectKey<UAbilitySystemComponent> Key;
+		FString OrderKey;
+		TArray<FStatus, TInlineAllocator<2>> Statuses;
+
+		// 本帧累计伤害与归属（取第一跳的来源）
+		float PendingDamage = 0.f;
+		TWeakObjectPtr<UAbilitySystemComponent> PendingInstigator;
+	};
+
+	uint64 GetNowTick() const;
+	int32 FindOrAddTarget(UAbilitySystemComponent* Target);
+	FStatus& FindOrAddStatus(int32 TargetIndex, FGameplayTag DotTag, UAbilitySystemComponent* Source);
+	int32 AllocateDot();
+
+	// 从状态中摘除一层；最后一层时移除状态 GE，目标没有任何 DOT 时回收目标
+	void DetachDot(int32 DotId);
+
+	void ApplyPendingDamage();
+
+	// 加载并校验 StatusEffects：无效的项报错，缺失的警告一次
+	void ResolveStatusEffects();
+	const UGameplayEffect* GetStatusEffect(FGameplayTag DotTag) const;
+
+	FZBTimingWheel Wheel;
+
+	TArray<FDot> Dots;
+	TArray<int32> FreeDots;
+
+	TArray<FTarget> Targets;
+	TArray<int32> FreeTargets;
+	TMap<TObjectKey<UAbilitySystemComponent>, int32> TargetIndexByASC;
+
+	// 复用的帧内缓冲
+	TArray<FZBTimingWheel::FEntry> ExpiredEntries;
+	TArray<int32> DamagedTargets;
+	TArray<int32> FinishedDots;
+
+	// 每跳伤害的瞬时 GE（IncomingDamage，SetByCaller Debuff.Data.Damage）
+	UPROPERTY(Transient)
+	TObjectPtr<UGameplayEffect> DamageEffect;
+
+	// 已加载并通过校验的状态 GE（CDO）
+	UPROPERTY(Transient)
+	TMap<FGameplayTag, TObjectPtr<const UGameplayEffect>> ResolvedStatusEffects;
+};
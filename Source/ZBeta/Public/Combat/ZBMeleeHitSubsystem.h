@@ -0,0 +1,109 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "ZBMeleeHitSubsystem.generated.h"
+
+class AZBPlayerController;
+class UZBMeleeWeaponComponent;
+
+/**
+ * @brief 一次去重后的近战命中
+ */
+struct FZBMeleeHit
+{
+	TWeakObjectPtr<UZBMeleeWeaponComponent> Weapon;
+	TWeakObjectPtr<AActor> Attacker;
+	TWeakObjectPtr<AActor> Victim;
+	uint32 SwingId = 0;
+	FHitResult HitResult;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FZBOnMeleeHitsResolved, const TArray<FZBMeleeHit>& /*Hits*/);
+
+/**
+ * @brief 批量近战命中检测
+ *
+ * 功能说明：
+ *   - 只收录处于 State.HitWindowActive 的武器（由 UZBMeleeWeaponComponent 注册 / 注销），没有挥砍时不做任何事；
+ *   - 每帧把所有武器的扫掠作为一批异步查询发出：上一帧姿态到本帧姿态之间按刀尖位移插子步，
+ *     每个子步一次按对象类型的刀身球形扫掠，一刀划过的所有目标都会收集到；
+ *   - 下一帧收取结果，按挥砍去重后交给一次统一的伤害结算（施加武器的伤害 GE 并广播 OnMeleeHitsResolved）；
+ *   - 远端玩家的命中在其客户端上检测，经 AZBPlayerController::ServerReportMeleeHit 带时间戳上报，
+ *     服务器用 UZBLagCompensationSubsystem 把目标回溯到客户端画面的时刻校验，通过后进入同一次结算；
+ *   - 弹反同理：ValidateClientParry 回溯攻击者，确认它在客户端画面上处于 State.ParryWindowActive。
+ *
+ * 详细流程（Tick）：
+ *   1. CollectSweepResults：读取上一帧发出的扫掠结果，丢弃已换挥砍的，按 SwingId + 目标去重；
+ *   2. ResolveHits：一次性结算本帧全部命中（含已通过回溯校验的上报命中）；客户端上改为上报服务器；
+ *   3. IssueSweeps：为当前所有活动武器发出本帧的扫掠批次。
+ *
+ * 注意事项：
+ *   - 异步查询的结果晚一帧可用，命中判定因此也晚一帧，换来的是查询和游戏线程并行；
+ *   - 客户端上只有本地玩家的武器注册，OnMeleeHitsResolved 广播的是预测命中，只用于表现；
+ *   - 上报的命中只能命中在回溯子系统注册过的角色，且目标在客户端画面时刻处于 State.IFrame 时作废。
+ */
+UCLASS()
+class ZBETA_API UZBMeleeHitSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterWeapon(UZBMeleeWeaponComponent* Weapon);
+	void UnregisterWeapon(UZBMeleeWeaponComponent* Weapon);
+
+	int32 GetNumActiveWeapons() const { return ActiveWeapons.Num(); }
+
+	/**
+	 * @brief 服务器校验客户端上报的命中
+	 * @param ClientTime 客户端上报时的 GetServerWorldTimeSeconds
+	 * @param TraceStart / TraceEnd 命中那一子步的刀身根部与尖端
+	 * @details 武器必须属于该玩家的 Pawn、服务器上的挥砍仍在进行（或刚结束），扫掠起点不能离 Pawn 太远；
+	 *          通过后入队回溯校验，命中且目标当时不在无敌帧才记入本帧命中。
+	 */
+	void ValidateClientHit(AZBPlayerController* PlayerController, UZBMeleeWeaponComponent* Weapon, AActor* Victim,
+		double ClientTime, const FVector& TraceStart, const FVector& TraceEnd);
+
+	/**
+	 * @brief 服务器校验客户端上报的弹反
+	 * @details 把攻击者回溯到客户端画面的时刻，带 State.ParryWindowActive 才成立：攻击者本次挥砍不再命中该玩家，
+	 *          并向玩家发送 Ability.Parry 事件（弹反 GA 用 WaitGameplayEvent 接收后播放反击）。
+	 * @return 弹反是否成立
+	 */
+	bool ValidateClientParry(AZBPlayerController* PlayerController, AActor* Attacker, double ClientTime);
+
+	// 每帧至多广播一次，参数为本帧全部命中（已去重）
+	FZBOnMeleeHitsResolved OnMeleeHitsResolved;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// 一次已发出、等待下一帧收取的扫掠
+	struct FPendingSweep
+	{
+		TWeakObjectPtr<UZBMeleeWeaponComponent> Weapon;
+		uint32 SwingId = 0;
+		FTraceHandle Handle;
+	};
+
+	void CollectSweepResults(UWorld& World);
+	void ResolveHits();
+	void IssueSweeps(UWorld& World);
+	void IssueWeaponSweeps(UWorld& World, UZBMeleeWeaponComponent& Weapon);
+	void ApplyHitDamage(const FZBMeleeHit& Hit) const;
+
+	TArray<TWeakObjectPtr<UZBMeleeWeaponComponent>> ActiveWeapons;
+	TArray<FPendingSweep> PendingSweeps;
+
+	// 本帧去重后的命中，结算后清空（保留容量）
+	TArray<FZBMeleeHit> FrameHits;
+};
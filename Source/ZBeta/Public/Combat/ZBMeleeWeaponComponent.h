@@ -0,0 +1,147 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "GameplayTagContainer.h"
+#include "Components/ActorComponent.h"
+#include "Engine/EngineTypes.h"
+#include "ZBMeleeWeaponComponent.generated.h"
+
+class UAbilitySystemComponent;
+class UGameplayEffect;
+class UMeshComponent;
+
+/**
+ * @brief 一帧的刀身姿态
+ * @details 两个插槽位置取网格体组件空间，外加网格体的世界变换；子步插值在组件空间做，
+ *          角色移动与挥砍弧线分开插值，弧线不会被拉成直线。
+ */
+struct FZBBladePose
+{
+	FVector BaseLocal = FVector::ZeroVector;
+	FVector TipLocal = FVector::ZeroVector;
+	FTransform MeshToWorld = FTransform::Identity;
+
+	// 按 Alpha 在 A、B 之间插值：刀身方向球面插值、长度与根部线性插值
+	static FZBBladePose Interpolate(const FZBBladePose& A, const FZBBladePose& B, float Alpha);
+
+	FVector GetBaseWorld() const { return MeshToWorld.TransformPosition(BaseLocal); }
+	FVector GetTipWorld() const { return MeshToWorld.TransformPosition(TipLocal); }
+};
+
+/**
+ * @brief 近战武器的命中检测参数与每次挥砍的状态
+ *
+ * 功能说明：
+ *   - 挂在角色上，描述刀身（网格体上 BaseSocket -> TipSocket 两个插槽之间，半径 Radius 的胶囊）；
+ *   - 监听拥有者 ASC 的 State.HitWindowActive：标签出现即开始一次挥砍并向
+ *     UZBMeleeHitSubsystem 注册，标签移除即注销；
+ *   - 本组件不 Tick、不自己发射线，所有武器的扫掠由子系统每帧统一批量发出；
+ *   - 同一次挥砍中每个目标只命中一次（SwingId + HitActors 去重）。
+ *
+ * 注意事项：
+ *   - ASC 在角色 InitAbilityActorInfo 之后才可用，由 AZBCharacterBase::BindMeleeWeapons 调用 BindAbilitySystem；
+ *   - 在服务器与拥有者客户端（自主代理）上绑定，模拟代理不检测；
+ *   - 远端玩家的武器（IsClientPredicted）在服务器上只记录挥砍状态不扫掠：命中由其客户端检测后上报，
+ *     服务器经 UZBMeleeHitSubsystem::ValidateClientHit 回溯校验。
+ */
+UCLASS(ClassGroup = (ZBeta), meta = (BlueprintSpawnableComponent))
+class ZBETA_API UZBMeleeWeaponComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UZBMeleeWeaponComponent();
+
+	// 绑定拥有者的 ASC，幂等；ASC 变化时会先解绑旧的
+	void BindAbilitySystem(UAbilitySystemComponent* InAbilitySystemComponent);
+
+	// 采样当前帧的刀身姿态，找不到网格体时返回 false
+	bool SampleBladePose(FZBBladePose& OutPose) const;
+
+	// 本次挥砍中第一次命中该目标时返回 true 并记录
+	bool TryRecordHit(AActor* HitActor);
+
+	// 服务器上由远端玩家控制的武器：命中由客户端检测上报，服务器不扫掠
+	bool IsClientPredicted() const;
+
+	// 挥砍进行中，或结束不超过 GraceSeconds（客户端上报比服务器挥砍结束晚到）
+	bool IsSwingActiveOrRecent(double Now, double GraceSeconds) const { return bSwingActive || Now - SwingEndTime <= GraceSeconds; }
+
+	uint32 GetSwingId() const { return SwingId; }
+	UAbilitySystemComponent* GetAbilitySystemComponent() const { return BoundAbilitySystemComponent.Get(); }
+	TSubclassOf<UGameplayEffect> GetDamageEffectClass() const { return DamageEffectClass; }
+
+	float GetRadius() const { return Radius; }
+	float GetMaxSubStepDistance() const { return MaxSubStepDistance; }
+	int32 GetMaxSubSteps() const { return MaxSubSteps; }
+	const FCollisionObjectQueryParams& GetTargetObjectQueryParams() const { return TargetObjectQueryParams; }
+	float GetMaxReportedTraceOffset() const { return MaxReportedTraceOffset; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// 带插槽的网格体组件标签，为空时使用角色网格体
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (DisplayName = "武器网格体组件标签"))
+	FName MeshComponentTag;
+
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (DisplayName = "刀身根部插槽"))
+	FName BaseSocket = TEXT("WeaponBase");
+
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (DisplayName = "刀身尖端插槽"))
+	FName TipSocket = TEXT("WeaponTip");
+
+	// 刀身半径（cm）
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (DisplayName = "刀身半径", ClampMin = "0"))
+	float Radius = 8.f;
+
+	// 刀尖每移动这么远（cm）插一个子步，快速挥砍时避免穿过目标
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (DisplayName = "子步间距", ClampMin = "1"))
+	float MaxSubStepDistance = 25.f;
+
+	// 每帧最多的子步数
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (DisplayName = "最大子步数", ClampMin = "1", ClampMax = "16"))
+	int32 MaxSubSteps = 6;
+
+	// 按对象类型查询：扫掠路径上所有这些类型的目标都会收集到，不会被第一个阻挡挡住
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (DisplayName = "检测对象类型"))
+	TArray<TEnumAsByte<EObjectTypeQuery>> TargetObjectTypes;
+
+	// 服务器校验客户端上报的命中时，扫掠起点离拥有者的最大距离（cm），超出视为伪造
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (DisplayName = "上报扫掠最大偏移", ClampMin = "0"))
+	float MaxReportedTraceOffset = 300.f;
+
+	// 命中时由拥有者施加给目标的伤害 GE
+	UPROPERTY(EditAnywhere, Category = "Melee", meta = (DisplayName = "伤害效果"))
+	TSubclassOf<UGameplayEffect> DamageEffectClass;
+
+private:
+	friend class UZBMeleeHitSubsystem;
+
+	void OnHitWindowTagChanged(const FGameplayTag Tag, int32 NewCount);
+	void BeginSwing();
+	void EndSwing();
+	void UnbindAbilitySystem();
+
+	UPROPERTY(Transient)
+	TObjectPtr<UMeshComponent> SocketMesh;
+
+	// 由 TargetObjectTypes 在 BeginPlay 构建
+	FCollisionObjectQueryParams TargetObjectQueryParams;
+
+	TWeakObjectPtr<UAbilitySystemComponent> BoundAbilitySystemComponent;
+	FDelegateHandle HitWindowDelegateHandle;
+
+	// 每次挥砍递增，子系统用它丢弃上一次挥砍遗留的扫掠结果
+	uint32 SwingId = 0;
+	bool bSwingActive = false;
+	double SwingEndTime = -UE_BIG_NUMBER;
+	TSet<TWeakObjectPtr<AActor>> HitActors;
+
+	// 上一帧发出扫掠时的姿态，子系统据此在两帧之间插子步
+	bool bHasLastPose = false;
+	FZBBladePose LastPose;
+};
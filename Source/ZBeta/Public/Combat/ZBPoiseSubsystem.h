@@ -0,0 +1,149 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Combat/ZBDeadlineQueue.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ZBPoiseSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+class UGameplayEffect;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FZBOnPoiseBroken, UAbilitySystemComponent* /*Target*/, bool /*bGuardBroken*/);
+
+/**
+ * @brief 韧性（架势）与破韧
+ *
+ * 功能说明：
+ *   - 削韧（FZBGameplayEffectContext::ToughnessDamage）由 UZBAttributeSet 在处理 IncomingDamage 时交给本系统；
+ *   - 韧性归零即破韧：格挡中为破防（State.GuardBroken），否则为硬直（State.Staggered），结束后韧性回满；
+ *   - 最后一次削韧 RegenDelay 秒后开始按 ToughnessRegenRate 分步恢复；
+ *   - 受击反应（HitReact.*）按（韧性状态，受击强度）查表，作为 GameplayEvent 发给目标 ASC。
+ *
+ * 详细流程：
+ *   1. ApplyToughnessDamage：扣韧性 -> 查表选受击反应 -> 破韧时施加状态 GE 并调度恢复，否则调度回韧；
+ *   2. 每个角色同时最多一个待处理事件（硬直结束 / 下一步回韧），所有角色的事件放在一个 FZBDeadlineQueue 里；
+ *   3. 世界定时器只设在最早的事件上，到期时处理全部到期事件后再设下一个，没有待处理事件时什么都不做。
+ *
+ * 注意事项：
+ *   - 只在服务器创建；状态标签由配置的资产 GE（StaggerEffectClass / GuardBrokenEffectClass）授予，
+ *     客户端通过 GE 复制得到；未配置时改用复制的松散标签（没有特效），Initialize 警告一次，配置了但无效时报错；
+ *   - 是否处于破韧以本系统待处理的 Recover 事件为准，不依赖状态标签，破韧期间的后续命中不会再次破韧；
+ *   - 霸体（State.HyperArmor）期间照常扣韧性但不会破韧，霸体结束后的下一次削韧才会破韧；
+ *   - 已处于硬直 / 破防时不再扣韧性。
+ */
+UCLASS(Config = Game)
+class ZBETA_API UZBPoiseSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * @brief 对目标施加一次削韧
+	 * @param Target 受击者的 ASC（需带 UZBAttributeSet）
+	 * @param ToughnessDamage 削韧值，必须大于 0
+	 * @param Instigator 攻击者（填入受击事件，可为空）
+	 */
+	void ApplyToughnessDamage(UAbilitySystemComponent& Target, float ToughnessDamage, AActor* Instigator);
+
+	// 待处理事件数（调试 / 基准用）
+	int32 GetNumPendingEvents() const { return EventQueue.Num(); }
+
+	// 破韧时广播（bGuardBroken 为 true 表示格挡中被破防）
+	FZBOnPoiseBroken OnPoiseBroken;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// ========== 配置（DefaultGame.ini） ==========
+
+	// 破韧硬直时长（秒）
+	UPROPERTY(Config)
+	float StaggerDuration = 1.5f;
+
+	// 格挡中被破防的时长（秒）
+	UPROPERTY(Config)
+	float GuardBrokenDuration = 2.5f;
+
+	// 硬直状态 GE：HasDuration，时长取 SetByCaller Debuff.Data.Duration，授予 State.Staggered
+	UPROPERTY(Config)
+	TSoftClassPtr<UGameplayEffect> StaggerEffectClass;
+
+	// 破防状态 GE：HasDuration，时长取 SetByCaller Debuff.Data.Duration，授予 State.GuardBroken
+	UPROPERTY(Config)
+	TSoftClassPtr<UGameplayEffect> GuardBrokenEffectClass;
+
+	// 最后一次削韧后多久开始回韧（秒）
+	UPROPERTY(Config)
+	float RegenDelay = 3.f;
+
+	// 回韧的步长（秒），每步恢复 ToughnessRegenRate * 步长
+	UPROPERTY(Config)
+	float RegenStepInterval = 0.25f;
+
+	// 受击强度分档：削韧 / 最大韧性达到该比例为中 / 重
+	UPROPERTY(Config)
+	float MediumHitRatio = 0.15f;
+
+	UPROPERTY(Config)
+	float HeavyHitRatio = 0.35f;
+
+private:
+	enum class EPoiseEvent : uint8
+	{
+		None,
+		// 硬直 / 破防结束，韧性回满
+		Recover,
+		// 回韧一步
+		Regen,
+	};
+
+	struct FPoiseState
+	{
+		TWeakObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
+		TObjectKey<UAbilitySystemComponent> Key;
+		// 队列里待处理事件的类型
+		EPoiseEvent PendingEvent = EPoiseEvent::None;
+		// 没有状态 GE 时授予的松散标签，释放状态时移除
+		FGameplayTag LooseStatusTag;
+	};
+
+	int32 FindOrAddState(UAbilitySystemComponent& Target);
+	void ReleaseState(int32 StateIndex);
+
+	// 替换该角色的待处理事件
+	void Schedule(int32 StateIndex, EPoiseEvent Event, double Time);
+	void ArmTimer();
+	void OnTimer();
+
+	void ProcessEvent(int32 StateIndex);
+	void ApplyStatusEffect(int32 StateIndex, const UGameplayEffect* Effect, const FGameplayTag& StatusTag, float Duration);
+	FGameplayTag SelectHitReact(bool bHyperArmor, bool bBroken, float ToughnessRatio) const;
+
+	double GetTimeSeconds() const;
+
+	TArray<FPoiseState> States;
+	TArray<int32> FreeStates;
+	TMap<TObjectKey<UAbilitySystemComponent>, int32> StateIndexByASC;
+
+	// 槽位即 States 的下标
+	FZBDeadlineQueue EventQueue;
+
+	FTimerHandle TimerHandle;
+	double TimerTime = 0.0;
+
+	// 加载并校验一个状态 GE（CDO），未配置时返回空，无效时报错并返回空
+	const UGameplayEffect* LoadStatusEffect(const TSoftClassPtr<UGameplayEffect>& EffectClass, const FGameplayTag& GrantedTag) const;
+
+	UPROPERTY(Transient)
+	TObjectPtr<const UGameplayEffect> StaggerEffect;
+
+	UPROPERTY(Transient)
+	TObjectPtr<const UGameplayEffect> GuardBrokenEffect;
+};
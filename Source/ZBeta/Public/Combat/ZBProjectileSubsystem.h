@@ -0,0 +1,205 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "GameplayEffectTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "ZBProjectileSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+class UFXSystemAsset;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * @brief 一次发射的参数（法杖普攻、符文技能）
+ */
+USTRUCT(BlueprintType)
+struct FZBProjectileParams
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "发射位置"))
+	FVector Origin = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "发射方向"))
+	FVector Direction = FVector::ForwardVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "速度", ClampMin = "0"))
+	float Speed = 2000.f;
+
+	// 0 为直线飞行
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "重力缩放"))
+	float GravityScale = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "碰撞半径", ClampMin = "0"))
+	float Radius = 10.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "存活时间", ClampMin = "0.01"))
+	float Lifetime = 3.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "检测通道"))
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Pawn;
+
+	// 一次发射的数量，按 SpreadAngle 在水平面上扇形展开
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "数量", ClampMin = "1"))
+	int32 Count = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "扇形角度", ClampMin = "0", ClampMax = "360"))
+	float SpreadAngle = 0.f;
+
+	// 飞行表现：同一网格的所有投射物共用一个实例化网格组件
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "网格"))
+	TObjectPtr<UStaticMesh> Mesh;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "网格缩放"))
+	FVector MeshScale = FVector::OneVector;
+
+	// 命中特效（Niagara，走组件池），专用服务器忽略
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "命中特效"))
+	TObjectPtr<UFXSystemAsset> ImpactEffect;
+};
+
+/**
+ * @brief 池化的投射物模拟
+ *
+ * 功能说明：
+ *   - 投射物不是 Actor，而是按结构数组（位置、速度、剩余时间、发射批次下标）存放的一行数据，没有生成 / 销毁开销；
+ *   - 同一次发射的投射物共用一份批次数据：伤害 GE Spec、碰撞参数、表现资源，只在发射时构建一次；
+ *   - 每帧一次批量移动，每个投射物一段异步球形扫掠（上一帧位置 -> 本帧位置），下一帧收取结果；
+ *   - 本帧命中一次性结算：复制批次的 Spec 并写入命中结果与 HitIndex，由发射者 ASC 施加；
+ *   - 飞行表现按网格分组，每种网格一个实例化网格组件，每帧批量更新实例变换；命中特效走 Niagara 组件池。
+ *
+ * 详细流程（Tick）：
+ *   1. CollectSweepResults：收取上一帧发出的扫掠，命中的标记结束并记下命中点；
+ *   2. ResolveHits：有权威的一端统一施加本帧全部命中的伤害；
+ *   3. RemoveFinished：顺序压缩删除已结束或超时的投射物（存活的保持原有顺序），释放不再使用的批次；
+ *   4. IntegrateAndSweep：批量移动，并为每个投射物发出本帧的扫掠；
+ *   5. UpdateVisuals：把位置写进实例化网格（专用服务器跳过）。
+ *
+ * 用法：
+ *   法杖 / 符文技能在服务器上用 MakeOutgoingGameplayEffectSpec 构建伤害 Spec 后调用 FireProjectiles；
+ *   本地预测的客户端可以调用同一接口只做表现，不结算伤害。
+ *
+ * 网络：
+ *   - 投射物不复制。联网时权威端每次发射按距离挑出附近的玩家，经 AZBPlayerController::ClientFireProjectiles（不可靠）
+ *     通知它们，客户端用同样的参数重放一遍纯表现的发射；远处的连接收不到，开销只随附近的玩家数增长；
+ *   - 发射者自己的连接不发（已经本地预测过），丢包只会少一次表现，不影响伤害。
+ *
+ * 注意事项：
+ *   - 扫掠结果晚一帧可用，与近战命中检测一致；
+ *   - 总数超过 MaxProjectiles 的发射会被截断；
+ *   - 表现模块（Niagara）只在非服务器目标链接，相关代码以 UE_SERVER 隔离。
+ */
+UCLASS(Config = Game)
+class ZBETA_API UZBProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * @brief 发射一批投射物
+	 * @param DamageSpec 命中时施加的伤害 Spec，发射者为其 Context 的 Instigator ASC；无效或非权威端只做表现
+	 * @param Instigator 发射者，扫掠时忽略
+	 * @return 实际发射的数量
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Projectile")
+	int32 FireProjectiles(const FZBProjectileParams& Params, FGameplayEffectSpecHandle DamageSpec, AActor* Instigator);
+
+	int32 GetNumProjectiles() const { return Positions.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// ========== 配置（DefaultGame.ini） ==========
+
+	// 同时存在的投射物上限
+	UPROPERTY(Config)
+	int32 MaxProjectiles = 4096;
+
+	// 远端玩家在该距离（再加上投射物的最大飞行距离）以内才收到发射的表现（cm）
+	UPROPERTY(Config)
+	float VisualCullDistance = 8000.f;
+
+private:
+	// 一次发射共用的数据
+	struct FVolley
+	{
+		FGameplayEffectSpecHandle DamageSpec;
+		TWeakObjectPtr<UAbilitySystemComponent> Source;
+		FCollisionQueryParams QueryParams;
+		FCollisionShape Shape;
+		ECollisionChannel TraceChannel = ECC_Pawn;
+		// VisualComponents 的下标，没有网格时为 INDEX_NONE
+		int32 VisualIndex = INDEX_NONE;
+		FVector MeshScale = FVector::OneVector;
+		TWeakObjectPtr<UFXSystemAsset> ImpactEffect;
+		// 仍在飞行的投射物数，归零后释放
+		int32 NumAlive = 0;
+	};
+
+	struct FProjectileHit
+	{
+		int32 VolleyIndex = INDEX_NONE;
+		uint32 ProjectileId = 0;
+		FHitResult HitResult;
+	};
+
+	void CollectSweepResults(UWorld& World);
+	void ResolveHits();
+	void RemoveFinished();
+	void IntegrateAndSweep(UWorld& World, float DeltaTime);
+	void UpdateVisuals();
+
+	// 按距离把发射转发给远端玩家做表现（仅权威端）
+	void ReplicateVolley(UWorld& World, const FZBProjectileParams& Params, AActor* Instigator) const;
+
+	int32 AllocateVolley();
+	uint32 AllocateProjectileId();
+	int32 FindOrAddVisual(UStaticMesh* Mesh);
+	void SpawnImpactEffect(const FVolley& Volley, const FHitResult& Hit) const;
+
+	// ========== 投射物（结构数组，同一下标为同一投射物） ==========
+
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> GravityZ;
+	TArray<float> RemainingLifetimes;
+	TArray<int32> VolleyIndices;
+	// 递增编号，作为命中的 HitIndex（每个投射物一条随机流）
+	TArray<uint32> ProjectileIds;
+	// 已命中，等待 RemoveFinished 删除
+	TBitArray<> Finished;
+
+	// 上一帧发出的扫掠，下标与投射物一一对应（之后发射的投射物没有）
+	TArray<FTraceHandle> PendingSweeps;
+
+	TArray<FVolley> Volleys;
+	TArray<int32> FreeVolleys;
+
+	// 本帧命中，结算后清空（保留容量）
+	TArray<FProjectileHit> FrameHits;
+
+	// 回绕时跳过 0（HitIndex 的默认值）；编号只需要在存活的投射物之间不重复，
+	// 回绕后与很久以前的投射物撞号只会复用同一条随机流，不影响结算
+	uint32 NextProjectileId = 1;
+
+	// ========== 表现 ==========
+
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> VisualActor;
+
+	// 每种网格一个实例化网格组件
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UInstancedStaticMeshComponent>> VisualComponents;
+
+	// 每帧按组件分组的实例变换（保留容量）
+	TArray<TArray<FTransform>> VisualTransforms;
+};
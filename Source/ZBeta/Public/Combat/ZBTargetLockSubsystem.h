@@ -0,0 +1,89 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ZBTargetLockSubsystem.generated.h"
+
+class AZBCharacterBase;
+
+/**
+ * @brief 可锁定角色的均匀网格索引
+ *
+ * 功能说明：
+ *   - 可锁定的角色（AZBCharacterBase::bTargetLockable）在 BeginPlay / EndPlay 注册与注销；
+ *   - 按水平位置放进边长 CellSize 的网格，只有移动超过 MoveThreshold 才重新分桶，位置检查以 UpdateInterval 的低频进行；
+ *   - QueryCandidates 只访问半径覆盖到的网格，代替 GetAllActorsOfClass / 每帧球形重叠。
+ *
+ * 注意事项：
+ *   - 索引位置最多落后 MoveThreshold 加上一个检查周期的移动（MaxSpeed * UpdateInterval），查询半径按这个上限放宽，
+ *     调用方再按真实位置精确过滤；
+ *   - 锁定只在有画面的一端使用，专用服务器不创建。
+ */
+UCLASS(Config = Game)
+class ZBETA_API UZBTargetLockSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterLockable(AZBCharacterBase* Character);
+	void UnregisterLockable(AZBCharacterBase* Character);
+
+	// 收集索引位置在 Origin 水平半径 Radius（+ GetIndexSlack()）内的角色
+	void QueryCandidates(const FVector& Origin, float Radius, TArray<AZBCharacterBase*>& OutCandidates) const;
+
+	int32 GetNumLockables() const { return Entries.Num() - FreeEntries.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// ========== 配置（DefaultGame.ini） ==========
+
+	// 网格边长（cm）
+	UPROPERTY(Config)
+	float CellSize = 1000.f;
+
+	// 移动超过该距离才更新索引位置（cm）
+	UPROPERTY(Config)
+	float MoveThreshold = 100.f;
+
+	// 位置检查间隔（秒）
+	UPROPERTY(Config)
+	float UpdateInterval = 0.1f;
+
+	// 可锁定角色的最大水平速度（cm/s），用于估算两次检查之间的移动
+	UPROPERTY(Config)
+	float MaxSpeed = 1200.f;
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AZBCharacterBase> Character;
+		TObjectKey<AZBCharacterBase> Key;
+		FVector IndexedLocation = FVector::ZeroVector;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	// 索引位置与真实位置的最大水平偏差
+	float GetIndexSlack() const { return MoveThreshold + MaxSpeed * UpdateInterval; }
+	void AddToCell(int32 EntryIndex);
+	void RemoveFromCell(int32 EntryIndex);
+	void RemoveEntry(int32 EntryIndex);
+
+	TArray<FEntry> Entries;
+	TArray<int32> FreeEntries;
+	TMap<TObjectKey<AZBCharacterBase>, int32> EntryIndexByCharacter;
+
+	// 网格 -> 条目下标
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	float TimeSinceUpdate = 0.f;
+};
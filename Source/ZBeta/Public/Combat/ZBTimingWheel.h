@@ -0,0 +1,48 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief 分层时间轮
+ *
+ * 功能说明：
+ *   - 以整数 Tick 计时，3 层 × 64 槽：第 0 层覆盖 64 个 Tick，第 1 层 64²，第 2 层 64³，更远的统一放在第 2 层最远槽；
+ *   - 调度 / 取消 O(1)，推进时只访问到期槽位，高层槽位在低层转完一圈时整体下放（cascade）；
+ *   - 条目只是 (Id, 到期 Tick)，调用方用 Id 索引自己的数据，取消采用"作废 Id"的惰性方式（到期时由调用方过滤）。
+ *
+ * 注意事项：
+ *   - 同一 Tick 到期的条目在 Advance 中一次性返回，调用方按批处理；
+ *   - 非线程安全，只在游戏线程使用。
+ */
+class ZBETA_API FZBTimingWheel
+{
+public:
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 NumSlots = 1 << SlotBits;
+	static constexpr int32 NumLevels = 3;
+
+	struct FEntry
+	{
+		int32 Id = INDEX_NONE;
+		uint64 DueTick = 0;
+	};
+
+	// 在 DueTick 到期（早于等于当前 Tick 的按下一 Tick 处理）
+	void Schedule(int32 Id, uint64 DueTick);
+
+	// 推进到 ToTick，把期间到期的条目按到期顺序追加到 OutExpired
+	void Advance(uint64 ToTick, TArray<FEntry>& OutExpired);
+
+	uint64 GetCurrentTick() const { return CurrentTick; }
+	int32 Num() const { return NumEntries; }
+
+private:
+	void Insert(const FEntry& Entry);
+	void Cascade(int32 Level);
+
+	TArray<FEntry> Slots[NumLevels][NumSlots];
+	uint64 CurrentTick = 0;
+	int32 NumEntries = 0;
+};
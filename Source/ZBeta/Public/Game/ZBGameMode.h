@@ -6,6 +6,9 @@
 #include "GameFramework/GameModeBase.h"
 #include "ZBGameMode.generated.h"
 
+class AZBCharacterBase;
+struct FStreamableHandle;
+
 /**
  * 
  */
@@ -13,4 +16,22 @@ UCLASS()
 class ZBETA_API AZBGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
+
+public:
+	AZBGameMode();
+
+	// 解析 ?Seed=（未指定时随机生成对局种子）并预流送 Loadout
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void InitGameState() override;
+
+protected:
+	// 本关卡会生成的角色类（敌人等），InitGame 时和 DefaultPawnClass 一起预先流送能力与 GE
+	UPROPERTY(EditDefaultsOnly, Category = "Loading", meta = (DisplayName = "预流送角色类"))
+	TArray<TSoftClassPtr<AZBCharacterBase>> PrestreamCharacterClasses;
+
+private:
+	TArray<TSharedPtr<FStreamableHandle>> PrestreamHandles;
+
+	// 写入 AZBGameState 的对局随机种子
+	uint32 MatchSeed = 0;
 };
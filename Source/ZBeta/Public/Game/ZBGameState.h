@@ -0,0 +1,34 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "ZBGameState.generated.h"
+
+/**
+ * @brief ZBeta 的 GameState
+ *
+ * 功能说明：
+ *   - 复制对局随机种子 MatchSeed，FZBRandom 以它为根派生所有战斗随机数，客户端拿到后即可预测暴击 / 触发结果。
+ *
+ * 注意事项：
+ *   - 种子由 AZBGameMode 在 InitGameState 中写入，之后不再改变（只需复制一次）。
+ */
+UCLASS()
+class ZBETA_API AZBGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	uint32 GetMatchSeed() const { return static_cast<uint32>(MatchSeed); }
+
+	// 仅服务器调用
+	void SetMatchSeed(uint32 InMatchSeed);
+
+protected:
+	UPROPERTY(Replicated, VisibleInstanceOnly, BlueprintReadOnly, Category = "Match", meta = (DisplayName = "对局随机种子"))
+	int32 MatchSeed = 0;
+};
@@ -0,0 +1,85 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * @brief 录制的输入类型（与 AZBPlayerController 的输入回调一一对应）
+ */
+enum class EZBRecordedInputType : uint8
+{
+	Move,
+	Look,
+	AbilityPressed,
+	AbilityReleased,
+	AbilityHeld,
+	Interaction,
+	TargetLock,
+	Menu,
+};
+
+/**
+ * @brief 一条录制的输入
+ */
+struct FZBRecordedInput
+{
+	// 相对录制开始的帧序号
+	uint32 Frame = 0;
+	EZBRecordedInputType Type = EZBRecordedInputType::Move;
+	// Move / Look 的轴值
+	FVector2f Axis = FVector2f::ZeroVector;
+	// 能力输入在标签表中的下标
+	uint16 TagIndex = 0;
+};
+
+/**
+ * @brief 输入录像（紧凑二进制格式）
+ *
+ * 文件布局：
+ *   Magic | Version | RandomSeed | NumFrames | DurationSeconds
+ *   标签表（FString 数组，能力输入只存下标）
+ *   记录数 + 每条记录：帧增量(变长整数) | 类型(uint8) | 轴值(2 x float) 或 标签下标(变长整数)
+ *
+ * 注意事项：
+ *   - 回放按帧序号对齐，要得到可比较的帧时间，录制与回放都应使用固定步长（-UseFixedTimeStep -FPS=60）；
+ *   - RandomSeed 在录制开始时写入 FMath::RandInit / SRandInit，回放时用同一个种子。
+ */
+class ZBETA_API FZBInputRecording
+{
+public:
+	static constexpr uint32 FileMagic = 0x5249425A; // "ZBIR"
+	static constexpr uint32 FileVersion = 1;
+	// 一条记录序列化后的最小字节数：帧增量(变长整数，至少 1) + 类型(1)
+	static constexpr int64 MinRecordBytes = 2;
+	// 标签表上限：记录里的标签下标是 uint16
+	static constexpr int32 MaxTags = MAX_uint16 + 1;
+	// 一个标签名序列化后的最小字节数：int32 长度字段
+	static constexpr int64 MinTagNameBytes = 4;
+
+	void Reset(int32 InRandomSeed);
+
+	void Add(uint32 Frame, EZBRecordedInputType Type, const FVector2D& Axis, const FGameplayTag& InputTag);
+
+	FGameplayTag GetTag(uint16 TagIndex) const;
+
+	bool SaveToFile(const FString& Path);
+	bool LoadFromFile(const FString& Path);
+
+	const TArray<FZBRecordedInput>& GetRecords() const { return Records; }
+	int32 GetRandomSeed() const { return RandomSeed; }
+
+	uint32 NumFrames = 0;
+	float DurationSeconds = 0.f;
+
+private:
+	uint16 FindOrAddTag(const FGameplayTag& InputTag);
+
+	void Serialize(FArchive& Ar);
+
+	int32 RandomSeed = 0;
+	TArray<FString> TagNames;
+	TArray<FGameplayTag> Tags;
+	TArray<FZBRecordedInput> Records;
+};
@@ -0,0 +1,116 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SphereComponent.h"
+#include "ZBInteractableComponent.generated.h"
+
+class UZBInteractionComponent;
+
+/**
+ * @brief 交互提示数据，由 UI（CommonUI 的操作提示栏等）直接显示
+ */
+USTRUCT(BlueprintType)
+struct FZBInteractionPrompt
+{
+	GENERATED_BODY()
+
+	// 操作文本，如“打开”“对话”
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (DisplayName = "操作文本"))
+	FText ActionText;
+
+	// 对象名称，如“宝箱”
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (DisplayName = "对象名称"))
+	FText ObjectName;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FZBOnInteract, APawn*, InstigatorPawn);
+
+/**
+ * @brief 可交互对象（NPC、宝箱、传送点等）
+ *
+ * 功能说明：
+ *   - 本身就是交互范围的触发球，只与 Pawn 重叠；
+ *   - 本地玩家的 Pawn 进入 / 离开时，把自己登记到 / 移出该玩家的 UZBInteractionComponent，
+ *     候选集合由重叠事件维护，不需要每帧检测；
+ *   - 离开时按登记时的 Pawn 匹配，不再检查是否本地控制（Pawn 可能已经与控制器分离）；
+ *     Pawn 在范围内才被控制（出生 / 重生）时，由交互组件在换 Pawn 时按已有重叠补登记；
+ *   - 提示内容或可用状态变化时通知正在重叠的交互组件重新评估。
+ *
+ * 用法：
+ *   - 挂在 Actor 上，调整球半径作为交互距离，填写 Prompt，在蓝图中绑定 OnInteract。
+ *
+ * 注意事项：
+ *   - OnInteract 只在服务器（含 Listen Server / 单机）上广播，由交互组件的 Server RPC 按距离校验后触发；
+ *   - 专用服务器不需要候选，关闭重叠事件。
+ */
+UCLASS(ClassGroup = (ZBeta), meta = (BlueprintSpawnableComponent))
+class ZBETA_API UZBInteractableComponent : public USphereComponent
+{
+	GENERATED_BODY()
+
+public:
+	UZBInteractableComponent();
+
+	const FZBInteractionPrompt& GetPrompt() const { return Prompt; }
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void SetPrompt(const FZBInteractionPrompt& NewPrompt);
+
+	bool IsInteractionEnabled() const { return bInteractionEnabled; }
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void SetInteractionEnabled(bool bEnabled);
+
+	int32 GetPriority() const { return Priority; }
+
+	// 执行交互（仅服务器）
+	void Interact(APawn* InstigatorPawn);
+
+	// 登记正在观察本对象的交互组件（Pawn 为与本对象重叠的那个 Pawn），并把自己加入它的候选
+	void AddWatcher(UZBInteractionComponent* InteractionComponent, const APawn* Pawn);
+
+	// 注销交互组件（不改动它的候选，由交互组件自己清理）
+	void RemoveWatcher(UZBInteractionComponent* InteractionComponent);
+
+	UPROPERTY(BlueprintAssignable)
+	FZBOnInteract OnInteract;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UPROPERTY(EditAnywhere, Category = "Interaction", meta = (DisplayName = "交互提示"))
+	FZBInteractionPrompt Prompt;
+
+	// 多个交互对象同时在范围内时，优先级高的优先，同优先级再比距离与朝向
+	UPROPERTY(EditAnywhere, Category = "Interaction", meta = (DisplayName = "优先级"))
+	int32 Priority = 0;
+
+	UPROPERTY(EditAnywhere, Category = "Interaction", meta = (DisplayName = "可交互"))
+	bool bInteractionEnabled = true;
+
+private:
+	UFUNCTION()
+	void OnPawnBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnPawnEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	// 本地控制该 Pawn 的玩家的交互组件，不是本地玩家返回 nullptr
+	static UZBInteractionComponent* FindInteractionComponent(const AActor* Actor);
+
+	// 通知正在重叠的交互组件重新评估
+	void NotifyWatchers() const;
+
+	struct FWatcher
+	{
+		TWeakObjectPtr<UZBInteractionComponent> InteractionComponent;
+		// 登记时重叠的 Pawn，离开时按它匹配
+		TObjectKey<AActor> Pawn;
+	};
+
+	// 当前登记了本对象的交互组件（通常只有一个本地玩家）
+	TArray<FWatcher, TInlineAllocator<2>> Watchers;
+};
@@ -0,0 +1,199 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/ZBPoseHistory.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ZBLagCompensationSubsystem.generated.h"
+
+class ACharacter;
+class APlayerController;
+enum class EVisibilityBasedAnimTickOption : uint8;
+
+/**
+ * @brief 受击判定球（挂在骨骼上）
+ */
+USTRUCT()
+struct FZBHitboxDefinition
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	FName Bone;
+
+	UPROPERTY(Config)
+	float Radius = 20.f;
+};
+
+/**
+ * @brief 回溯校验结果
+ */
+struct FZBRewindResult
+{
+	// 目标有历史记录、时间在回溯范围内且回溯成功
+	bool bRewound = false;
+
+	// 扫掠与目标相交（有判定球时以判定球为准，否则以胶囊为准）
+	bool bHit = false;
+
+	// 命中的判定球下标，INDEX_NONE 表示只命中胶囊 / 未命中
+	int32 HitboxIndex = INDEX_NONE;
+
+	FZBRewoundCharacter Pose;
+};
+
+/**
+ * @brief 回溯校验请求：在 Time 时刻，半径 TraceRadius 的球从 TraceStart 扫到 TraceEnd 是否命中 Target
+ */
+struct FZBRewindRequest
+{
+	TWeakObjectPtr<const AActor> Target;
+
+	// 服务器世界时间（通常是 EstimateClientViewTime 的结果），早于 MaxRewindSeconds 的请求直接拒绝
+	double Time = 0.0;
+
+	FVector TraceStart = FVector::ZeroVector;
+	FVector TraceEnd = FVector::ZeroVector;
+	float TraceRadius = 0.f;
+
+	// 本帧批量处理后回调（游戏线程）
+	TFunction<void(const FZBRewindResult&)> OnValidated;
+};
+
+/**
+ * @brief 服务器端延迟补偿
+ *
+ * 功能说明：
+ *   - 服务器上每个角色一段固定长度的环形历史（FZBPoseHistory）：胶囊位置 / 朝向 / 尺寸、判定球骨骼位置、State 标签掩码；
+ *   - 历史长度（HistorySamples）与判定球数量在初始化时确定，之后不再分配，内存有上界；
+ *   - 只有玩家操控的角色，以及距某个玩家角色 ActivationRadius 以内的角色才采样（每 ActivationCheckInterval 秒重新判定），
+ *     远处的敌人不采样、也不强制刷新骨骼，服务器的动画开销只随玩家附近的敌人数增长；
+ *   - 回溯查询在相邻两次采样之间插值位置与朝向，标签取较早的那次采样（判定窗口不被插值拉长）；
+ *   - 客户端预测的命中通过 QueueValidation 入队，每帧统一处理一次：同一目标同一时刻只回溯一次，
+ *     判定全部用几何计算完成，不移动场景里的 Actor，也不做物理查询；
+ *   - 客户端预测的弹反用 RewindCharacter 取攻击者在客户端画面时刻的 State 标签（State.ParryWindowActive）。
+ *
+ * 用法（见 UZBMeleeHitSubsystem::ValidateClientHit / ValidateClientParry）：
+ *   double ViewTime;
+ *   if (!Subsystem->EstimateClientViewTime(PlayerController, ClientTime, ViewTime)) return;  // 时间戳过旧，拒绝
+ *   Subsystem->QueueValidation({ Target, ViewTime, Start, End, Radius, [](const FZBRewindResult& Result)
+ *   {
+ *       if (Result.bHit && !Result.Pose.HadStateTag(Tags.State_IFrame)) { ... }
+ *   }});
+ *
+ * 注意事项：
+ *   - 只在服务器创建；角色在 AZBCharacterBase::BeginPlay / EndPlay 中注册与注销；
+ *   - 配置了判定球时，采样中的角色网格体改为始终刷新骨骼（专用服务器默认不刷新，否则记录的判定球全是旧姿态），
+ *     停止采样时还原；
+ *   - 停止采样的角色清空历史，回溯返回 false（校验结果 bRewound 为 false）；刚开始采样的角色历史较短，早于最老采样的时间取最老采样；
+ *   - 早于 Now - MaxRewindSeconds 的时间一律拒绝（不夹取），防止客户端伪造旧时间戳换取更长回溯；晚于当前的时间按当前处理。
+ */
+UCLASS(Config = Game)
+class ZBETA_API UZBLagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(ACharacter* Character);
+	void UnregisterCharacter(ACharacter* Character);
+
+	// 立即回溯一个角色（单次查询用，如弹反校验；命中校验请走 QueueValidation 批量处理），超出回溯范围返回 false
+	bool RewindCharacter(const AActor* Character, double Time, FZBRewoundCharacter& OutPose) const;
+
+	// 入队一次校验，本帧 Tick 末尾统一处理
+	void QueueValidation(FZBRewindRequest&& Request);
+
+	/**
+	 * @brief 由客户端上报的时间戳估算它画面上的世界时间
+	 * @param ClientTime 客户端发出请求时的 GetServerWorldTimeSeconds
+	 * @param OutViewTime ClientTime - 单程延迟 - 模拟端插值延迟，不晚于当前时间
+	 * @return 结果早于 Now - MaxRewindSeconds 时返回 false，调用方应拒绝该请求
+	 */
+	bool EstimateClientViewTime(const APlayerController* PlayerController, double ClientTime, double& OutViewTime) const;
+
+	// 时间是否在允许的回溯范围内
+	bool IsWithinRewindWindow(double Time) const;
+
+	const TArray<FZBHitboxDefinition>& GetHitboxes() const { return Hitboxes; }
+	float GetMaxRewindSeconds() const { return MaxRewindSeconds; }
+
+	// 全部历史占用的字节数
+	SIZE_T GetAllocatedSize() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// ========== 配置（DefaultGame.ini） ==========
+
+	// 每个角色的历史采样数
+	UPROPERTY(Config)
+	int32 HistorySamples = 64;
+
+	// 两次采样的最小间隔（秒），服务器帧率高于 1 / 该值时跳帧采样
+	UPROPERTY(Config)
+	float MinSampleInterval = 1.f / 60.f;
+
+	// 最大回溯时长（秒）
+	UPROPERTY(Config)
+	float MaxRewindSeconds = 0.5f;
+
+	// 模拟端插值带来的额外显示延迟（秒），用于 EstimateClientViewTime
+	UPROPERTY(Config)
+	float SimulatedProxyDelaySeconds = 0.05f;
+
+	// 非玩家角色距最近的玩家角色在该范围内才采样（cm），应大于近战距离加上 MaxRewindSeconds 内的移动距离
+	UPROPERTY(Config)
+	float ActivationRadius = 3000.f;
+
+	// 重新判定哪些角色需要采样的间隔（秒）
+	UPROPERTY(Config)
+	float ActivationCheckInterval = 0.25f;
+
+	// 判定球（骨骼不存在时退化为胶囊中心）
+	UPROPERTY(Config)
+	TArray<FZBHitboxDefinition> Hitboxes;
+
+	static constexpr int32 MaxHitboxes = 8;
+
+private:
+	// 一个角色的历史
+	struct FHistory
+	{
+		TWeakObjectPtr<ACharacter> Character;
+		// 角色销毁后仍能用它从 HistoryIndexByActor 中移除
+		TObjectKey<AActor> Key;
+		// 判定球对应的骨骼下标（INDEX_NONE 表示用胶囊中心）
+		TArray<int32, TInlineAllocator<MaxHitboxes>> BoneIndices;
+		FZBPoseHistory Poses;
+		// 正在采样（玩家角色或玩家附近）
+		bool bActive = false;
+		// 开始采样前网格体的可见性动画选项，停止采样时还原
+		EVisibilityBasedAnimTickOption SavedAnimTickOption{};
+	};
+
+	void RemoveHistoryAt(int32 Index);
+	// 按与玩家角色的距离开始 / 停止采样
+	void UpdateActivation();
+	void SetHistoryActive(FHistory& History, bool bActive) const;
+	void RecordFrame(double Now);
+	void RecordCharacter(FHistory& History, double Now) const;
+	void ProcessValidationRequests(double Now);
+	void EvaluateRequest(const FZBRewindRequest& Request, const FZBRewoundCharacter& Pose, FZBRewindResult& OutResult) const;
+
+	TArray<FHistory> Histories;
+	TMap<TObjectKey<AActor>, int32> HistoryIndexByActor;
+
+	TArray<FZBRewindRequest> PendingRequests;
+	double LastSampleTime = -UE_BIG_NUMBER;
+	double LastActivationCheckTime = -UE_BIG_NUMBER;
+
+	// 复用的玩家角色位置缓冲
+	TArray<FVector> PlayerLocations;
+};
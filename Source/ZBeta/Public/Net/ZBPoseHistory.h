@@ -0,0 +1,86 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * @brief 某一时刻回溯出的角色姿态
+ */
+struct FZBRewoundCharacter
+{
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	float CapsuleRadius = 0.f;
+	float CapsuleHalfHeight = 0.f;
+
+	// 该时刻的 State 标签位掩码（位定义见 FZBStateTagIndex），取不晚于该时刻的最近一次采样，不插值
+	uint64 StateTagMask = 0;
+
+	// 与 UZBLagCompensationSubsystem 的 Hitboxes 一一对应
+	TArray<FVector, TInlineAllocator<8>> HitboxLocations;
+
+	// 该时刻是否带有某个 State 标签（含子标签），如 State.ParryWindowActive / State.IFrame
+	bool HadStateTag(const FGameplayTag& Tag) const;
+};
+
+/**
+ * @brief 一个角色的定长环形姿态历史
+ *
+ * 功能说明：
+ *   - Init 时一次性分配 NumSamples 个采样及每个采样 NumHitboxes 个判定球位置，之后写满即覆盖最老的采样；
+ *   - 判定球位置另存一段连续数组，避免每个采样一个小数组；
+ *   - Rewind 在相邻两次采样之间插值：位置、胶囊尺寸、判定球线性插值，朝向球面插值，标签取较早的采样。
+ *
+ * 注意事项：
+ *   - 采样时间须单调递增；
+ *   - 不做回溯范围检查，早于最老 / 晚于最新采样的时间取端点，范围由调用方（UZBLagCompensationSubsystem）把关。
+ */
+class ZBETA_API FZBPoseHistory
+{
+public:
+	// 一次采样（不含判定球）
+	struct FSample
+	{
+		double Time = 0.0;
+		FVector Location = FVector::ZeroVector;
+		FQuat Rotation = FQuat::Identity;
+		float CapsuleRadius = 0.f;
+		float CapsuleHalfHeight = 0.f;
+		uint64 StateTagMask = 0;
+	};
+
+	// 分配历史并清空已有采样，NumSamples 至少为 1
+	void Init(int32 NumSamples, int32 InNumHitboxes);
+
+	// 写入一次采样，返回该采样的判定球位置由调用方填写（写满时覆盖最老的采样）
+	TArrayView<FVector> AddSample(const FSample& Sample);
+
+	/**
+	 * @brief 回溯到 Time 时刻的姿态
+	 * @return 没有任何采样时返回 false
+	 */
+	bool Rewind(double Time, FZBRewoundCharacter& OutPose) const;
+
+	// 丢弃全部采样，保留已分配的内存
+	void Reset() { Head = 0; NumWritten = 0; }
+
+	// 已写入的采样数（不超过容量）
+	int32 Num() const { return NumWritten; }
+	int32 GetNumHitboxes() const { return NumHitboxes; }
+
+	SIZE_T GetAllocatedSize() const { return Samples.GetAllocatedSize() + HitboxLocations.GetAllocatedSize(); }
+
+private:
+	// 逻辑下标（0 = 最老）到物理下标
+	int32 ToPhysical(int32 LogicalIndex) const { return (Head - NumWritten + LogicalIndex + Samples.Num()) % Samples.Num(); }
+
+	TArray<FSample> Samples;
+	// Samples.Num() * NumHitboxes，第 i 个采样的判定球从 i * NumHitboxes 开始
+	TArray<FVector> HitboxLocations;
+	int32 NumHitboxes = 0;
+	// 下一次写入的物理下标与已写入的采样数
+	int32 Head = 0;
+	int32 NumWritten = 0;
+};
@@ -0,0 +1,128 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "ZBReplicationGraph.generated.h"
+
+/**
+ * @brief Actor 类 -> 复制图节点的路由策略
+ */
+enum class EZBClassRepNodeMapping : uint32
+{
+	// 不进入任何全局节点（PlayerState / PlayerController 由专门节点负责）
+	NotRouted,
+	// 对所有连接总是相关（GameState 等 AInfo）
+	RelevantAllConnections,
+	// 放进空间网格，不会移动
+	Spatialize_Static,
+	// 放进空间网格，每帧重新计算所在格子
+	Spatialize_Dynamic,
+	// 放进空间网格，醒着按动态处理，休眠后按静态处理（敌人）
+	Spatialize_Dormancy,
+};
+
+/**
+ * @brief 每个连接独有的“总是相关”节点
+ *
+ * 功能说明：
+ *   - 基类负责连接自己的 PlayerController 与 ViewTarget（Pawn）；
+ *   - 这里额外把该连接自己的 PlayerState（ASC 与 AttributeSet 挂在其上）全频率地发给拥有者，
+ *     其他连接只通过 PlayerStateFrequencyLimiter 低频获得这个 PlayerState。
+ *
+ * 注意事项：
+ *   - 分屏（一个连接多个 Viewer）只处理第一个 PlayerController。
+ */
+UCLASS()
+class ZBETA_API UZBReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	// 上一次加入列表的 PlayerState（裸指针用于 Actor 销毁后仍能从列表移除）
+	FActorRepListType LastPlayerState = nullptr;
+	TWeakObjectPtr<AActor> LastPlayerStateWeak;
+};
+
+/**
+ * @brief ZBeta 专用复制图
+ *
+ * 功能说明：
+ *   取代默认的“每个连接 × 每个 Actor”相关性遍历，按 Actor 类路由到不同节点：
+ *   - 敌人（AZBEnemyCharacter，Minimal 模式 ASC）：空间网格 + 休眠，远处敌人进入按距离分频的动态节点；
+ *   - 玩家角色：空间网格（动态）；
+ *   - PlayerState：对拥有者走每连接的总是相关节点，对其他连接走 PlayerStateFrequencyLimiter 分批低频复制；
+ *   - PlayerController：仅拥有者相关，由每连接节点负责；
+ *   - AInfo（GameState 等）：全局总是相关。
+ *
+ * 注意事项：
+ *   - 在 DefaultEngine.ini 的 NetDriver 段中通过 ReplicationDriverClassName 启用；
+ *   - 只对服务器生效，客户端不会创建复制图；
+ *   - 复制周期按类从 CDO 的 NetUpdateFrequency 初始化；运行时改频率的 Actor（AZBPlayerState 的自适应频率）
+ *     必须调用 NotifyNetUpdateFrequencyChanged，否则复制图仍按类的周期调度。
+ */
+UCLASS(Transient, Config = Engine)
+class ZBETA_API UZBReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UZBReplicationGraph();
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+	// 上一帧 ServerReplicateActors 的耗时（秒），供压测统计复制开销
+	double GetLastReplicateSeconds() const { return LastReplicateSeconds; }
+
+	// Actor 运行时修改了 NetUpdateFrequency，按新频率重算它的复制周期（没有使用本复制图时什么都不做）
+	static void NotifyNetUpdateFrequencyChanged(AActor* Actor);
+
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_GridSpatialization2D> GridNode;
+
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
+
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_PlayerStateFrequencyLimiter> PlayerStateNode;
+
+protected:
+	// 空间网格单元尺寸（厘米）
+	UPROPERTY(Config)
+	float GridCellSize = 10000.f;
+
+	// 网格原点偏移，需覆盖地图最小坐标
+	UPROPERTY(Config)
+	FVector2D SpatialBias = FVector2D(-200000.f, -200000.f);
+
+	// 敌人（AZBEnemyCharacter 及其全部子类）的网络裁剪距离（厘米）
+	UPROPERTY(Config)
+	float EnemyCullDistance = 15000.f;
+
+	// 网格内动态 Actor 是否使用按距离分频的节点（远处的敌人降低复制频率）
+	UPROPERTY(Config)
+	bool bUseDynamicSpatialFrequency = true;
+
+private:
+	// 显式路由表，未命中的类按 CDO 的复制属性推导
+	EZBClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	// 按 CDO 的 NetUpdateFrequency / NetCullDistance 初始化类复制信息
+	void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const;
+
+	// 复制周期（帧）= 服务器 Tick 率 / NetUpdateFrequency
+	uint32 GetReplicationPeriodFrame(float NetUpdateFrequency) const;
+
+	TClassMap<EZBClassRepNodeMapping> ClassRepNodePolicies;
+
+	double LastReplicateSeconds = 0.0;
+};
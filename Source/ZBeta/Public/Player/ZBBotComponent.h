@@ -0,0 +1,119 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Components/ActorComponent.h"
+#include "ZBBotComponent.generated.h"
+
+class ACharacter;
+class AZBPlayerController;
+class UCharacterMovementComponent;
+
+/**
+ * @brief 脚本步骤
+ */
+UENUM()
+enum class EZBBotStep : uint8
+{
+	Move,
+	Sprint,
+	Attack,
+	Dodge,
+	Rune,
+};
+
+/**
+ * @brief 无头机器人客户端驱动
+ *
+ * 功能说明：
+ *   - 客户端带 -ZBBot 启动时由 AZBPlayerController 创建，通过 InjectInput 注入输入，
+ *     与真实玩家走同一条 Controller -> ASC 路径；
+ *   - 循环执行脚本：移动 -> 冲刺 -> 连击 -> 闪避 -> 符文，方向与符文槽位由随机流决定；
+ *   - 每 ReportInterval 秒把 RTT、位置纠正次数、收发带宽追加到 CSV，结束时输出汇总。
+ *
+ * 用法（每个机器人一个进程）：
+ *   ZBeta 127.0.0.1 -nullrhi -nosound -ZBBot -ZBBotDuration=600 -ZBBotFPS=30
+ *
+ * 注意事项：
+ *   - 纠正次数通过 CharacterMovement 客户端预测数据的 bUpdatePosition 上升沿统计，
+ *     本组件注册为 CharacterMovement 的 Tick 前置，保证在它被清掉之前读取。
+ */
+UCLASS(ClassGroup = (ZBeta), Within = ZBPlayerController)
+class ZBETA_API UZBBotComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UZBBotComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// 每步移动 / 冲刺的持续时间（秒）
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float MoveStepDuration = 2.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float SprintStepDuration = 1.5f;
+
+	// 连击次数与间隔
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	int32 AttackComboCount = 3;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float AttackInterval = 0.35f;
+
+	// 统计上报间隔（秒）
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float ReportInterval = 1.f;
+
+private:
+	AZBPlayerController* GetZBController() const;
+
+	void ParseCommandLine();
+	void AdvanceStep();
+	void TickStep(float DeltaTime);
+
+	// 按下并在 HoldTime 秒后松开一个能力输入
+	void PressAbility(const FGameplayTag& InputTag, float HoldTime);
+	void TickHeldAbility(float DeltaTime);
+
+	// Pawn 变化时把 Tick 前置从旧的 CharacterMovement 移到新的上，每个 Pawn 只注册一次
+	void UpdateMovementPrerequisite(ACharacter* Character);
+	void SampleCorrections();
+	void WriteReport(double Now);
+
+	// 已注册 Tick 前置的 CharacterMovement
+	TWeakObjectPtr<UCharacterMovementComponent> PrerequisiteMovement;
+
+	EZBBotStep CurrentStep = EZBBotStep::Move;
+	float StepTimeRemaining = 0.f;
+	int32 AttacksRemaining = 0;
+	FVector2D MoveAxis = FVector2D(0.f, 1.f);
+
+	// 当前按住的能力输入
+	FGameplayTag HeldInputTag;
+	float HeldTimeRemaining = 0.f;
+
+	FRandomStream RandomStream;
+	double StartTime = 0.0;
+	double LastReportTime = 0.0;
+	float DurationSeconds = 0.f;
+
+	// 统计
+	bool bWasUpdatingPosition = false;
+	int32 CorrectionCount = 0;
+	int32 CorrectionCountAtLastReport = 0;
+	int32 NumReports = 0;
+	double PingSumMs = 0.0;
+	float PingMaxMs = 0.f;
+	double InBytesPerSecondSum = 0.0;
+	double OutBytesPerSecondSum = 0.0;
+
+	FString CsvPath;
+};
@@ -0,0 +1,100 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Interaction/ZBInteractableComponent.h"
+#include "ZBInteractionComponent.generated.h"
+
+class AZBPlayerController;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FZBOnInteractionPromptChanged, bool, bHasPrompt, const FZBInteractionPrompt&, Prompt);
+
+/**
+ * @brief 玩家的交互
+ *
+ * 功能说明：
+ *   - 候选由 UZBInteractableComponent 的重叠事件登记 / 移除，组件只持有范围内的少量对象；
+ *   - 控制的 Pawn 变化时（出生、重生、死亡分离）清空候选，再按新 Pawn 已有的重叠重新登记，
+ *     不依赖进入范围时 Pawn 是否已被控制；
+ *   - 最佳候选按优先级、距离、视角朝向选出，只在玩家移动超过 ReevaluateDistance、
+ *     视角转过 ReevaluateYaw 或候选集合变化时重新评估；
+ *   - 评估结果（目标与提示数据）缓存下来，变化时广播 OnInteractionPromptChanged 供 UI 显示；
+ *   - 按下交互键直接使用缓存的目标，不做任何检测。
+ *
+ * 注意事项：
+ *   - 候选集合为空时组件不 Tick，闲置玩家零开销；
+ *   - 交互请求经 Server RPC 发到服务器，服务器只做距离校验后调用 UZBInteractableComponent::Interact。
+ */
+UCLASS(ClassGroup = (ZBeta), Within = ZBPlayerController)
+class ZBETA_API UZBInteractionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UZBInteractionComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// 与缓存的最佳候选交互，没有候选时返回 false
+	bool Interact();
+
+	void AddCandidate(UZBInteractableComponent* Interactable);
+	void RemoveCandidate(UZBInteractableComponent* Interactable);
+
+	// 候选的提示或可用状态变化，立即重新评估
+	void OnCandidateChanged();
+
+	// 控制器的 Pawn 变化（AZBPlayerController::SetPawn 调用）：清空旧候选，按新 Pawn 当前的重叠重新登记
+	void OnPawnChanged(APawn* NewPawn);
+
+	UZBInteractableComponent* GetBestInteractable() const { return BestInteractable.Get(); }
+
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	bool HasPrompt() const { return BestInteractable.IsValid(); }
+
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	const FZBInteractionPrompt& GetPrompt() const { return CachedPrompt; }
+
+	// 最佳候选或其提示变化（没有候选时 bHasPrompt 为 false）
+	UPROPERTY(BlueprintAssignable)
+	FZBOnInteractionPromptChanged OnInteractionPromptChanged;
+
+protected:
+	// 移动超过该距离才重新评估（cm）
+	UPROPERTY(EditDefaultsOnly, Category = "Interaction", meta = (DisplayName = "重新评估距离", ClampMin = "0"))
+	float ReevaluateDistance = 50.f;
+
+	// 视角水平转过该角度才重新评估（度）
+	UPROPERTY(EditDefaultsOnly, Category = "Interaction", meta = (DisplayName = "重新评估角度", ClampMin = "0"))
+	float ReevaluateYaw = 15.f;
+
+	// 有候选时检查移动的间隔（秒）
+	UPROPERTY(EditDefaultsOnly, Category = "Interaction", meta = (DisplayName = "检查间隔", ClampMin = "0"))
+	float CheckInterval = 0.1f;
+
+	// 打分：距离（cm）+ 视角夹角（度）* FacingWeight，越低越优先
+	UPROPERTY(EditDefaultsOnly, Category = "Interaction", meta = (DisplayName = "朝向权重", ClampMin = "0"))
+	float FacingWeight = 5.f;
+
+	// 服务器校验距离时在交互半径上额外放宽的距离，抵消移动同步误差（cm）
+	UPROPERTY(EditDefaultsOnly, Category = "Interaction", meta = (DisplayName = "服务器距离容差", ClampMin = "0"))
+	float ServerDistanceTolerance = 150.f;
+
+private:
+	UFUNCTION(Server, Reliable)
+	void ServerInteract(UZBInteractableComponent* Interactable);
+
+	// 从候选中选出最佳目标，目标或提示变化时广播
+	void Evaluate();
+
+	TArray<TWeakObjectPtr<UZBInteractableComponent>> Candidates;
+
+	TWeakObjectPtr<UZBInteractableComponent> BestInteractable;
+	FZBInteractionPrompt CachedPrompt;
+
+	// 上次评估时的位置与视角朝向
+	FVector EvaluatedLocation = FVector::ZeroVector;
+	float EvaluatedYaw = 0.f;
+};
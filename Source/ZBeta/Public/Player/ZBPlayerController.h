@@ -6,6 +6,8 @@
 #include "GameFramework/PlayerController.h"
 #include "GameplayTagContainer.h"
 #include "ActiveGameplayEffectHandle.h"  // 添加这个头文件
+#include "Combat/ZBProjectileSubsystem.h"
+#include "Input/ZBInputRecording.h"
 #include "ZBPlayerController.generated.h"
 
 struct FActiveGameplayEffectHandle;
@@ -15,6 +17,10 @@ struct FInputActionValue;
 class UInputMappingContext;
 class UInputAction;
 class UZBInputConfig;
+class UZBBotComponent;
+class UZBTargetLockComponent;
+class UZBInteractionComponent;
+class UZBMeleeWeaponComponent;
 /**
  * 
  */
@@ -26,10 +32,60 @@ class ZBETA_API AZBPlayerController : public APlayerController
 public:
 	AZBPlayerController();
 
+	// ========== 输入录制 / 回放 ==========
+	// 录像默认放在 Saved/InputRecordings/，命令行 -ZBRecordInput=<文件> / -ZBReplayInput=<文件> 可在启动时自动开始
+
+	// 开始录制输入（控制台：ZBRecordInput [文件名]）
+	UFUNCTION(Exec)
+	void ZBRecordInput(const FString& FileName);
+
+	// 停止录制并保存
+	UFUNCTION(Exec)
+	void ZBStopRecordInput();
+
+	// 回放录像，回放期间忽略真实输入（控制台：ZBReplayInput <文件名>）
+	UFUNCTION(Exec)
+	void ZBReplayInput(const FString& FileName);
+
+	bool IsRecordingInput() const { return bRecordingInput; }
+	bool IsReplayingInput() const { return bReplayingInput; }
+
+	/**
+	 * @brief 注入一条输入，与真实输入走同一条处理路径（回放、机器人共用）
+	 * @param Type     输入类型
+	 * @param Axis     Move / Look 的轴值
+	 * @param InputTag 能力输入的标签
+	 */
+	void InjectInput(EZBRecordedInputType Type, const FVector2D& Axis, const FGameplayTag& InputTag);
+
+	UZBInteractionComponent* GetInteractionComponent() const { return InteractionComponent; }
+
+	// ========== 客户端预测的战斗判定（服务器回溯校验，见 UZBMeleeHitSubsystem） ==========
+
+	// 上报本地检测到的近战命中（由客户端的 UZBMeleeHitSubsystem 调用）
+	void ReportMeleeHit(UZBMeleeWeaponComponent* Weapon, AActor* Victim, const FVector& TraceStart, const FVector& TraceEnd);
+
+	/**
+	 * @brief 上报本地判定成功的弹反（弹反 GA 在本地看到攻击者带 State.ParryWindowActive 时调用）
+	 * @details 服务器确认后向本 Pawn 发送 Ability.Parry 事件，伤害免除与反击以服务器确认为准。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	void ReportParry(AActor* Attacker);
+
+	/**
+	 * @brief 服务器发射投射物后，对附近的远端玩家调用：客户端用同样参数做一次纯表现发射
+	 * @details 世界子系统自己不能发 RPC；由 UZBProjectileSubsystem 按距离挑选连接，发射者自己的连接已经本地预测过，不会收到。
+	 */
+	UFUNCTION(Client, Unreliable)
+	void ClientFireProjectiles(const FZBProjectileParams& Params, AActor* Instigator);
 	
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void SetupInputComponent() override;
+	virtual void PlayerTick(float DeltaTime) override;
+	// 服务器（Possess）与客户端（Pawn 复制）都会走到这里
+	virtual void SetPawn(APawn* InPawn) override;
 
 
 	/**
@@ -53,6 +109,30 @@ protected:
 	void AbilityInputHeld(FGameplayTag InputTag);
 
 private:
+	// ClientTime 为客户端的 GetServerWorldTimeSeconds，服务器据此回溯到客户端画面的时刻；
+	// 每次上报都要排队回溯校验，服务器按 CombatReportsPerSecond 限流，超出的直接丢弃
+	UFUNCTION(Server, Reliable)
+	void ServerReportMeleeHit(UZBMeleeWeaponComponent* Weapon, AActor* Victim, double ClientTime, FVector_NetQuantize TraceStart, FVector_NetQuantize TraceEnd);
+
+	UFUNCTION(Server, Reliable)
+	void ServerReportParry(AActor* Attacker, double ClientTime);
+
+	// 当前的服务器世界时间（客户端上为同步估算值）
+	double GetServerWorldTime() const;
+
+	// 服务器上消耗一次命中 / 弹反上报的额度（令牌桶），额度用完返回 false
+	bool ConsumeCombatReportBudget();
+
+	// 每秒恢复的上报额度；一刀扫中多个目标会同时上报多次，由 CombatReportBurst 吸收
+	UPROPERTY(EditDefaultsOnly, Category = "Combat", meta = (DisplayName = "每秒命中上报数", ClampMin = "1"))
+	float CombatReportsPerSecond = 20.f;
+
+	// 额度上限（同一时刻最多连续上报的次数）
+	UPROPERTY(EditDefaultsOnly, Category = "Combat", meta = (DisplayName = "命中上报突发上限", ClampMin = "1"))
+	float CombatReportBurst = 24.f;
+
+	float CombatReportBudget = 0.f;
+	double CombatReportBudgetTime = -UE_BIG_NUMBER;
 		
 	UPROPERTY()
 	TObjectPtr<UZBAbilitySystemComponent> ZBAbilitySystemComponent;
@@ -85,6 +165,41 @@ private:
 	void Input_TargetLock();
 	void Input_Menu();
 
+	// 输入的实际处理（真实输入、回放、机器人都走这里）
+	void HandleMoveInput(const FVector2D& InputAxisVector);
+	void HandleLookInput(const FVector2D& LookVector);
+	void HandleInput(EZBRecordedInputType Type, const FVector2D& Axis, const FGameplayTag& InputTag);
+
+	// 真实输入入口：回放中丢弃，录制中记录，然后交给 HandleInput
+	void OnLocalInput(EZBRecordedInputType Type, const FVector2D& Axis, const FGameplayTag& InputTag);
+
+	static FString ResolveInputRecordingPath(const FString& FileName);
+
+	// 回放结束
+	void FinishInputReplay();
+
+	FZBInputRecording InputRecording;
+	FString InputRecordingPath;
+	bool bRecordingInput = false;
+	bool bReplayingInput = false;
+	// 录制 / 回放开始后的帧序号
+	uint32 InputFrame = 0;
+	double InputStartTime = 0.0;
+	// 回放游标
+	int32 ReplayCursor = 0;
+
+	// 机器人模式（-ZBBot）驱动组件，仅本地控制器创建
+	UPROPERTY()
+	TObjectPtr<UZBBotComponent> BotComponent;
+
+	// 目标锁定（只在本地控制器上起作用）
+	UPROPERTY(VisibleAnywhere, Category = "TargetLock")
+	TObjectPtr<UZBTargetLockComponent> TargetLockComponent;
+
+	// 交互候选与提示（候选只在本地控制器上登记，交互请求经它的 Server RPC 发出）
+	UPROPERTY(VisibleAnywhere, Category = "Interaction")
+	TObjectPtr<UZBInteractionComponent> InteractionComponent;
+
 	//是否正在冲刺
 	UPROPERTY()
 	bool bIsSprinting = false;
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "AbilitySystemInterface.h"
+#include "GameplayTagContainer.h"
 #include "GameFramework/PlayerState.h"
 #include "ZBPlayerState.generated.h"
 
@@ -11,6 +12,9 @@
 
 class UAbilitySystemComponent;
 class UAttributeSet;
+struct FActiveGameplayEffect;
+struct FActiveGameplayEffectHandle;
+struct FGameplayEffectSpec;
 
 /**
  * 
@@ -25,12 +29,61 @@ public:
 	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
 	UAttributeSet* GetAttributeSet() const {return AttributeSet;}
 
+	/**
+	 * @brief 请求一次网络更新频率提升（仅服务器生效）
+	 * @details 立即 ForceNetUpdate，并把更新频率拉到 ActiveNetUpdateFrequency，
+	 *          活动停止 NetBoostHoldTime 秒后逐级衰减回 IdleNetUpdateFrequency。
+	 */
+	void RequestNetUpdateBoost();
+
 
 protected:
+	virtual void BeginPlay() override;
+
 	UPROPERTY(EditAnywhere)
 	TObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
-	
+
 	UPROPERTY()
 	TObjectPtr<UAttributeSet> AttributeSet;
-	
+
+	// ========== 自适应网络更新频率 ==========
+	// ASC 在 Mixed 模式下挂在 PlayerState 上，但空闲玩家不需要 100Hz 的复制频率
+
+	// 空闲时的网络更新频率
+	UPROPERTY(EditDefaultsOnly, Category = "Network", meta = (DisplayName = "空闲网络更新频率", ClampMin = "1.0"))
+	float IdleNetUpdateFrequency = 10.f;
+
+	// 战斗中 / 有 GE、Tag 变化时的网络更新频率
+	UPROPERTY(EditDefaultsOnly, Category = "Network", meta = (DisplayName = "活跃网络更新频率", ClampMin = "1.0"))
+	float ActiveNetUpdateFrequency = 100.f;
+
+	// 最后一次活动之后保持高频的时间（秒）
+	UPROPERTY(EditDefaultsOnly, Category = "Network", meta = (DisplayName = "高频保持时间", ClampMin = "0.0"))
+	float NetBoostHoldTime = 2.f;
+
+	// 衰减阶段每一步的间隔（秒），每步频率减半直到空闲频率
+	UPROPERTY(EditDefaultsOnly, Category = "Network", meta = (DisplayName = "频率衰减间隔", ClampMin = "0.05"))
+	float NetDecayInterval = 0.5f;
+
+private:
+	// State_InCombat 增删回调：进入战斗保持高频，离开战斗开始衰减
+	void OnInCombatTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	// 任意 Tag 增删回调（忽略仅本地存在的移动状态 Tag）
+	void OnAnyTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	// GE 应用 / 移除回调
+	void OnGameplayEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle);
+	void OnGameplayEffectRemoved(const FActiveGameplayEffect& Effect);
+
+	// 定时器回调：频率逐级衰减
+	void DecayNetUpdateFrequency();
+
+	// 设置更新频率并同步到复制图的复制周期
+	void ApplyNetUpdateFrequency(float NewFrequency);
+
+	bool bInCombat = false;
+
+	FTimerHandle NetDecayTimerHandle;
+
 };
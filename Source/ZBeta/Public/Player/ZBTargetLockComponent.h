@@ -0,0 +1,133 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ZBTargetLockComponent.generated.h"
+
+class AZBCharacterBase;
+class AZBPlayerController;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FZBOnTargetLockChanged, AActor*, NewTarget);
+
+/**
+ * @brief 玩家的目标锁定
+ *
+ * 功能说明：
+ *   - 按下锁定键时从 UZBTargetLockSubsystem 的网格取附近角色，按视角夹角与距离打分，
+ *     按分数依次做视线检测，第一个可见的即为锁定目标；
+ *   - 锁定期间以 ScoreInterval 的低频重新打分（供切换使用）并校验目标：死亡、超出 BreakDistance、
+ *     或持续 LineOfSightGraceTime 不可见时解除锁定；
+ *   - 视线检测结果按目标缓存 VisibilityCacheTime 秒，打分、校验、切换共用；
+ *   - 切换目标只在缓存的候选里找视角左 / 右侧偏角最近的一个，不做新的查询。
+ *
+ * 用法：
+ *   - AZBPlayerController 的锁定键调用 ToggleLock；锁定时视角输入交给 HandleLookInput（横向快速拨动切换目标），
+ *     每帧 UpdateControlRotation 把控制器转向目标。
+ *
+ * 注意事项：
+ *   - 只在本地控制器上工作，未锁定时组件不 Tick。
+ */
+UCLASS(ClassGroup = (ZBeta), Within = ZBPlayerController)
+class ZBETA_API UZBTargetLockComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UZBTargetLockComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// 未锁定时锁定最佳目标，已锁定时解除
+	void ToggleLock();
+
+	// 切换到视角左侧（Direction < 0）或右侧（Direction > 0）最近的候选
+	bool SwitchTarget(float Direction);
+
+	void ClearLock();
+
+	// 锁定时的视角输入：横向拨动超过阈值时切换目标
+	void HandleLookInput(const FVector2D& LookVector);
+
+	// 每帧把控制器旋转插值到朝向目标
+	void UpdateControlRotation(float DeltaTime);
+
+	AZBCharacterBase* GetLockedTarget() const { return LockedTarget.Get(); }
+	bool IsLocked() const { return LockedTarget.IsValid(); }
+
+	// 锁定目标变化（解除时为 nullptr），供 UI 显示锁定标记
+	UPROPERTY(BlueprintAssignable)
+	FZBOnTargetLockChanged OnTargetLockChanged;
+
+protected:
+	// 最大锁定距离（cm）
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "最大锁定距离", ClampMin = "100"))
+	float MaxLockDistance = 2000.f;
+
+	// 超出该距离自动解除锁定（cm）
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "解除锁定距离", ClampMin = "100"))
+	float BreakDistance = 2500.f;
+
+	// 视角中心到目标的最大夹角（度）
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "最大锁定夹角", ClampMin = "1", ClampMax = "180"))
+	float MaxLockAngle = 60.f;
+
+	// 打分权重：夹角与距离（均归一化到 0 - 1），分数越低越优先
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "夹角权重"))
+	float AngleWeight = 0.7f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "距离权重"))
+	float DistanceWeight = 0.3f;
+
+	// 锁定期间重新打分 / 校验的间隔（秒）
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "打分间隔", ClampMin = "0.02"))
+	float ScoreInterval = 0.1f;
+
+	// 视线检测结果的缓存时间（秒）
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "视线缓存时间", ClampMin = "0"))
+	float VisibilityCacheTime = 0.25f;
+
+	// 目标持续不可见多久后解除锁定（秒）
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "视线丢失容忍时间", ClampMin = "0"))
+	float LineOfSightGraceTime = 1.f;
+
+	// 切换目标的横向拨动阈值与冷却（秒）
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "切换拨动阈值", ClampMin = "0"))
+	float SwitchFlickThreshold = 3.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "切换冷却", ClampMin = "0"))
+	float SwitchCooldown = 0.3f;
+
+	// 控制器转向目标的插值速度
+	UPROPERTY(EditDefaultsOnly, Category = "TargetLock", meta = (DisplayName = "转向插值速度", ClampMin = "0"))
+	float RotationInterpSpeed = 10.f;
+
+private:
+	struct FCandidate
+	{
+		TWeakObjectPtr<AZBCharacterBase> Character;
+		float Score = 0.f;
+		// 从相机看过去的水平朝向（度），切换时与当前目标比较
+		float Yaw = 0.f;
+	};
+
+	struct FVisibilitySample
+	{
+		double Time = 0.0;
+		bool bVisible = false;
+	};
+
+	// 从网格取候选并打分排序
+	void RefreshCandidates();
+	bool IsTargetValid(const AZBCharacterBase* Target, const FVector& PawnLocation, float MaxDistance) const;
+	bool IsVisible(const AZBCharacterBase* Target);
+	void SetLockedTarget(AZBCharacterBase* NewTarget);
+
+	TWeakObjectPtr<AZBCharacterBase> LockedTarget;
+	TArray<FCandidate> Candidates;
+	TMap<TObjectKey<AActor>, FVisibilitySample> VisibilityCache;
+
+	double LastVisibleTime = 0.0;
+	double LastSwitchTime = 0.0;
+};
@@ -17,18 +17,29 @@ public class ZBeta : ModuleRules
 			"AIModule",
 			"StateTreeModule",
 			"GameplayStateTreeModule",
-			"GameplayCameras",
 			"UMG",
 			"Slate", 
 			"GameplayAbilities",
+			"ReplicationGraph",
 			
 		});
 
 		PrivateDependencyModuleNames.AddRange(new string[]
 		{
-			"GameplayTags","GameplayTasks","NavigationSystem","Niagara"
+			"GameplayTags","GameplayTasks","NavigationSystem","Json",
+			// 仅被 AZBPlayerCharacter 的反射属性引用，服务器上不会创建相机组件
+			"GameplayCameras"
 		});
 
+		// 专用服务器不需要表现层模块（特效等），客户端 / 编辑器才链接
+		if (Target.Type != TargetType.Server)
+		{
+			PrivateDependencyModuleNames.AddRange(new string[]
+			{
+				"Niagara"
+			});
+		}
+
 		PublicIncludePaths.AddRange(new string[] {
 			"ZBeta",
 			"ZBeta/Variant_Platforming",
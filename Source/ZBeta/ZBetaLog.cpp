@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ZBetaLog.h"
+
+#include "GameplayTagContainer.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+
+DEFINE_LOG_CATEGORY(LogZBetaInput);
+DEFINE_LOG_CATEGORY(LogZBetaCharacter);
+DEFINE_LOG_CATEGORY(LogZBetaAbility);
+DEFINE_LOG_CATEGORY(LogZBetaNet);
+DEFINE_LOG_CATEGORY(LogZBetaAsset);
+DEFINE_LOG_CATEGORY(LogZBetaBenchmark);
+
+static int32 GZBLogHotMaxPerSecond = 10;
+static FAutoConsoleVariableRef CVarZBLogHotMaxPerSecond(
+	TEXT("zb.Log.HotMaxPerSecond"),
+	GZBLogHotMaxPerSecond,
+	TEXT("ZB_LOG_HOT 每个调用点每秒最多输出的条数，<= 0 表示不限流"));
+
+
+FZBLogArg::FZBLogArg(const FGameplayTag& InValue)
+	: Value(TInPlaceType<FName>(), InValue.GetTagName())
+{
+}
+
+FZBLogArg::FZBLogArg(const UObject* InValue)
+	: Value(TInPlaceType<FName>(), InValue ? InValue->GetFName() : NAME_None)
+{
+}
+
+FStringFormatArg FZBLogArg::ToFormatArg() const
+{
+	if (const int64* IntValue = Value.TryGet<int64>())
+	{
+		return FStringFormatArg(*IntValue);
+	}
+	if (const uint64* UIntValue = Value.TryGet<uint64>())
+	{
+		return FStringFormatArg(*UIntValue);
+	}
+	if (const double* DoubleValue = Value.TryGet<double>())
+	{
+		return FStringFormatArg(*DoubleValue);
+	}
+	if (const FName* NameValue = Value.TryGet<FName>())
+	{
+		return FStringFormatArg(NameValue->ToString());
+	}
+	return FStringFormatArg(Value.Get<FString>());
+}
+
+
+bool FZBLogRateLimiter::TryConsume()
+{
+	if (GZBLogHotMaxPerSecond <= 0) return true;
+
+	// 只有抢到窗口切换的线程清零计数
+	const int64 NowMs = static_cast<int64>(FPlatformTime::Seconds() * 1000.0);
+	int64 StartMs = WindowStartMs.load(std::memory_order_relaxed);
+	if (NowMs - StartMs >= 1000 && WindowStartMs.compare_exchange_strong(StartMs, NowMs, std::memory_order_relaxed))
+	{
+		CountInWindow.store(0, std::memory_order_relaxed);
+	}
+
+	if (CountInWindow.fetch_add(1, std::memory_order_relaxed) >= GZBLogHotMaxPerSecond)
+	{
+		SuppressedCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+
+FZBDeferredLog& FZBDeferredLog::Get()
+{
+	static FZBDeferredLog Instance;
+	return Instance;
+}
+
+FZBDeferredLog::FZBDeferredLog()
+{
+	Entries.SetNum(Capacity);
+	FCoreDelegates::OnEndFrame.AddRaw(this, &FZBDeferredLog::Flush);
+	// 退出前把最后一帧的日志写出去
+	FCoreDelegates::OnPreExit.AddRaw(this, &FZBDeferredLog::Flush);
+}
+
+void FZBDeferredLog::Push(const FLogCategoryBase& Category, ELogVerbosity::Type Verbosity, const TCHAR* Format, int32 SuppressedCount, std::initializer_list<FZBLogArg> Args)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	int32 Index;
+	if (Num < Capacity)
+	{
+		Index = (Head + Num) % Capacity;
+		++Num;
+	}
+	else
+	{
+		// 缓冲已满：覆盖最旧的一条
+		Index = Head;
+		Head = (Head + 1) % Capacity;
+		++DroppedCount;
+	}
+
+	FEntry& Entry = Entries[Index];
+	Entry.Category = Category.GetCategoryName();
+	Entry.Verbosity = Verbosity;
+	Entry.Format = Format;
+	Entry.SuppressedCount = SuppressedCount;
+	Entry.Args.Reset();
+	Entry.Args.Append(Args.begin(), static_cast<int32>(Args.size()));
+}
+
+void FZBDeferredLog::Flush()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (Num == 0 && DroppedCount == 0) return;
+
+	if (DroppedCount > 0)
+	{
+		GLog->Serialize(*FString::Printf(TEXT("ZB_LOG_HOT 缓冲已满，丢弃 %d 条日志"), DroppedCount), ELogVerbosity::Warning, LogZBeta.GetCategoryName());
+		DroppedCount = 0;
+	}
+
+	FStringFormatOrderedArguments FormatArgs;
+	for (int32 Offset = 0; Offset < Num; ++Offset)
+	{
+		FEntry& Entry = Entries[(Head + Offset) % Capacity];
+
+		FormatArgs.Reset();
+		for (const FZBLogArg& Arg : Entry.Args)
+		{
+			FormatArgs.Add(Arg.ToFormatArg());
+		}
+
+		FString Message = FString::Format(Entry.Format, FormatArgs);
+		if (Entry.SuppressedCount > 0)
+		{
+			Message += FString::Printf(TEXT("（此前限流丢弃 %d 条）"), Entry.SuppressedCount);
+		}
+		GLog->Serialize(*Message, Entry.Verbosity, Entry.Category);
+
+		Entry.Args.Reset();
+	}
+
+	Head = 0;
+	Num = 0;
+}
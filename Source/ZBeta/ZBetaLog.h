@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/TVariant.h"
+#include <atomic>
+#include "ZBeta.h"
+
+struct FGameplayTag;
+
+/**
+ * ZBeta 日志分类
+ *
+ * 功能说明：
+ *   - 按子系统拆分的 LogZBeta* 分类，每个分类都有编译期的最高等级上限；
+ *   - Shipping / Test 构建里热路径分类只保留 Warning 及以上，其他分类保留到 Log，
+ *     超出上限的 UE_LOG / ZB_LOG_HOT 整段被编译掉，不会留下格式化开销。
+ */
+#if UE_BUILD_SHIPPING || UE_BUILD_TEST
+	#define ZB_LOG_COMPILE_VERBOSITY Log
+	#define ZB_LOG_HOT_COMPILE_VERBOSITY Warning
+#else
+	#define ZB_LOG_COMPILE_VERBOSITY All
+	#define ZB_LOG_HOT_COMPILE_VERBOSITY All
+#endif
+
+// 输入分发（每帧触发，热路径）
+DECLARE_LOG_CATEGORY_EXTERN(LogZBetaInput, Log, ZB_LOG_HOT_COMPILE_VERBOSITY);
+// 角色 Tick / 移动状态（每帧触发，热路径）
+DECLARE_LOG_CATEGORY_EXTERN(LogZBetaCharacter, Log, ZB_LOG_HOT_COMPILE_VERBOSITY);
+// 技能 / GE / 属性
+DECLARE_LOG_CATEGORY_EXTERN(LogZBetaAbility, Log, ZB_LOG_HOT_COMPILE_VERBOSITY);
+// 网络 / 复制
+DECLARE_LOG_CATEGORY_EXTERN(LogZBetaNet, Log, ZB_LOG_COMPILE_VERBOSITY);
+// 资源加载 / 启动
+DECLARE_LOG_CATEGORY_EXTERN(LogZBetaAsset, Log, ZB_LOG_COMPILE_VERBOSITY);
+// 压测 / 性能工具
+DECLARE_LOG_CATEGORY_EXTERN(LogZBetaBenchmark, Log, ZB_LOG_COMPILE_VERBOSITY);
+
+
+/**
+ * @brief 延迟格式化的日志参数
+ * @details 只保存原始值（整数 / 浮点 / FName），FGameplayTag 与 UObject 都按 FName 存，
+ *          真正的字符串拼接留到 Flush 时再做。FString 参数会拷贝，热路径上尽量传 FName。
+ */
+struct ZBETA_API FZBLogArg
+{
+	using FValue = TVariant<int64, uint64, double, FName, FString>;
+
+	FZBLogArg(int32 InValue) : Value(TInPlaceType<int64>(), InValue) {}
+	FZBLogArg(int64 InValue) : Value(TInPlaceType<int64>(), InValue) {}
+	FZBLogArg(uint32 InValue) : Value(TInPlaceType<uint64>(), InValue) {}
+	FZBLogArg(uint64 InValue) : Value(TInPlaceType<uint64>(), InValue) {}
+	FZBLogArg(bool bInValue) : Value(TInPlaceType<int64>(), bInValue ? 1 : 0) {}
+	FZBLogArg(float InValue) : Value(TInPlaceType<double>(), InValue) {}
+	FZBLogArg(double InValue) : Value(TInPlaceType<double>(), InValue) {}
+	FZBLogArg(FName InValue) : Value(TInPlaceType<FName>(), InValue) {}
+	FZBLogArg(const FGameplayTag& InValue);
+	FZBLogArg(const UObject* InValue);
+	FZBLogArg(const TCHAR* InValue) : Value(TInPlaceType<FString>(), InValue) {}
+	FZBLogArg(const FString& InValue) : Value(TInPlaceType<FString>(), InValue) {}
+
+	FStringFormatArg ToFormatArg() const;
+
+	FValue Value;
+};
+
+/**
+ * @brief 调用点级别的限流器（函数内 static）
+ * @details 每个调用点每秒最多放行 zb.Log.HotMaxPerSecond 条，被丢弃的条数随下一条放行的日志一起输出。
+ *          计数都是原子的，工作线程与游戏线程可以同时经过同一个调用点；
+ *          窗口切换瞬间的竞争最多多放行几条，不影响正确性。
+ */
+struct ZBETA_API FZBLogRateLimiter
+{
+	bool TryConsume();
+
+	int32 TakeSuppressedCount()
+	{
+		return SuppressedCount.exchange(0, std::memory_order_relaxed);
+	}
+
+private:
+	// 当前窗口起点（毫秒），初值保证第一次调用就开新窗口
+	std::atomic<int64> WindowStartMs { TNumericLimits<int64>::Lowest() / 2 };
+	std::atomic<int32> CountInWindow { 0 };
+	std::atomic<int32> SuppressedCount { 0 };
+};
+
+/**
+ * @brief 延迟格式化日志的环形缓冲
+ *
+ * 功能说明：
+ *   - ZB_LOG_HOT 只把分类、等级、格式串指针和参数压进环形缓冲；
+ *   - 每帧结束（FCoreDelegates::OnEndFrame）统一格式化并写进 GLog；
+ *   - 缓冲满时覆盖最旧的一条，并在下次 Flush 时报告丢弃数量。
+ *
+ * 注意事项：
+ *   - 格式串必须是字面量（只保存指针），使用 FString::Format 的 {0} {1} 占位符；
+ *   - Push / Flush 加锁，允许工作线程写入。
+ */
+class ZBETA_API FZBDeferredLog
+{
+public:
+	static FZBDeferredLog& Get();
+
+	void Push(const FLogCategoryBase& Category, ELogVerbosity::Type Verbosity, const TCHAR* Format, int32 SuppressedCount, std::initializer_list<FZBLogArg> Args);
+
+	// 格式化并输出缓冲中的全部日志
+	void Flush();
+
+private:
+	FZBDeferredLog();
+
+	struct FEntry
+	{
+		FName Category;
+		ELogVerbosity::Type Verbosity = ELogVerbosity::Log;
+		const TCHAR* Format = nullptr;
+		int32 SuppressedCount = 0;
+		TArray<FZBLogArg, TInlineAllocator<4>> Args;
+	};
+
+	static constexpr int32 Capacity = 1024;
+
+	TArray<FEntry> Entries;
+	int32 Head = 0;
+	int32 Num = 0;
+	int32 DroppedCount = 0;
+	FCriticalSection Lock;
+};
+
+/**
+ * @brief 热路径日志：编译期裁剪 + 调用点限流 + 延迟格式化
+ *
+ * 用法：
+ *   ZB_LOG_HOT(LogZBetaInput, Verbose, TEXT("输入按下: {0}"), InputTag);
+ */
+#if NO_LOGGING
+	#define ZB_LOG_HOT(CategoryName, Verbosity, Format, ...) do {} while (0)
+#else
+	#define ZB_LOG_HOT(CategoryName, Verbosity, Format, ...) \
+		do \
+		{ \
+			if constexpr ((ELogVerbosity::Verbosity & ELogVerbosity::VerbosityMask) <= FLogCategory##CategoryName::CompileTimeVerbosity) \
+			{ \
+				if (!CategoryName.IsSuppressed(ELogVerbosity::Verbosity)) \
+				{ \
+					static FZBLogRateLimiter ZBLogRateLimiter; \
+					if (ZBLogRateLimiter.TryConsume()) \
+					{ \
+						FZBDeferredLog::Get().Push(CategoryName, ELogVerbosity::Verbosity, Format, ZBLogRateLimiter.TakeSuppressedCount(), { __VA_ARGS__ }); \
+					} \
+				} \
+			} \
+		} while (0)
+#endif
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ZBetaStats.h"
+
+DEFINE_STAT(STAT_ZBeta_CharacterTick);
+DEFINE_STAT(STAT_ZBeta_AbilityInputPressed);
+DEFINE_STAT(STAT_ZBeta_AbilityInputHeld);
+DEFINE_STAT(STAT_ZBeta_AbilityInputReleased);
+DEFINE_STAT(STAT_ZBeta_ApplyEffectSpecToSelf);
+DEFINE_STAT(STAT_ZBeta_ApplyEffectToSelf);
+DEFINE_STAT(STAT_ZBeta_InitializeDefaultAttributes);
+DEFINE_STAT(STAT_ZBeta_InitializeNativeTags);
+DEFINE_STAT(STAT_ZBeta_AttributeOnRep);
+DEFINE_STAT(STAT_ZBeta_MeleeHitDetection);
+DEFINE_STAT(STAT_ZBeta_LagCompRecord);
+DEFINE_STAT(STAT_ZBeta_LagCompValidate);
+DEFINE_STAT(STAT_ZBeta_DamageExecution);
+DEFINE_STAT(STAT_ZBeta_CombatResolutionFlush);
+DEFINE_STAT(STAT_ZBeta_DotTick);
+DEFINE_STAT(STAT_ZBeta_PoiseDamage);
+DEFINE_STAT(STAT_ZBeta_TargetLockIndex);
+DEFINE_STAT(STAT_ZBeta_TargetLockScore);
+DEFINE_STAT(STAT_ZBeta_InteractionEvaluate);
+DEFINE_STAT(STAT_ZBeta_ProjectileUpdate);
+
+DEFINE_STAT(STAT_ZBeta_EffectApplications);
+DEFINE_STAT(STAT_ZBeta_TagAdds);
+DEFINE_STAT(STAT_ZBeta_TagRemoves);
+DEFINE_STAT(STAT_ZBeta_AbilityActivations);
+DEFINE_STAT(STAT_ZBeta_AttributeOnReps);
+DEFINE_STAT(STAT_ZBeta_MeleeSweeps);
+DEFINE_STAT(STAT_ZBeta_MeleeHits);
+DEFINE_STAT(STAT_ZBeta_LagCompRequests);
+DEFINE_STAT(STAT_ZBeta_CombatReturnsQueued);
+DEFINE_STAT(STAT_ZBeta_CombatReturnsApplied);
+DEFINE_STAT(STAT_ZBeta_DotTicks);
+DEFINE_STAT(STAT_ZBeta_DotDamageApplications);
+DEFINE_STAT(STAT_ZBeta_PoiseBreaks);
+DEFINE_STAT(STAT_ZBeta_PoiseTimerEvents);
+DEFINE_STAT(STAT_ZBeta_TargetLockTraces);
+DEFINE_STAT(STAT_ZBeta_InteractionEvaluations);
+DEFINE_STAT(STAT_ZBeta_ProjectileSweeps);
+DEFINE_STAT(STAT_ZBeta_ProjectileHits);
+
+UE_TRACE_CHANNEL_DEFINE(ZBetaChannel);
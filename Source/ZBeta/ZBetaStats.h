@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * ZBeta 模块的性能统计
+ *
+ * 用法：
+ *   - 控制台 `stat ZBeta` 查看周期计数与每帧计数；
+ *   - Insights：`-trace=cpu,ZBeta` 在所有配置下都能看到 ZBeta 通道上的作用域；
+ *     开启 STATS 的版本（Debug / Development）里周期计数另外在 cpu 通道输出一层同名作用域，只开 `-trace=cpu` 时也能看到。
+ */
+DECLARE_STATS_GROUP(TEXT("ZBeta"), STATGROUP_ZBeta, STATCAT_Advanced);
+
+// ========== 周期统计（耗时） ==========
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Tick"), STAT_ZBeta_CharacterTick, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ability Input Pressed"), STAT_ZBeta_AbilityInputPressed, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ability Input Held"), STAT_ZBeta_AbilityInputHeld, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ability Input Released"), STAT_ZBeta_AbilityInputReleased, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply GE Spec To Self"), STAT_ZBeta_ApplyEffectSpecToSelf, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Effect To Self"), STAT_ZBeta_ApplyEffectToSelf, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Initialize Default Attributes"), STAT_ZBeta_InitializeDefaultAttributes, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Initialize Native Tags"), STAT_ZBeta_InitializeNativeTags, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attribute OnRep"), STAT_ZBeta_AttributeOnRep, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Melee Hit Detection"), STAT_ZBeta_MeleeHitDetection, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Lag Compensation Record"), STAT_ZBeta_LagCompRecord, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Lag Compensation Validate"), STAT_ZBeta_LagCompValidate, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Damage Execution"), STAT_ZBeta_DamageExecution, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Combat Resolution Flush"), STAT_ZBeta_CombatResolutionFlush, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("DOT Tick"), STAT_ZBeta_DotTick, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Poise Damage"), STAT_ZBeta_PoiseDamage, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Target Lock Index"), STAT_ZBeta_TargetLockIndex, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Target Lock Score"), STAT_ZBeta_TargetLockScore, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Interaction Evaluate"), STAT_ZBeta_InteractionEvaluate, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile Update"), STAT_ZBeta_ProjectileUpdate, STATGROUP_ZBeta, ZBETA_API);
+
+// ========== 每帧计数 ==========
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("GE Applications"), STAT_ZBeta_EffectApplications, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tag Adds"), STAT_ZBeta_TagAdds, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tag Removes"), STAT_ZBeta_TagRemoves, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ability Activations"), STAT_ZBeta_AbilityActivations, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Attribute OnReps"), STAT_ZBeta_AttributeOnReps, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Melee Sweeps"), STAT_ZBeta_MeleeSweeps, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Melee Hits"), STAT_ZBeta_MeleeHits, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Lag Compensation Requests"), STAT_ZBeta_LagCompRequests, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Combat Returns Queued"), STAT_ZBeta_CombatReturnsQueued, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Combat Returns Applied"), STAT_ZBeta_CombatReturnsApplied, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("DOT Ticks"), STAT_ZBeta_DotTicks, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("DOT Damage Applications"), STAT_ZBeta_DotDamageApplications, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Poise Breaks"), STAT_ZBeta_PoiseBreaks, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Poise Timer Events"), STAT_ZBeta_PoiseTimerEvents, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Target Lock Traces"), STAT_ZBeta_TargetLockTraces, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Evaluations"), STAT_ZBeta_InteractionEvaluations, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Projectile Sweeps"), STAT_ZBeta_ProjectileSweeps, STATGROUP_ZBeta, ZBETA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Projectile Hits"), STAT_ZBeta_ProjectileHits, STATGROUP_ZBeta, ZBETA_API);
+
+// Insights 通道（-trace=ZBeta）
+UE_TRACE_CHANNEL_EXTERN(ZBetaChannel, ZBETA_API);
+
+// ZBeta 通道上的 Insights 作用域在任何配置下都输出；有 STATS 时再加周期计数（`stat ZBeta`）。
+// 两者同时开启时时间线上是同名的两层嵌套，未开 ZBeta 通道时通道作用域只有一次开关判断的开销
+#if STATS
+#define ZB_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, ZBetaChannel)
+#else
+#define ZB_SCOPE_CYCLE_COUNTER(Stat) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, ZBetaChannel)
+#endif
+
+// GAMEPLAYATTRIBUTE_REPNOTIFY 外包一层统计，所有属性的 OnRep 共用一个周期计数与调用次数
+// （使用处需要包含 AttributeSet.h）
+#define ZB_ATTRIBUTE_REPNOTIFY(ClassName, PropertyName, OldValue) \
+	{ \
+		ZB_SCOPE_CYCLE_COUNTER(STAT_ZBeta_AttributeOnRep); \
+		INC_DWORD_STAT(STAT_ZBeta_AttributeOnReps); \
+		GAMEPLAYATTRIBUTE_REPNOTIFY(ClassName, PropertyName, OldValue); \
+	}